@@ -1,4 +1,20 @@
-glslc shader.vert -o vert.spv
-glslc shader.frag -o frag.spv
-glslc pointlight.vert -o pointlight_vert.spv
-glslc pointlight.frag -o pointlight_frag.spv
\ No newline at end of file
+@rem run from this directory, the pre-build step of MYhelloApp.vcxproj does so on every build
+@rem a failing glslc fails the build, since ikEmbeddedShaders.cpp needs every embedded list
+if defined VULKAN_SDK set "PATH=%VULKAN_SDK%\Bin;%PATH%"
+glslc shader.vert -o vert.spv || exit /b 1
+glslc shader.frag -o frag.spv || exit /b 1
+glslc pointlight.vert -o pointlight_vert.spv || exit /b 1
+glslc pointlight.frag -o pointlight_frag.spv || exit /b 1
+glslc depth.vert -o depth_vert.spv || exit /b 1
+glslc gbuffer.frag -o gbuffer_frag.spv || exit /b 1
+glslc deferred.vert -o deferred_vert.spv || exit /b 1
+glslc deferred.frag -o deferred_frag.spv || exit /b 1
+if not exist embedded mkdir embedded
+glslc shader.vert -mfmt=num -o embedded/vert.inc || exit /b 1
+glslc shader.frag -mfmt=num -o embedded/frag.inc || exit /b 1
+glslc pointlight.vert -mfmt=num -o embedded/pointlight_vert.inc || exit /b 1
+glslc pointlight.frag -mfmt=num -o embedded/pointlight_frag.inc || exit /b 1
+glslc depth.vert -mfmt=num -o embedded/depth_vert.inc || exit /b 1
+glslc gbuffer.frag -mfmt=num -o embedded/gbuffer_frag.inc || exit /b 1
+glslc deferred.vert -mfmt=num -o embedded/deferred_vert.inc || exit /b 1
+glslc deferred.frag -mfmt=num -o embedded/deferred_frag.inc || exit /b 1
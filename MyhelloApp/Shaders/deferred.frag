@@ -0,0 +1,100 @@
+#version 450
+
+// lighting subpass of the deferred path, every pixel reads its own G-buffer texel and is lit once
+
+layout (input_attachment_index = 0, set = 1, binding = 0) uniform subpassInput gBufferAlbedo;
+layout (input_attachment_index = 1, set = 1, binding = 1) uniform subpassInput gBufferNormal;
+layout (input_attachment_index = 2, set = 1, binding = 2) uniform subpassInput gBufferDepth;
+
+layout (location = 0 ) out vec4 outColor;
+
+
+struct PointLight{
+    vec4 position;
+    vec4 color;
+ 
+ };
+
+layout(set = 0, binding = 0) uniform GlobalUbo{
+    mat4 projection;
+    mat4 view;
+    vec4 ambientLightColor; // w is intensity
+    vec4 clusterDepth; // x near, y far, z slice scale, w slice bias
+    uvec4 clusterGrid; // xyz clusters per axis
+    vec2 screenSize;
+
+}ubo;
+
+layout(set = 0, binding = 1) readonly buffer PointLightBuffer{
+    PointLight lights[];
+}lightBuffer;
+
+// offset into lightIndices and number of lights for every cluster, x fastest then y then depth slice
+struct LightCluster{
+    uint offset;
+    uint count;
+};
+
+layout(set = 0, binding = 2) readonly buffer LightClusterBuffer{
+    LightCluster clusters[];
+}clusterBuffer;
+
+layout(set = 0, binding = 3) readonly buffer LightIndexBuffer{
+    uint lightIndices[];
+}lightIndexBuffer;
+
+// must match IkLightClusterSystem::LIGHT_CUTOFF, lights are only binned into clusters within this range
+const float LIGHT_CUTOFF = 0.001;
+
+// most lights of a cluster this pipeline variant shades, IkLightClusterSystem::LIGHT_LOOP_LIMITS lists the variants.
+// 0 drops the cluster lookup entirely and a small limit lets the compiler unroll the loop
+layout(constant_id = 0) const uint LIGHT_LOOP_LIMIT = 0xffffffffu;
+
+void main(){
+    float depth = subpassLoad(gBufferDepth).r;
+    if(depth >= 1.0){
+        discard;  // nothing was drawn here, keep the clear color
+    }
+
+    // view space position from the perspective projection of IkCamera::setPerspectiveProjection
+    vec2 ndc = gl_FragCoord.xy / ubo.screenSize * 2.0 - 1.0;
+    float viewDepth = ubo.projection[3][2] / (depth - ubo.projection[2][2]);
+    vec3 positionView = vec3(
+        ndc.x * viewDepth / ubo.projection[0][0],
+        ndc.y * viewDepth / ubo.projection[1][1],
+        viewDepth);
+
+    // the view matrix is a rotation plus a translation, so its inverse is the transposed rotation
+    mat3 viewRotation = mat3(ubo.view);
+    vec3 fragPosWorld = transpose(viewRotation) * (positionView - ubo.view[3].xyz);
+
+    vec3 fragColor = subpassLoad(gBufferAlbedo).rgb;
+    vec3 surfaceNormal = normalize(subpassLoad(gBufferNormal).xyz);
+    vec3 diffuseLight = ubo.ambientLightColor.xyz * ubo.ambientLightColor.w;
+
+    if(LIGHT_LOOP_LIMIT > 0){
+        // screen tile in xy, logarithmic depth slice in z, the same binning as IkLightClusterSystem
+        uvec3 cluster = uvec3(
+            uvec2(gl_FragCoord.xy / ubo.screenSize * vec2(ubo.clusterGrid.xy)),
+            uint(max(log(viewDepth) * ubo.clusterDepth.z + ubo.clusterDepth.w, 0.0)));
+        cluster = min(cluster, ubo.clusterGrid.xyz - uvec3(1));
+        LightCluster lightCluster = clusterBuffer.clusters[
+            cluster.x + ubo.clusterGrid.x * (cluster.y + ubo.clusterGrid.y * cluster.z)];
+
+        for(uint i = 0; i < LIGHT_LOOP_LIMIT && i < lightCluster.count; i++){
+            PointLight light = lightBuffer.lights[lightIndexBuffer.lightIndices[lightCluster.offset + i]];
+            vec3 directionToLight = light.position.xyz - fragPosWorld;
+            float distanceSquared = dot(directionToLight, directionToLight);
+            if(distanceSquared * LIGHT_CUTOFF > light.color.w){
+                continue;
+            }
+            float attenuation = 1.0 / distanceSquared;  //distance square
+            float cosAngIncidence = max(dot(surfaceNormal, normalize(directionToLight)), 0);
+            vec3 intensity = light.color.xyz * light.color.w * attenuation;
+
+            diffuseLight += intensity * cosAngIncidence;
+        }
+    }
+
+    outColor = vec4(diffuseLight * fragColor, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#version 450
+
+//depth pre-pass, reads the tightly packed position stream only
+
+layout(location = 0) in vec3 position;
+
+layout(set = 0, binding = 0) uniform GlobalUbo{
+    mat4 projection;
+    mat4 view;
+}ubo;
+
+layout(push_constant) uniform Push{
+    mat4 modelMatrix;
+    mat4 normalMatrix;
+    }push;
+
+//the main pass tests with EQUAL, so gl_Position must be computed bit for bit the same way as in shader.vert
+invariant gl_Position;
+
+void main() {
+    vec4 positionWorld = push.modelMatrix * vec4(position, 1.0);
+    gl_Position = ubo.projection * ubo.view * positionWorld;
+}
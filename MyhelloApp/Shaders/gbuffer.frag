@@ -0,0 +1,52 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+// geometry subpass of the deferred path, lighting happens later in deferred.frag
+
+layout (location = 0) in vec3 fragColor;
+layout (location = 1) in vec3 fragPosWorld;
+layout (location = 2) in vec3 fragNormalWorld;
+layout (location = 3) flat in uint fragMaterialId;
+layout (location = 4) in vec2 fragUv;
+
+layout (location = 0) out vec4 outAlbedo;
+layout (location = 1) out vec4 outNormal;
+
+layout(set = 0, binding = 0) uniform GlobalUbo{
+    mat4 projection;
+    mat4 view;
+    vec4 ambientLightColor; // w is intensity
+    vec4 clusterDepth; // x near, y far, z slice scale, w slice bias
+    uvec4 clusterGrid; // xyz clusters per axis
+    vec2 screenSize;
+    uvec4 resourceIndices; // x material buffer in the bindless table
+}ubo;
+
+// bindless table (IkBindlessTable), buffers and textures indexed by id
+struct Material{
+    vec4 baseColor; // multiplies the vertex color
+    uvec4 textures; // x base color texture, INVALID_INDEX without one
+};
+
+const uint INVALID_INDEX = 0xffffffffu;
+
+layout(set = 1, binding = 0) readonly buffer MaterialBuffer{
+    Material materials[];
+}bindlessBuffers[];
+
+layout(set = 1, binding = 1) uniform sampler2D bindlessTextures[];
+
+vec3 materialColor(){
+    // the material buffer is the same for every draw, the material id and so the texture may differ per fragment
+    Material material = bindlessBuffers[ubo.resourceIndices.x].materials[fragMaterialId];
+    vec3 color = material.baseColor.rgb;
+    if(material.textures.x != INVALID_INDEX){
+        color *= texture(bindlessTextures[nonuniformEXT(material.textures.x)], fragUv).rgb;
+    }
+    return color;
+}
+
+void main(){
+    outAlbedo = vec4(fragColor * materialColor(), 1.0);
+    outNormal = vec4(normalize(fragNormalWorld), 0.0);
+}
\ No newline at end of file
@@ -1,37 +1,15 @@
 #version 450
 
 layout (location = 0) in vec2 fragOffset;
+layout (location = 1) in vec3 fragColor;
 layout (location = 0) out vec4 outColor;
 
 
-struct PointLight{
-    vec4 position;
-    vec4 color;
- 
- };
-
-layout(set = 0, binding = 0) uniform GlobalUbo{
-    mat4 projection;
-    mat4 view;
-    vec4 ambientLightColor; // w is intensity
-    PointLight pointLights[10];
-    int numLights;
-
-}ubo;
-
-layout(push_constant) uniform Push{
-    vec4 position;
-    vec4 color;
-    float radius;
-
-
-}push;
-
 void main(){
    float dis = sqrt(dot(fragOffset, fragOffset));
    if(dis >= 1.0){
       discard;
       }
-   outColor = vec4(push.color.xyz, 1.0);
+   outColor = vec4(fragColor, 1.0);
 
 }
@@ -11,6 +11,7 @@ const vec2 OFFSETS[6] = vec2[](
 );
 
 layout (location = 0) out vec2 fragOffset;
+layout (location = 1) out vec3 fragColor;
 
 struct PointLight{
     vec4 position;
@@ -22,28 +23,28 @@ layout(set = 0, binding = 0) uniform GlobalUbo{
     mat4 projection;
     mat4 view;
     vec4 ambientLightColor; // w is intensity
-    PointLight pointLights[10];
-    int numLights;
+    vec4 clusterDepth; // x near, y far, z slice scale, w slice bias
+    uvec4 clusterGrid; // xyz clusters per axis
+    vec2 screenSize;
 
 }ubo;
 
-layout(push_constant) uniform Push{
-    vec4 position;
-    vec4 color;
-    float radius;
-
-
-}push;
+// one entry per light, w of position is the billboard radius
+layout(set = 0, binding = 1) readonly buffer PointLightBuffer{
+    PointLight lights[];
+}lightBuffer;
 
 
 void main(){
+    PointLight light = lightBuffer.lights[gl_InstanceIndex];
     fragOffset = OFFSETS[gl_VertexIndex];
+    fragColor = light.color.xyz;
     vec3 cameraRightWorld = {ubo.view[0][0], ubo.view[1][0], ubo.view[2][0]};
     vec3 cameraUpWorld = {ubo.view[0][1], ubo.view[1][1], ubo.view[2][1]};
 
-    vec3 positionWorld = push.position.xyz
-       + push.radius * fragOffset.x * cameraRightWorld
-       + push.radius * fragOffset.y * cameraUpWorld;
+    vec3 positionWorld = light.position.xyz
+       + light.position.w * fragOffset.x * cameraRightWorld
+       + light.position.w * fragOffset.y * cameraUpWorld;
 
        gl_Position = ubo.projection * ubo.view * vec4(positionWorld, 1.0);
     }
\ No newline at end of file
@@ -1,10 +1,13 @@
 
 
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
 layout (location = 0) in vec3 fragColor;
 layout (location = 1) in vec3 fragPosWorld;
 layout (location = 2) in vec3 fragNormalWorld;
+layout (location = 3) flat in uint fragMaterialId;
+layout (location = 4) in vec2 fragUv;
 
 
 layout (location = 0 ) out vec4 outColor;
@@ -20,11 +23,62 @@ layout(set = 0, binding = 0) uniform GlobalUbo{
     mat4 projection;
     mat4 view;
     vec4 ambientLightColor; // w is intensity
-    PointLight pointLights[10];
-    int numLights;
+    vec4 clusterDepth; // x near, y far, z slice scale, w slice bias
+    uvec4 clusterGrid; // xyz clusters per axis
+    vec2 screenSize;
+    uvec4 resourceIndices; // x material buffer in the bindless table
 
 }ubo;
 
+// bindless table (IkBindlessTable), buffers and textures indexed by id
+struct Material{
+    vec4 baseColor; // multiplies the vertex color
+    uvec4 textures; // x base color texture, INVALID_INDEX without one
+};
+
+const uint INVALID_INDEX = 0xffffffffu;
+
+layout(set = 1, binding = 0) readonly buffer MaterialBuffer{
+    Material materials[];
+}bindlessBuffers[];
+
+layout(set = 1, binding = 1) uniform sampler2D bindlessTextures[];
+
+vec3 materialColor(){
+    // the material buffer is the same for every draw, the material id and so the texture may differ per fragment
+    Material material = bindlessBuffers[ubo.resourceIndices.x].materials[fragMaterialId];
+    vec3 color = material.baseColor.rgb;
+    if(material.textures.x != INVALID_INDEX){
+        color *= texture(bindlessTextures[nonuniformEXT(material.textures.x)], fragUv).rgb;
+    }
+    return color;
+}
+
+layout(set = 0, binding = 1) readonly buffer PointLightBuffer{
+    PointLight lights[];
+}lightBuffer;
+
+// offset into lightIndices and number of lights for every cluster, x fastest then y then depth slice
+struct LightCluster{
+    uint offset;
+    uint count;
+};
+
+layout(set = 0, binding = 2) readonly buffer LightClusterBuffer{
+    LightCluster clusters[];
+}clusterBuffer;
+
+layout(set = 0, binding = 3) readonly buffer LightIndexBuffer{
+    uint lightIndices[];
+}lightIndexBuffer;
+
+// must match IkLightClusterSystem::LIGHT_CUTOFF, lights are only binned into clusters within this range
+const float LIGHT_CUTOFF = 0.001;
+
+// most lights of a cluster this pipeline variant shades, IkLightClusterSystem::LIGHT_LOOP_LIMITS lists the variants.
+// 0 drops the cluster lookup entirely and a small limit lets the compiler unroll the loop
+layout(constant_id = 0) const uint LIGHT_LOOP_LIMIT = 0xffffffffu;
+
 layout(push_constant) uniform Push{
     mat4 modelMatrix;
     mat4 normalMatrix;
@@ -36,17 +90,32 @@ void main(){
     vec3 diffuseLight = ubo.ambientLightColor.xyz * ubo.ambientLightColor.w;
     vec3 surfaceNormal = normalize(fragNormalWorld);
 
-    for(int i = 0; i < ubo.numLights;i++){
-        PointLight light = ubo.pointLights[i];
-        vec3 directionToLight = light.position.xyz - fragPosWorld;
-        float attenuation = 1.0 / dot(directionToLight, directionToLight);  //distance square
-        float cosAngIncidence = max(dot(surfaceNormal, normalize(directionToLight)), 0);
-        vec3 intensity = light.color.xyz * light.color.w * attenuation;
-
-        diffuseLight += intensity * cosAngIncidence;
+    if(LIGHT_LOOP_LIMIT > 0){
+        // screen tile in xy, logarithmic depth slice in z, the same binning as IkLightClusterSystem
+        float viewDepth = (ubo.view * vec4(fragPosWorld, 1.0)).z;
+        uvec3 cluster = uvec3(
+            uvec2(gl_FragCoord.xy / ubo.screenSize * vec2(ubo.clusterGrid.xy)),
+            uint(max(log(viewDepth) * ubo.clusterDepth.z + ubo.clusterDepth.w, 0.0)));
+        cluster = min(cluster, ubo.clusterGrid.xyz - uvec3(1));
+        LightCluster lightCluster = clusterBuffer.clusters[
+            cluster.x + ubo.clusterGrid.x * (cluster.y + ubo.clusterGrid.y * cluster.z)];
+
+        for(uint i = 0; i < LIGHT_LOOP_LIMIT && i < lightCluster.count; i++){
+            PointLight light = lightBuffer.lights[lightIndexBuffer.lightIndices[lightCluster.offset + i]];
+            vec3 directionToLight = light.position.xyz - fragPosWorld;
+            float distanceSquared = dot(directionToLight, directionToLight);
+            if(distanceSquared * LIGHT_CUTOFF > light.color.w){
+                continue;
+            }
+            float attenuation = 1.0 / distanceSquared;  //distance square
+            float cosAngIncidence = max(dot(surfaceNormal, normalize(directionToLight)), 0);
+            vec3 intensity = light.color.xyz * light.color.w * attenuation;
+
+            diffuseLight += intensity * cosAngIncidence;
+        }
     }
 
-     outColor = vec4(diffuseLight * fragColor, 1.0);
+     outColor = vec4(diffuseLight * fragColor * materialColor(), 1.0);
 
 }
 
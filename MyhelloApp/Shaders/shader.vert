@@ -9,21 +9,18 @@ layout(location = 3) in vec2 uv;
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec3 fragPosWorld;
 layout(location = 2) out vec3 fragNormalWorld;
+layout(location = 3) flat out uint fragMaterialId;
+layout(location = 4) out vec2 fragUv;
 
 
 
-struct PointLight{
-    vec4 position;
-    vec4 color;
- 
- };
-
 layout(set = 0, binding = 0) uniform GlobalUbo{
     mat4 projection;
     mat4 view;
     vec4 ambientLightColor; // w is intensity
-    PointLight pointLights[10];
-    int numLights;
+    vec4 clusterDepth; // x near, y far, z slice scale, w slice bias
+    uvec4 clusterGrid; // xyz clusters per axis
+    vec2 screenSize;
 
 }ubo;
 
@@ -32,7 +29,8 @@ layout(push_constant) uniform Push{
     mat4 normalMatrix;
     }push;
 
-
+//must match depth.vert exactly for the EQUAL depth test after the pre-pass
+invariant gl_Position;
 
 void main() {
     vec4 positionWorld = push.modelMatrix * vec4(position, 1.0);
@@ -41,5 +39,8 @@ void main() {
     fragNormalWorld = normalize(mat3(push.normalMatrix) * normal);
     fragPosWorld = positionWorld.xyz;
     fragColor = color;
+    // IkRenderSystem draws every object with its material id as firstInstance
+    fragMaterialId = gl_InstanceIndex;
+    fragUv = uv;
 
 }
\ No newline at end of file
@@ -2,7 +2,12 @@
 #include "KeyBoardMovementController.hpp"
 #include "ikBuffer.hpp"
 #include "ikCamera.hpp"
+#include "ikCpuProfiler.hpp"
+#include "ikImageWriter.hpp"
+#include "ikPipelineCompiler.hpp"
+#include "systems/ikDeferredLightingSystem.hpp"
 #include "systems/ikRenderSystem.hpp"
+#include "systems/ikLightClusterSystem.hpp"
 #include "systems/ikPointLightSystem.hpp"
 
 //libs
@@ -15,19 +20,99 @@
 
 #include <array>
 #include <chrono>
+#include <functional>
 #include <stdexcept>
 #include <cassert>
+#include <iomanip>
+#include <iostream>
 #include <numeric>
+#include <unordered_map>
 
 namespace ikE {
 
+	namespace {
+		//drives runRecordingBenchmark, each thread count renders WARMUP_FRAMES that are thrown away
+		//followed by MEASURED_FRAMES whose recording time is averaged and printed
+		class RecordingBenchmark {
+		public:
+			static constexpr int WARMUP_FRAMES = 60;
+			static constexpr int MEASURED_FRAMES = 300;
+
+			uint32_t threadCount() const { return THREAD_COUNTS[stage]; }
+			bool finished() const { return stage == THREAD_COUNTS.size(); }
+
+			//returns true when the benchmark moved on to the next thread count
+			bool addFrame(double recordMs) {
+				frame += 1;
+				if (frame <= WARMUP_FRAMES) return false;
+				totalRecordMs += recordMs;
+				if (frame < WARMUP_FRAMES + MEASURED_FRAMES) return false;
+
+				double averageMs = totalRecordMs / MEASURED_FRAMES;
+				if (stage == 0) singleThreadMs = averageMs;
+				std::cout << "recording threads: " << threadCount()
+					<< "  avg record time: " << averageMs << " ms"
+					<< "  speedup: " << singleThreadMs / averageMs << "x" << std::endl;
+
+				stage += 1;
+				frame = 0;
+				totalRecordMs = 0.0;
+				return true;
+			}
 
-	FirstApp::FirstApp() { 
-		globalPool =
-			IkDescriptorPool::Builder(ikeDeviceEngine)
-			.setMaxSets(ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT)
-			.addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT)
-			.build();
+		private:
+			static constexpr std::array<uint32_t, 4> THREAD_COUNTS{ 1, 2, 4, 8 };
+
+			size_t stage = 0;
+			int frame = 0;
+			double totalRecordMs = 0.0;
+			double singleThreadMs = 0.0;
+		};
+
+		//drives runLightingBenchmark, the same warmup and measuring scheme as RecordingBenchmark
+		//but stepping through light counts and averaging the whole frame time
+		class LightingBenchmark {
+		public:
+			static constexpr int WARMUP_FRAMES = 60;
+			static constexpr int MEASURED_FRAMES = 300;
+			//fixed per light, so more lights means more lights per pixel until MAX_LIGHTS_PER_CLUSTER is reached
+			static constexpr float LIGHT_INTENSITY = .05f;
+
+			explicit LightingBenchmark(const char* pathName) : pathName{ pathName } {}
+
+			int lightCount() const { return LIGHT_COUNTS[stage]; }
+			bool finished() const { return stage == LIGHT_COUNTS.size(); }
+
+			//returns true when the benchmark moved on to the next light count
+			bool addFrame(double frameMs) {
+				frame += 1;
+				if (frame <= WARMUP_FRAMES) return false;
+				totalFrameMs += frameMs;
+				if (frame < WARMUP_FRAMES + MEASURED_FRAMES) return false;
+
+				std::cout << pathName << " lights: " << lightCount()
+					<< "  avg frame time: " << totalFrameMs / MEASURED_FRAMES << " ms" << std::endl;
+
+				stage += 1;
+				frame = 0;
+				totalFrameMs = 0.0;
+				return true;
+			}
+
+		private:
+			static constexpr std::array<int, 5> LIGHT_COUNTS{ 16, 256, 1024, 4096, 10000 };
+
+			const char* pathName;
+			size_t stage = 0;
+			int frame = 0;
+			double totalFrameMs = 0.0;
+		};
+	}
+
+
+	FirstApp::FirstApp(const AppSettings& settings) : settings{ settings } { 
+		threadPool = std::make_unique<IkThreadPool>(
+			std::min(IkThreadPool::defaultThreadCount(), IkeRenderer::MAX_RECORDING_THREADS));
 		loadGameObjects(); 
 	}
 
@@ -47,44 +132,193 @@ namespace ikE {
 			uboBuffers[i]->map();
 		}
 
+		//rewritten every frame with the texture indices of the textures ready by then, so one buffer per frame in flight
+		IkBindlessTable& bindlessTable = IkRenderer.getBindlessTable();
+		std::vector<std::unique_ptr<IkBuffer>> materialBuffers(ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT);
+		std::vector<uint32_t> materialBufferIndices(ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT);
+		for (int i = 0; i < materialBuffers.size(); i++) {
+			materialBuffers[i] = std::make_unique<IkBuffer>(
+				ikeDeviceEngine,
+				sizeof(Material),
+				static_cast<uint32_t>(materials.size()),
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+			materialBuffers[i]->map();
+			materialBufferIndices[i] = bindlessTable.addStorageBuffer(materialBuffers[i]->descriptorInfo());
+		}
+
 
 		auto globalSetLayout = IkDescriptorSetLayout::Builder(ikeDeviceEngine)
 			.addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
+			.addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
+			.addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT)
+			.addBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT)
+			.useUpdateTemplate()
 			.build();
 
-		std::vector<VkDescriptorSet> globalDescriptorSets(ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT);
-		for (int i = 0; i < globalDescriptorSets.size(); i++) {
-			auto bufferInfo = uboBuffers[i]->descriptorInfo();
-			IkDescriptorWriter(*globalSetLayout, *globalPool)
-				.writeBuffer(0, &bufferInfo)
-				.build(globalDescriptorSets[i]);
+		//forward shades in the pass that draws the geometry, deferred writes a G-buffer that a second pass lights.
+		//the graph merges the deferred passes into two subpasses of one render pass, so the G-buffer stays on chip
+		IkRenderGraph& renderGraph = IkRenderer.getRenderGraph();
+		IkRenderGraph::ResourceId backbuffer = IkRenderer.getBackbuffer();
+		IkRenderGraph::ResourceId depth = renderGraph.createImage("depth", IkRenderer.getDepthFormat());
+		VkClearColorValue clearColor{ { 0.01f,0.01f,0.01f,1.0f } };
+		VkClearDepthStencilValue clearDepth{ 1.0f, 0 };
+
+		GBufferResources gBuffer{};
+		IkRenderGraph::PassId geometryPass;
+		IkRenderGraph::PassId lightPass;
+		if (settings.deferred) {
+			gBuffer.albedo = renderGraph.createImage("albedo", VK_FORMAT_R8G8B8A8_UNORM);
+			gBuffer.normal = renderGraph.createImage("normal", VK_FORMAT_R16G16B16A16_SFLOAT);
+			gBuffer.depth = depth;
+			geometryPass = renderGraph.addPass("geometry")
+				.writeColor(gBuffer.albedo, VkClearColorValue{})
+				.writeColor(gBuffer.normal, VkClearColorValue{})
+				.writeDepth(depth, clearDepth)
+				.id();
+			//depth stays bound read only so the light billboards are still depth tested
+			lightPass = renderGraph.addPass("lighting")
+				.readInput(gBuffer.albedo)
+				.readInput(gBuffer.normal)
+				.readInput(depth)
+				.readDepth(depth)
+				.writeColor(backbuffer, clearColor)
+				.id();
 		}
-
+		else {
+			geometryPass = renderGraph.addPass("forward")
+				.writeColor(backbuffer, clearColor)
+				.writeDepth(depth, clearDepth)
+				.id();
+			lightPass = geometryPass;
+		}
+		IkRenderer.compileRenderGraph();
+		std::cout << "render graph: " << renderGraph.getRenderPassCount() << " render pass(es), "
+			<< renderGraph.getTransientMemorySize() / 1024 << " KB of attachments per frame in flight, "
+			<< renderGraph.getAliasedMemorySize() / 1024 << " KB saved by aliasing" << std::endl;
+
+		//the system constructors only queue their pipelines, they compile on the workers while the rest is set up
+		//launch twice to compare a cold and a warm pipeline cache
+		auto pipelineStart = std::chrono::high_resolution_clock::now();
+		IkPipelineCompiler pipelineCompiler{ ikeDeviceEngine };
 		IkRenderSystem ikeRenderSystem{ 
 			ikeDeviceEngine,
-			IkRenderer.getSwapChainRenderPass(),
-			globalSetLayout->getDescriptorSetLayout()};
+			pipelineCompiler,
+			renderGraph.getRenderPass(geometryPass),
+			globalSetLayout->getDescriptorSetLayout(),
+			bindlessTable,
+			settings.depthPrepass,
+			settings.deferred };
 
 		IkPointLightSystem pointlightSystem{
 			ikeDeviceEngine,
-			IkRenderer.getSwapChainRenderPass(),
-			globalSetLayout->getDescriptorSetLayout() };
+			pipelineCompiler,
+			renderGraph.getRenderPass(lightPass),
+			globalSetLayout->getDescriptorSetLayout(),
+			renderGraph.getSubpass(lightPass) };
+
+		//only the deferred graph has a lighting pass to fill
+		std::unique_ptr<IkDeferredLightingSystem> deferredLightingSystem{};
+		if (settings.deferred) {
+			deferredLightingSystem = std::make_unique<IkDeferredLightingSystem>(
+				ikeDeviceEngine,
+				pipelineCompiler,
+				IkRenderer,
+				globalSetLayout->getDescriptorSetLayout(),
+				lightPass,
+				gBuffer);
+		}
+
+		if (deferredLightingSystem) {
+			renderGraph.setExecute(geometryPass, [&](FrameInfo& frameInfo) {
+				ikeRenderSystem.renderGameObjects(frameInfo);
+			});
+			renderGraph.setExecute(lightPass, [&](FrameInfo& frameInfo) {
+				deferredLightingSystem->render(frameInfo);
+				pointlightSystem.render(frameInfo);
+			});
+		}
+		else {
+			renderGraph.setExecute(geometryPass, [&](FrameInfo& frameInfo) {
+				ikeRenderSystem.renderGameObjects(frameInfo);
+				pointlightSystem.render(frameInfo);
+			});
+		}
+		IkLightClusterSystem lightClusterSystem{ ikeDeviceEngine };
+
+		//the light storage buffers are owned by the point light system, so the sets are written after it exists.
+		//they come from the descriptor set cache, looking a set up again with unchanged buffers returns the same set
+		std::vector<VkDescriptorSet> globalDescriptorSets(ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT);
+		std::vector<VkBuffer> globalLightBuffers(ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT);
+		auto writeGlobalDescriptorSet = [&](int frameIndex) {
+			auto bufferInfo = uboBuffers[frameIndex]->descriptorInfo();
+			auto lightBufferInfo = pointlightSystem.getLightBufferInfo(frameIndex);
+			auto clusterBufferInfo = lightClusterSystem.getClusterBufferInfo(frameIndex);
+			auto lightIndexBufferInfo = lightClusterSystem.getLightIndexBufferInfo(frameIndex);
+			IkDescriptorWriter(*globalSetLayout, IkRenderer.getDescriptorPoolManager())
+				.writeBuffer(0, &bufferInfo)
+				.writeBuffer(1, &lightBufferInfo)
+				.writeBuffer(2, &clusterBufferInfo)
+				.writeBuffer(3, &lightIndexBufferInfo)
+				.buildCached(globalDescriptorSets[frameIndex]);
+			globalLightBuffers[frameIndex] = lightBufferInfo.buffer;
+		};
+		for (int i = 0; i < globalDescriptorSets.size(); i++) {
+			writeGlobalDescriptorSet(i);
+		}
 
         IkCamera camera{};
 
 
         camera.setViewTarget(glm::vec3(-1.f, -2.f, 2.f), glm::vec3(0.f, 0.f, 2.5f));
 
-        auto viewerObject = IkgameObject::createGameObject();
+        //the camera is not part of the scene, no system draws or lights it
+        TransformComponent viewerTransform{};
 
-		viewerObject.transform.translation.z = -2.5f;
+		viewerTransform.translation.z = -2.5f;
 
         keyBoardMovementController cameraController{};
 
+        RecordingBenchmark recordingBenchmark{};
+        if (benchmarkRecording) {
+            threadPool = std::make_unique<IkThreadPool>(recordingBenchmark.threadCount());
+        }
+        LightingBenchmark lightingBenchmark{ settings.deferred ? "deferred" : "forward" };
+        if (benchmarkLighting) {
+            spawnPointLights(lightingBenchmark.lightCount(), LightingBenchmark::LIGHT_INTENSITY);
+        }
+
+        //nothing closes a headless run, so without a frame limit it renders a single frame unless a benchmark drives it
+        int frameLimit = settings.maxFrames;
+        if (settings.headless && frameLimit == 0 && !benchmarkRecording && !benchmarkLighting) {
+            frameLimit = 1;
+        }
+        int frameCount = 0;
+
+        //only for the startup report, the systems would otherwise wait on their own pipelines in the first frame
+        pipelineCompiler.waitAll();
+        std::cout << "pipelines ready after "
+            << std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - pipelineStart).count()
+            << " ms with a " << (ikeDeviceEngine.isPipelineCacheWarm() ? "warm" : "cold") << " pipeline cache" << std::endl;
+        //a windowed run streams textures in and draws a broken one untextured, a headless one may capture its very first
+        //frame, so there and in the benchmarks a texture that fails to load ends the run
+        textureManager.setDecodeErrorsFatal(settings.headless || benchmarkRecording || benchmarkLighting);
+        if (settings.headless) {
+            textureManager.waitAll();
+        }
+
         auto currentTime = std::chrono::high_resolution_clock::now();
 
 		while (!ikeWindow.shouldClose()) {
-			glfwPollEvents();
+			IK_PROFILE_ZONE("frame");
+			//wait for the GPU (and the display or frame limiter) first, so the input below is as fresh as it can be
+			IkRenderer.waitForNextFrame();
+			if (!settings.headless) {
+				IK_PROFILE_ZONE("glfwPollEvents");
+				glfwPollEvents();
+			}
+			IkRenderer.markInputSampled();
+			textureManager.update();
 
 
             auto newTime = std::chrono::high_resolution_clock::now();
@@ -93,8 +327,10 @@ namespace ikE {
             //THIS needs explanation
             //frameTime = glm::min(frameTime, MAX_FRAME_TIME);
 
-            cameraController.moveInPlaneXZ(ikeWindow.getGLFWwindow(), frameTime, viewerObject);
-            camera.setViewYXZ(viewerObject.transform.translation, viewerObject.transform.rotation);
+            if (!settings.headless) {
+                cameraController.moveInPlaneXZ(ikeWindow.getGLFWwindow(), frameTime, viewerTransform);
+            }
+            camera.setViewYXZ(viewerTransform.translation, viewerTransform.rotation);
 
 
             float aspect = IkRenderer.getAspectRatio();
@@ -110,57 +346,449 @@ namespace ikE {
 					commandBuffer,
 					camera,
 					globalDescriptorSets[frameIndex],
-					gameObjects
+					entities,
+					IkRenderer,
+					*threadPool
 				};
 				//update
 				GlobalUbo ubo{};
 				ubo.projection = camera.getProjection();
 				ubo.view = camera.getView();
-				pointlightSystem.update(frameInfo, ubo);
-				uboBuffers[frameIndex]->writeToBuffer(&ubo);
-				uboBuffers[frameIndex]->flush();
+				ubo.resourceIndices.x = materialBufferIndices[frameIndex];
+				{
+					IK_PROFILE_ZONE("IkPointLightSystem::update");
+					pointlightSystem.update(frameInfo);
+				}
+				{
+					IK_PROFILE_ZONE("IkLightClusterSystem::update");
+					lightClusterSystem.update(frameInfo, ubo, pointlightSystem.getLights(), IkRenderer.getSwapChainExtent());
+				}
+				frameInfo.lightLoopLimit = lightClusterSystem.getLightLoopLimit();
+				if (pointlightSystem.getLightBufferInfo(frameIndex).buffer != globalLightBuffers[frameIndex]) {
+					//the old light buffer is destroyed, so its handle may come back and must not find the old set.
+					//the cached sets stay alive for the frames in flight, every frame then looks up a fresh set,
+					//and a new handle is what tells the render system its static cache is stale
+					IkRenderer.getDescriptorPoolManager().clearCache();
+				}
+				writeGlobalDescriptorSet(frameIndex);
+				frameInfo.globalDescriptorSet = globalDescriptorSets[frameIndex];
+				{
+					IK_PROFILE_ZONE("ubo write + flush");
+					uboBuffers[frameIndex]->writeToBuffer(&ubo);
+					uboBuffers[frameIndex]->flush();
+					for (size_t i = 0; i < materials.size(); i++) {
+						if (materialTextures[i]) materials[i].textures.x = materialTextures[i]->getBindlessIndex();
+					}
+					materialBuffers[frameIndex]->writeToBuffer(materials.data());
+					materialBuffers[frameIndex]->flush();
+				}
 
 				//render
-				IkRenderer.beginSwapChainRenderPass(commandBuffer);
-				ikeRenderSystem.renderGameObjects(frameInfo);
-				pointlightSystem.render(frameInfo);
-				IkRenderer.endSwapChainRenderPass(commandBuffer);
+				auto recordStart = std::chrono::high_resolution_clock::now();
+				{
+					IK_PROFILE_ZONE("record render graph");
+					IkRenderer.executeRenderGraph(frameInfo);
+				}
+				double recordMs = std::chrono::duration<double, std::milli>(
+					std::chrono::high_resolution_clock::now() - recordStart).count();
 				IkRenderer.endFrame();
+				frameCount += 1;
+
+				if (benchmarkRecording && recordingBenchmark.addFrame(recordMs)) {
+					if (recordingBenchmark.finished()) break;
+					//every task has been waited on inside the systems, so the pool can be swapped between frames
+					threadPool = std::make_unique<IkThreadPool>(recordingBenchmark.threadCount());
+				}
+				if (benchmarkLighting && lightingBenchmark.addFrame(frameTime * 1000.0)) {
+					if (lightingBenchmark.finished()) break;
+					spawnPointLights(lightingBenchmark.lightCount(), LightingBenchmark::LIGHT_INTENSITY);
+				}
+				if (frameLimit > 0 && frameCount >= frameLimit) break;
 			}
 		}
+		//the readback is ordered behind the last frame on the graphics queue by its own barrier
+		if (settings.headless && !settings.capturePath.empty() && frameCount > 0) {
+			captureLastFrame();
+		}
 		vkDeviceWaitIdle(ikeDeviceEngine.device());
+		for (uint32_t index : materialBufferIndices) {
+			bindlessTable.releaseStorageBuffer(index);
+		}
+		if (settings.gpuProfile) {
+			printGpuProfile();
+		}
+		if (settings.reportLatency) {
+			printLatency();
+		}
+		if (!settings.cpuTracePath.empty()) {
+			IkCpuProfiler::writeChromeTrace(settings.cpuTracePath);
+			std::cout << "wrote CPU trace to " << settings.cpuTracePath << std::endl;
+		}
+	}
+
+	void FirstApp::printLatency() {
+		IkeRenderer::LatencyStats latency = IkRenderer.getLatencyStats();
+		std::cout << (latency.toPresent ? "input to present" : "input to GPU finish (no present wait)")
+			<< " latency over the last " << latency.sampleCount << " frames with "
+			<< IkRenderer.getFramesInFlight() << " frame(s) in flight: avg " << latency.averageMs
+			<< " ms  p95 " << latency.p95Ms << " ms  max " << latency.maxMs << " ms" << std::endl;
+	}
+
+	void FirstApp::printGpuProfile() {
+		const IkGpuProfiler& gpuProfiler = IkRenderer.getGpuProfiler();
+		if (!gpuProfiler.isSupported()) {
+			std::cout << "gpu profile: the graphics queue has no timestamps" << std::endl;
+			return;
+		}
+		std::cout << "gpu profile over the last " << IkGpuProfiler::HISTORY_SIZE << " frames (ms)" << std::endl;
+		std::cout << std::fixed << std::setprecision(3);
+		for (const auto& scope : gpuProfiler.getStats()) {
+			std::cout << "  " << std::left << std::setw(40) << scope.name << std::right
+				<< " avg " << scope.averageMs
+				<< "  p50 " << scope.p50Ms
+				<< "  p95 " << scope.p95Ms
+				<< "  p99 " << scope.p99Ms
+				<< "  max " << scope.maxMs
+				<< "  (" << scope.sampleCount << " frames)" << std::endl;
+		}
+		std::cout << std::defaultfloat;
+	}
+
+	void FirstApp::captureLastFrame() {
+		std::vector<uint8_t> rgba;
+		IkRenderer.readLastFrame(rgba);
+
+		const std::string& path = settings.capturePath;
+		VkExtent2D extent = IkRenderer.getSwapChainExtent();
+		if (path.size() >= 4 && path.compare(path.size() - 4, 4, ".png") == 0) {
+			writePng(path, extent.width, extent.height, rgba);
+		}
+		else {
+			writeRaw(path, rgba);
+		}
+		std::cout << "captured " << extent.width << "x" << extent.height << " frame to " << path << std::endl;
+	}
+
+	void FirstApp::runRecordingBenchmark() {
+		loadBenchmarkObjects();
+		benchmarkRecording = true;
+		run();
+	}
+
+	void FirstApp::runLightingBenchmark() {
+		benchmarkLighting = true;
+		run();
+	}
+
+	void FirstApp::runDescriptorBenchmark() {
+		constexpr int ITERATIONS = 100000;
+
+		IkBuffer uniformBuffer{ ikeDeviceEngine, sizeof(GlobalUbo), 1, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT };
+		IkBuffer storageBuffer{ ikeDeviceEngine, sizeof(PointLight), 1, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT };
+		auto uniformInfo = uniformBuffer.descriptorInfo();
+		auto storageInfo = storageBuffer.descriptorInfo();
+
+		//the bindings of the global set
+		auto layoutBuilder = [&]() {
+			return IkDescriptorSetLayout::Builder(ikeDeviceEngine)
+				.addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
+				.addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
+				.addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT)
+				.addBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT);
+		};
+		auto writeAll = [&](IkDescriptorWriter& writer) -> IkDescriptorWriter& {
+			return writer
+				.writeBuffer(0, &uniformInfo)
+				.writeBuffer(1, &storageInfo)
+				.writeBuffer(2, &storageInfo)
+				.writeBuffer(3, &storageInfo);
+		};
+		//the writer is part of what is measured, filling it is the other half of the cost
+		auto measure = [](const char* method, const std::function<void()>& update) {
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < ITERATIONS; i++) {
+				update();
+			}
+			double totalNs = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+			std::cout << std::left << std::setw(40) << method << std::right
+				<< " avg " << totalNs / ITERATIONS << " ns per update" << std::endl;
+		};
+
+		IkDescriptorPoolManager& poolManager = IkRenderer.getDescriptorPoolManager();
+		auto writesLayout = layoutBuilder().build();
+		auto templateLayout = layoutBuilder().useUpdateTemplate().build();
+		//never bound, so the same set can be rewritten over and over
+		VkDescriptorSet writesSet = poolManager.allocate(writesLayout->getDescriptorSetLayout());
+		VkDescriptorSet templateSet = poolManager.allocate(templateLayout->getDescriptorSetLayout());
+
+		std::cout << "descriptor updates of a 4 binding set, " << ITERATIONS << " each" << std::endl;
+		measure("vkUpdateDescriptorSets", [&]() {
+			IkDescriptorWriter writer{ *writesLayout, poolManager };
+			writeAll(writer).overwrite(writesSet);
+		});
+		measure("vkUpdateDescriptorSetWithTemplate", [&]() {
+			IkDescriptorWriter writer{ *templateLayout, poolManager };
+			writeAll(writer).overwrite(templateSet);
+		});
+
+		if (!ikeDeviceEngine.supportsPushDescriptors()) {
+			std::cout << "push descriptors: VK_KHR_push_descriptor is not supported" << std::endl;
+			return;
+		}
+
+		auto pushLayout = layoutBuilder().setPushDescriptor().build();
+		auto pushTemplateLayout = layoutBuilder().setPushDescriptor().useUpdateTemplate().build();
+		auto createPipelineLayout = [&](const IkDescriptorSetLayout& setLayout) {
+			VkDescriptorSetLayout descriptorSetLayout = setLayout.getDescriptorSetLayout();
+			VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+			pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+			pipelineLayoutInfo.setLayoutCount = 1;
+			pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+			VkPipelineLayout pipelineLayout;
+			if (vkCreatePipelineLayout(ikeDeviceEngine.device(), &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+				throw std::runtime_error("failed to create pipeline layout!");
+			}
+			return pipelineLayout;
+		};
+		VkPipelineLayout pushPipelineLayout = createPipelineLayout(*pushLayout);
+		VkPipelineLayout pushTemplatePipelineLayout = createPipelineLayout(*pushTemplateLayout);
+		pushTemplateLayout->createPushTemplate(pushTemplatePipelineLayout, 0);
+
+		//pushes are only recorded, the command buffer is submitted once at the end without any draw
+		VkCommandBuffer commandBuffer = ikeDeviceEngine.beginSingleTimeCommands();
+		measure("vkCmdPushDescriptorSetKHR", [&]() {
+			IkDescriptorWriter writer{ *pushLayout, poolManager };
+			writeAll(writer).push(commandBuffer, pushPipelineLayout, 0);
+		});
+		measure("vkCmdPushDescriptorSetWithTemplateKHR", [&]() {
+			IkDescriptorWriter writer{ *pushTemplateLayout, poolManager };
+			writeAll(writer).push(commandBuffer, pushTemplatePipelineLayout, 0);
+		});
+		ikeDeviceEngine.endSingleTimeCommands(commandBuffer);
+
+		vkDestroyPipelineLayout(ikeDeviceEngine.device(), pushPipelineLayout, nullptr);
+		vkDestroyPipelineLayout(ikeDeviceEngine.device(), pushTemplatePipelineLayout, nullptr);
+	}
+
+	void FirstApp::runEntityBenchmark() {
+		constexpr int ENTITY_COUNT = 100000;
+		//every LIGHT_EVERY-th entity is a point light, the others have a model
+		constexpr int LIGHT_EVERY = 10;
+		constexpr int ITERATIONS = 100;
+
+		//the scene before the registry, one hash map node per object with optional pointer components
+		struct MapObject {
+			TransformComponent transform{};
+			glm::vec3 color{};
+			std::shared_ptr<ikEngineModel> model{};
+			std::unique_ptr<PointLightComponent> pointLight{};
+		};
+		std::unordered_map<IkEntity, MapObject> mapObjects;
+		IkEntityRegistry registry;
+
+		std::shared_ptr<ikEngineModel> ikModel = ikEngineModel::createModelFromFile(ikeDeviceEngine, "Assets/models/smooth_vase.obj");
+		for (int i = 0; i < ENTITY_COUNT; i++) {
+			TransformComponent transform{};
+			transform.translation = { static_cast<float>(i % 100), .5f, static_cast<float>(i / 100) };
+			MapObject object{};
+			object.transform = transform;
+			IkEntity entity = registry.create(transform);
+			if (i % LIGHT_EVERY == 0) {
+				object.color = glm::vec3(1.f);
+				object.pointLight = std::make_unique<PointLightComponent>();
+				registry.pointLights.add(entity);
+				registry.colors.add(entity, ColorComponent{ glm::vec3(1.f) });
+			}
+			else {
+				object.model = ikModel;
+				registry.addModel(entity, ModelComponent{ ikModel });
+			}
+			mapObjects.emplace(entity, std::move(object));
+		}
+
+		//what the passes produce is summed up here, so none of it can be optimized away
+		volatile float sink = 0.f;
+		auto measure = [](const char* pass, const std::function<void()>& run) {
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < ITERATIONS; i++) {
+				run();
+			}
+			double totalMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+			std::cout << std::left << std::setw(40) << pass << std::right
+				<< " avg " << totalMs / ITERATIONS << " ms per pass" << std::endl;
+		};
+		//IkRenderSystem::renderGameObjects, find the drawable objects and compute their push constants
+		auto drawMatrices = [&](const TransformComponent& transform) {
+			glm::mat4 modelMatrix = transform.mat4();
+			glm::mat3 normalMatrix = transform.normalMatrix();
+			sink = sink + modelMatrix[3][0] + normalMatrix[0][0];
+		};
+		//IkPointLightSystem::update, rotate every light and pack it for the light buffer
+		auto rotateLight = glm::rotate(glm::mat4(1.f), .01f, { 0.f, -1.f,0.f });
+		std::vector<PointLight> lights;
+		auto packLight = [&](TransformComponent& transform, const glm::vec3& color, float intensity) {
+			transform.translation = glm::vec3(rotateLight * glm::vec4(transform.translation, 1.f));
+			PointLight light{};
+			light.position = glm::vec4(transform.translation, transform.scale.x);
+			light.color = glm::vec4(color, intensity);
+			lights.push_back(light);
+		};
+
+		std::cout << "entity passes over " << ENTITY_COUNT << " entities, " << registry.getModels().size() << " models and "
+			<< registry.pointLights.size() << " lights, " << ITERATIONS << " each" << std::endl;
+		measure("unordered_map draw pass", [&]() {
+			for (auto& kv : mapObjects) {
+				if (kv.second.model == nullptr) continue;
+				drawMatrices(kv.second.transform);
+			}
+		});
+		measure("IkEntityRegistry draw pass", [&]() {
+			const std::vector<IkEntity>& modelEntities = registry.getModels().entities();
+			for (size_t i = 0; i < modelEntities.size(); i++) {
+				drawMatrices(registry.transforms.get(modelEntities[i]));
+			}
+		});
+		measure("unordered_map light pass", [&]() {
+			lights.clear();
+			for (auto& kv : mapObjects) {
+				if (kv.second.pointLight == nullptr) continue;
+				packLight(kv.second.transform, kv.second.color, kv.second.pointLight->lightIntensity);
+			}
+		});
+		measure("IkEntityRegistry light pass", [&]() {
+			lights.clear();
+			const std::vector<IkEntity>& lightEntities = registry.pointLights.entities();
+			const std::vector<PointLightComponent>& pointLights = registry.pointLights.components();
+			for (size_t i = 0; i < lightEntities.size(); i++) {
+				packLight(
+					registry.transforms.get(lightEntities[i]),
+					registry.colors.get(lightEntities[i]).color,
+					pointLights[i].lightIntensity);
+			}
+		});
+	}
+
+	void FirstApp::runRenderGraphCheck() {
+		constexpr VkFormat FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+		constexpr VkExtent2D EXTENT{ 64, 64 };
+		VkDevice device = ikeDeviceEngine.device();
+
+		//the imported image every pass leads to, so nothing is culled
+		VkImageCreateInfo imageInfo{};
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.extent = { EXTENT.width, EXTENT.height, 1 };
+		imageInfo.mipLevels = 1;
+		imageInfo.arrayLayers = 1;
+		imageInfo.format = FORMAT;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		VkImage outputImage;
+		VkDeviceMemory outputMemory;
+		ikeDeviceEngine.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, outputImage, outputMemory);
+
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = outputImage;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = FORMAT;
+		viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+		VkImageView outputView;
+		if (vkCreateImageView(device, &viewInfo, nullptr, &outputView) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create render graph check image view!");
+		}
+
+		bool passed = false;
+		{
+			//every pass samples what the one before it wrote, so each is a render pass of its own. a is last used
+			//(sampled) in 1 and b first used in 2, so b takes over a's memory. b is last used as a color attachment
+			//in 4, which is what b's first use used to wait for instead of a
+			IkRenderGraph graph{ ikeDeviceEngine };
+			auto output = graph.importImage("output", FORMAT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+			auto a = graph.createImage("a", FORMAT);
+			auto b = graph.createImage("b", FORMAT);
+			auto c = graph.createImage("c", FORMAT);
+			auto d = graph.createImage("d", FORMAT);
+			VkClearColorValue clear{};
+			graph.addPass("write a").writeColor(a, clear);
+			graph.addPass("read a").sampleImage(a).writeColor(c, clear);
+			auto writeB = graph.addPass("write b").sampleImage(c).writeColor(b, clear).id();
+			graph.addPass("read b").sampleImage(b).writeColor(d, clear);
+			graph.addPass("write b again").sampleImage(d).writeColor(b).writeColor(output, clear);
+			graph.setImportedViews(output, { outputView });
+			graph.compile(EXTENT, 1);
+
+			//sampling a in "read a" is the last use of the memory before b's clear
+			VkPipelineStageFlags srcStages = 0;
+			for (const auto& dependency : graph.getDependencies(writeB)) {
+				if (dependency.srcSubpass == VK_SUBPASS_EXTERNAL && dependency.dstSubpass == graph.getSubpass(writeB)) {
+					srcStages |= dependency.srcStageMask;
+				}
+			}
+			bool aliased = graph.sharesMemory(a, b);
+			passed = !aliased || (srcStages & VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT) != 0;
+			std::cout << "render graph check: a and b " << (aliased ? "share" : "do not share") << " memory, "
+				<< "b's first render pass " << (passed ? "waits" : "does not wait") << " for a's last use" << std::endl;
+		}
+
+		vkDestroyImageView(device, outputView, nullptr);
+		vkDestroyImage(device, outputImage, nullptr);
+		vkFreeMemory(device, outputMemory, nullptr);
+		if (!passed) {
+			throw std::runtime_error("render graph check failed!");
+		}
 	}
 
 	//here we load the vertices via ikEnginModel
 	void FirstApp::loadGameObjects() {
+		IK_PROFILE_ZONE("FirstApp::loadGameObjects");
 		std::shared_ptr<ikEngineModel> ikModel = ikEngineModel::createModelFromFile(ikeDeviceEngine, "Assets/models/flat_vase.obj");
 
-        auto flatVase= IkgameObject::createGameObject();
-        flatVase.model = ikModel;
-        flatVase.transform.translation = { -.5f, .5f, 0.f };
-		flatVase.transform.scale = { 3.f ,1.5f,3.f};
-        gameObjects.emplace(flatVase.getId(),std::move(flatVase));  
+		TransformComponent flatVase{};
+		flatVase.translation = { -.5f, .5f, 0.f };
+		flatVase.scale = { 3.f ,1.5f,3.f};
+		entities.addModel(entities.create(flatVase), ModelComponent{ ikModel, 0, true });
 		
 
 	    ikModel = ikEngineModel::createModelFromFile(ikeDeviceEngine, "Assets/models/smooth_vase.obj");
 
-		auto smoothVase = IkgameObject::createGameObject();
-		smoothVase.model = ikModel;
-		smoothVase.transform.translation = { .5f, .5f, 0.f };
-		smoothVase.transform.scale = { 3.f ,1.5f,3.f };
-		gameObjects.emplace(smoothVase.getId(),std::move(smoothVase));
+		TransformComponent smoothVase{};
+		smoothVase.translation = { .5f, .5f, 0.f };
+		smoothVase.scale = { 3.f ,1.5f,3.f };
+		entities.addModel(entities.create(smoothVase), ModelComponent{ ikModel, 0, true });
 
 		ikModel = ikEngineModel::createModelFromFile(ikeDeviceEngine, "Assets/models/quad.obj");
 
-		auto floor = IkgameObject::createGameObject();
-		floor.model = ikModel;
-		floor.transform.translation = { 0.f, .5f, 0.f };
-		floor.transform.scale = { 3.f ,1.f,3.f };
-		gameObjects.emplace(floor.getId(),std::move(floor));
+		TransformComponent floorTransform{};
+		floorTransform.translation = { 0.f, .5f, 0.f };
+		floorTransform.scale = { 3.f ,1.f,3.f };
+		ModelComponent floor{ ikModel, 0, true };
+		if (!settings.floorTexturePath.empty()) {
+			floor.materialId = static_cast<uint32_t>(materials.size());
+			materials.push_back(Material{});
+			materialTextures.push_back(textureManager.load(settings.floorTexturePath));
+		}
+		entities.addModel(entities.create(floorTransform), std::move(floor));
 
 
 
 		
+		//more lights share the total intensity of the original six 0.2 lights, so each one reaches less far
+		//and touches fewer clusters
+		constexpr float TOTAL_LIGHT_INTENSITY = 6 * .2f;
+		spawnPointLights(settings.pointLightCount, TOTAL_LIGHT_INTENSITY / settings.pointLightCount);
+	}
+
+	//replaces every point light with count lights spread evenly on a ring around the vases
+	void FirstApp::spawnPointLights(int count, float intensity) {
+		//destroying the last light of the pool just pops it, no other light moves
+		while (!entities.pointLights.empty()) {
+			entities.destroy(entities.pointLights.entities().back());
+		}
+
 		std::vector<glm::vec3> lightColors{
 	      {1.f, .1f, .1f},
 	     {.1f, .1f, 1.f},
@@ -170,15 +798,35 @@ namespace ikE {
 	     {1.f, 1.f, 1.f}  //
 		};
 
-		for (int i = 0; i < lightColors.size(); i++) {
+		for (int i = 0; i < count; i++) {
 		
-		    auto pointLight = IkgameObject::makePointLight(0.2f);
-			pointLight.color = lightColors[i];
-			auto rotateLight = glm::rotate(glm::mat4(1.f), (i * glm::two_pi<float>()) / lightColors.size(), { 0.f, -1.f,0.f });
-			pointLight.transform.translation = glm::vec3(rotateLight * glm::vec4(-1.f, -1.f, -1.f, 1.f));
-		    gameObjects.emplace(pointLight.getId(), std::move(pointLight));
+		    IkEntity pointLight = entities.createPointLight(intensity, 0.1f, lightColors[i % lightColors.size()]);
+			auto rotateLight = glm::rotate(glm::mat4(1.f), (i * glm::two_pi<float>()) / count, { 0.f, -1.f,0.f });
+			entities.transforms.get(pointLight).translation = glm::vec3(rotateLight * glm::vec4(-1.f, -1.f, -1.f, 1.f));
 		}
+	}
 
+	//a dense field of vases so that recording, not the GPU, dominates the frame
+	void FirstApp::loadBenchmarkObjects() {
+		IK_PROFILE_ZONE("FirstApp::loadBenchmarkObjects");
+		constexpr int GRID_SIZE = 100;
+		constexpr float SPACING = .4f;
+
+		std::shared_ptr<ikEngineModel> ikModel = ikEngineModel::createModelFromFile(ikeDeviceEngine, "Assets/models/smooth_vase.obj");
+
+		entities.transforms.reserve(entities.size() + GRID_SIZE * GRID_SIZE);
+		entities.reserveModels(entities.getModels().size() + GRID_SIZE * GRID_SIZE);
+		for (int x = 0; x < GRID_SIZE; x++) {
+			for (int z = 0; z < GRID_SIZE; z++) {
+				TransformComponent vase{};
+				vase.translation = {
+					(x - GRID_SIZE / 2) * SPACING,
+					.5f,
+					2.f + z * SPACING };
+				vase.scale = { .5f, .5f, .5f };
+				entities.addModel(entities.create(vase), ModelComponent{ ikModel });
+			}
+		}
 	}
 
 	
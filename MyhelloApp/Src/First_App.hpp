@@ -3,44 +3,102 @@
 
 
 #include "ikDeviceEngine.hpp"
-#include "ikgameObject.hpp"
+#include "ikEntityRegistry.hpp"
 #include "ikRenderer.hpp"
 #include "ikWindow.hpp"
 #include "ikDescriptors.hpp"
+#include "ikframeInfo.hpp"
+#include "ikTextureManager.hpp"
+#include "ikThreadPool.hpp"
 
 
 //std
 #include <memory>
+#include <string>
 #include <vector>
 namespace ikE {
+	//options chosen on the command line, see Main.cpp
+	struct AppSettings {
+		bool depthPrepass = false;
+		bool deferred = false;
+		int pointLightCount = 6;
+		//renders into offscreen images without a window or swap chain, e.g. on lavapipe in CI
+		bool headless = false;
+		//stop after this many frames, 0 runs until the window closes (a headless run stops after one frame)
+		int maxFrames = 0;
+		//headless only, the last frame is written here at exit, as PNG for a .png path and raw RGBA8 otherwise
+		std::string capturePath;
+		//prints the GPU time of every profiler scope over the last frames at exit
+		bool gpuProfile = false;
+		//IK_PROFILE_ZONE timings of every thread are written here at exit as Chrome trace JSON, see ikCpuProfiler.hpp
+		std::string cpuTracePath;
+		FramePacing framePacing;
+		//prints the measured input to present latency at exit
+		bool reportLatency = false;
+		//TGA or baked .iktx texture for the floor, streamed in while the scene already renders untextured
+		std::string floorTexturePath;
+	};
+
 	class FirstApp {
 	public:
 		static constexpr int WIDTH = 800;
 		static constexpr int HEIGTH = 600;
 
 		//because we have the constructors here we should also remember to delete the copy constructors 
-		FirstApp();
+		explicit FirstApp(const AppSettings& settings = AppSettings{});
 		~FirstApp();
 
 		FirstApp(const FirstApp&) = delete;
 		FirstApp& operator =(const FirstApp&) = delete;
 
 		void run();
+		//renders a heavy scene with 1, 2, 4 and 8 recording threads and prints the average CPU recording time
+		void runRecordingBenchmark();
+		//renders the default scene with a growing number of point lights and prints the average frame time
+		void runLightingBenchmark();
+		//times writing a set like the global one with vkUpdateDescriptorSets against an update template, and the
+		//same for push descriptors when the device has them, then prints the average CPU time per update
+		void runDescriptorBenchmark();
+		//times the per frame passes of the render and point light systems over 100k entities, in the registry
+		//against the unordered_map of objects it replaced, and prints the average CPU time per pass
+		void runEntityBenchmark();
+		//compiles a small render graph in which two images share memory one after the other and checks that the
+		//second one's first render pass waits for the first one's last use, throws if it does not
+		void runRenderGraphCheck();
 
 	private:
 	
 		void loadGameObjects();
+		void loadBenchmarkObjects();
+		void spawnPointLights(int count, float intensity);
+		void captureLastFrame();
+		void printGpuProfile();
+		void printLatency();
 	
 
-		IkeWindow   ikeWindow{ WIDTH,HEIGTH,"HELLO GUYS" };
+		AppSettings settings;
+
+		IkeWindow   ikeWindow{ WIDTH,HEIGTH,"HELLO GUYS",settings.headless };
 		IkeDeviceEngine ikeDeviceEngine{ ikeWindow };
-		IkeRenderer IkRenderer{ ikeWindow,ikeDeviceEngine };
+		IkeRenderer IkRenderer{ ikeWindow,ikeDeviceEngine,settings.framePacing };
+		IkTextureManager textureManager{
+			ikeDeviceEngine,
+			IkRenderer.getDeletionQueue(),
+			IkRenderer.getBindlessTable(),
+			IkRenderer.getSamplerCache() };
 
 		//note order of declaration matters
 		//it is initialized from top to bottom
 		//and cleaned up in reverse order meaning bottom to top
-		std::unique_ptr<IkDescriptorPool> globalPool{};
-		IkgameObject::Map gameObjects;
+		std::unique_ptr<IkThreadPool> threadPool{};
+		IkEntityRegistry entities;
+		//indexed by ModelComponent::materialId and written to the material buffer of the frame every frame, so a texture
+		//shows up as soon as it is ready. materialTextures holds the base color texture of each material, if any
+		std::vector<Material> materials{ Material{} };
+		std::vector<std::shared_ptr<IkTexture>> materialTextures{ nullptr };
+
+		bool benchmarkRecording{ false };
+		bool benchmarkLighting{ false };
 	};
 
 } //namepace
@@ -3,7 +3,7 @@
 
 namespace ikE {
 
-	void keyBoardMovementController::moveInPlaneXZ(GLFWwindow* window, float dt, IkgameObject& gameObject) {
+	void keyBoardMovementController::moveInPlaneXZ(GLFWwindow* window, float dt, TransformComponent& transform) {
 
 		glm::vec3 rotate{ 0 };
 		if (glfwGetKey(window, keys.lookRight) == GLFW_PRESS) rotate.y += 1.f;
@@ -12,13 +12,13 @@ namespace ikE {
 		if (glfwGetKey(window, keys.lookDown) == GLFW_PRESS) rotate.x -= 1.f;
 
 		if (glm::dot(rotate, rotate) > std::numeric_limits<float>::epsilon()) {
-             gameObject.transform.rotation += lookSpeed * dt * glm::normalize(rotate);
+             transform.rotation += lookSpeed * dt * glm::normalize(rotate);
 		}
 		
-		gameObject.transform.rotation.x = glm::clamp(gameObject.transform.rotation.x, -1.5f, 1.5f);
-		gameObject.transform.rotation.y = glm::mod(gameObject.transform.rotation.y, glm::two_pi<float>());
+		transform.rotation.x = glm::clamp(transform.rotation.x, -1.5f, 1.5f);
+		transform.rotation.y = glm::mod(transform.rotation.y, glm::two_pi<float>());
 
-		float yaw = gameObject.transform.rotation.y;
+		float yaw = transform.rotation.y;
 		const glm::vec3 forwardDir{ sin(yaw), 0.f, cos(yaw) };
 		const glm::vec3 rightDir{ forwardDir.z, 0.f, -forwardDir.x };
 		const glm::vec3 upDir{ 0.f, -1.f, 0.f };
@@ -34,7 +34,7 @@ namespace ikE {
 		if (glfwGetKey(window, keys.moveDown) == GLFW_PRESS) moveDir -= upDir;
 
 		if (glm::dot(moveDir, moveDir) > std::numeric_limits<float>::epsilon()) {
-			gameObject.transform.translation += moveSpeed * dt * glm::normalize(moveDir);
+			transform.translation += moveSpeed * dt * glm::normalize(moveDir);
 		}
 
 	}
@@ -26,7 +26,7 @@ namespace ikE {
 			int lookDown = GLFW_KEY_DOWN;
 		};
 
-		void moveInPlaneXZ(GLFWwindow* window, float dt, IkgameObject& gameObject);
+		void moveInPlaneXZ(GLFWwindow* window, float dt, TransformComponent& transform);
 
 		keyMappings keys{};
 		float moveSpeed{ 3.f };
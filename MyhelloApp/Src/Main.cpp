@@ -1,14 +1,110 @@
-
 #include "First_App.hpp"
+#include "ikCpuProfiler.hpp"
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
 
-int main() {
-    ikE::FirstApp app{};
+int main(int argc, char** argv) {
+    IK_PROFILE_THREAD("main");
+    ikE::AppSettings settings{};
+    bool benchRecording = false;
+    bool benchLighting = false;
+    bool benchDescriptors = false;
+    bool benchEntities = false;
+    bool checkRenderGraph = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--bench-recording") == 0) {
+            benchRecording = true;
+        }
+        else if (std::strcmp(argv[i], "--bench-lighting") == 0) {
+            benchLighting = true;
+        }
+        else if (std::strcmp(argv[i], "--bench-descriptors") == 0) {
+            benchDescriptors = true;
+        }
+        else if (std::strcmp(argv[i], "--bench-entities") == 0) {
+            benchEntities = true;
+        }
+        else if (std::strcmp(argv[i], "--check-render-graph") == 0) {
+            checkRenderGraph = true;
+        }
+        else if (std::strcmp(argv[i], "--deferred") == 0) {
+            settings.deferred = true;
+        }
+        else if (std::strcmp(argv[i], "--depth-prepass") == 0) {
+            settings.depthPrepass = true;
+        }
+        else if (std::strcmp(argv[i], "--lights") == 0 && i + 1 < argc) {
+            settings.pointLightCount = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--headless") == 0) {
+            settings.headless = true;
+        }
+        else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            settings.maxFrames = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+            settings.capturePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--gpu-profile") == 0) {
+            settings.gpuProfile = true;
+        }
+        else if (std::strcmp(argv[i], "--cpu-trace") == 0 && i + 1 < argc) {
+            settings.cpuTracePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--frames-in-flight") == 0 && i + 1 < argc) {
+            settings.framePacing.framesInFlight = std::clamp(std::atoi(argv[++i]), 1, ikE::ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT);
+        }
+        else if (std::strcmp(argv[i], "--present") == 0 && i + 1 < argc) {
+            //mailbox, low-latency or vsync
+            const char* policy = argv[++i];
+            if (std::strcmp(policy, "low-latency") == 0) settings.framePacing.presentPolicy = ikE::PresentPolicy::LowLatency;
+            else if (std::strcmp(policy, "vsync") == 0) settings.framePacing.presentPolicy = ikE::PresentPolicy::VSync;
+            else settings.framePacing.presentPolicy = ikE::PresentPolicy::Mailbox;
+        }
+        else if (std::strcmp(argv[i], "--present-wait") == 0) {
+            settings.framePacing.presentWait = true;
+        }
+        else if (std::strcmp(argv[i], "--fps-limit") == 0 && i + 1 < argc) {
+            settings.framePacing.targetFps = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--latency") == 0) {
+            settings.reportLatency = true;
+        }
+        else if (std::strcmp(argv[i], "--floor-texture") == 0 && i + 1 < argc) {
+            settings.floorTexturePath = argv[++i];
+        }
+    }
 
     try {
-        app.run();
+        if (benchLighting) {
+            //the render pass is fixed for the lifetime of an app, so each path gets its own
+            for (bool deferred : { false, true }) {
+                settings.deferred = deferred;
+                ikE::FirstApp app{ settings };
+                app.runLightingBenchmark();
+            }
+        }
+        else {
+            ikE::FirstApp app{ settings };
+            if (benchRecording) {
+                app.runRecordingBenchmark();
+            }
+            else if (benchDescriptors) {
+                app.runDescriptorBenchmark();
+            }
+            else if (benchEntities) {
+                app.runEntityBenchmark();
+            }
+            else if (checkRenderGraph) {
+                app.runRenderGraphCheck();
+            }
+            else {
+                app.run();
+            }
+        }
     }            
      
     catch (const std::exception& e) {
@@ -17,4 +113,4 @@ int main() {
     }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
@@ -0,0 +1,120 @@
+#include "ikBindlessTable.hpp"
+
+//std
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <string>
+namespace ikE {
+
+	namespace {
+		//descriptors of the other sets count against the same per stage limits
+		constexpr uint32_t RESERVED_DESCRIPTORS = 16;
+
+		uint32_t clampToLimits(uint32_t wanted, uint32_t perStageLimit, uint32_t perSetLimit) {
+			uint32_t perStage = perStageLimit > RESERVED_DESCRIPTORS ? perStageLimit - RESERVED_DESCRIPTORS : 1;
+			return std::max(1u, std::min({ wanted, perStage, perSetLimit }));
+		}
+	}
+
+	IkBindlessTable::IkBindlessTable(IkeDeviceEngine& device, IkDeletionQueue& deletionQueue)
+		: ikeDevice{ device }, deletionQueue{ deletionQueue } {
+		const VkPhysicalDeviceDescriptorIndexingProperties& limits = ikeDevice.descriptorIndexingProperties;
+		storageBuffers.capacity = clampToLimits(
+			MAX_STORAGE_BUFFERS,
+			limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+			limits.maxDescriptorSetUpdateAfterBindStorageBuffers);
+		//a combined image sampler counts as a sampled image and as a sampler
+		textures.capacity = clampToLimits(
+			MAX_TEXTURES,
+			std::min(limits.maxPerStageDescriptorUpdateAfterBindSampledImages, limits.maxPerStageDescriptorUpdateAfterBindSamplers),
+			std::min(limits.maxDescriptorSetUpdateAfterBindSampledImages, limits.maxDescriptorSetUpdateAfterBindSamplers));
+
+		//unused while pending on top of update after bind, so a free index can be written while frames in flight
+		//that do not read it still use the set
+		VkDescriptorBindingFlags bindingFlags =
+			VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+			VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+			VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+		setLayout = IkDescriptorSetLayout::Builder(ikeDevice)
+			.addBinding(STORAGE_BUFFER_BINDING, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_ALL,
+				storageBuffers.capacity, bindingFlags)
+			.addBinding(TEXTURE_BINDING, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL,
+				textures.capacity, bindingFlags | VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT)
+			.build();
+
+		pool = IkDescriptorPool::Builder(ikeDevice)
+			.setMaxSets(1)
+			.setPoolFlags(VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT)
+			.addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, storageBuffers.capacity)
+			.addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, textures.capacity)
+			.build();
+
+		if (!pool->allocateDescriptor(setLayout->getDescriptorSetLayout(), descriptorSet, textures.capacity)) {
+			throw std::runtime_error("failed to allocate bindless descriptor set!");
+		}
+	}
+
+	uint32_t IkBindlessTable::addStorageBuffer(const VkDescriptorBufferInfo& bufferInfo) {
+		uint32_t index = acquireSlot(storageBuffers, "storage buffers");
+
+		VkWriteDescriptorSet write{};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = descriptorSet;
+		write.dstBinding = STORAGE_BUFFER_BINDING;
+		write.dstArrayElement = index;
+		write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		write.descriptorCount = 1;
+		write.pBufferInfo = &bufferInfo;
+		vkUpdateDescriptorSets(ikeDevice.device(), 1, &write, 0, nullptr);
+		return index;
+	}
+
+	uint32_t IkBindlessTable::addTexture(const VkDescriptorImageInfo& imageInfo) {
+		uint32_t index = acquireSlot(textures, "textures");
+
+		VkWriteDescriptorSet write{};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = descriptorSet;
+		write.dstBinding = TEXTURE_BINDING;
+		write.dstArrayElement = index;
+		write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		write.descriptorCount = 1;
+		write.pImageInfo = &imageInfo;
+		vkUpdateDescriptorSets(ikeDevice.device(), 1, &write, 0, nullptr);
+		return index;
+	}
+
+	void IkBindlessTable::releaseStorageBuffer(uint32_t index) {
+		releaseSlot(storageBuffers, index);
+	}
+
+	void IkBindlessTable::releaseTexture(uint32_t index) {
+		releaseSlot(textures, index);
+	}
+
+	void IkBindlessTable::bind(
+		VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, VkPipelineBindPoint bindPoint) const {
+		vkCmdBindDescriptorSets(commandBuffer, bindPoint, pipelineLayout, BINDLESS_SET, 1, &descriptorSet, 0, nullptr);
+	}
+
+	uint32_t IkBindlessTable::acquireSlot(Slots& slots, const char* kind) {
+		if (!slots.released.empty()) {
+			uint32_t index = slots.released.back();
+			slots.released.pop_back();
+			return index;
+		}
+		if (slots.used == slots.capacity) {
+			throw std::runtime_error(std::string("bindless table is out of ") + kind + "!");
+		}
+		return slots.used++;
+	}
+
+	void IkBindlessTable::releaseSlot(Slots& slots, uint32_t index) {
+		assert(index < slots.used && "Bindless index was never handed out");
+		//the descriptor is left as it is, partially bound only asks for the descriptors a shader reads to be valid
+		Slots* releasedTo = &slots;
+		deletionQueue.retire([releasedTo, index]() { releasedTo->released.push_back(index); });
+	}
+
+}//namespace ikE
@@ -0,0 +1,75 @@
+#ifndef IKBINDLESSTABLE_HPP
+#define IKBINDLESSTABLE_HPP
+
+#include "ikDeviceEngine.hpp"
+#include "ikDeletionQueue.hpp"
+#include "ikDescriptors.hpp"
+
+//std
+#include <cstdint>
+#include <memory>
+#include <vector>
+namespace ikE {
+	/*IkBindlessTable is the global resource table, one descriptor set holding an array of storage buffers and an array
+	  of combined image samplers that shaders index at run time (descriptor indexing), e.g. a per draw material id
+	  selects a material in a storage buffer and the material names its textures. a pipeline layout that has it as set
+	  BINDLESS_SET binds it once per command buffer, no matter how many materials the draws use.
+	  both bindings are partially bound and update after bind, so adding a resource writes a single descriptor while
+	  frames in flight keep using the set. a released index is only handed out again once the deletion queue ran it,
+	  when the frames that may still read it are done. main thread only*/
+	class IkBindlessTable {
+	public:
+		static constexpr uint32_t BINDLESS_SET = 1;
+		static constexpr uint32_t STORAGE_BUFFER_BINDING = 0;
+		static constexpr uint32_t TEXTURE_BINDING = 1;
+		//clamped to the device's update after bind limits
+		static constexpr uint32_t MAX_STORAGE_BUFFERS = 1024;
+		static constexpr uint32_t MAX_TEXTURES = 4096;
+		//no resource, e.g. a material without a texture, the shaders check for it before indexing
+		static constexpr uint32_t INVALID_INDEX = 0xffffffff;
+
+		IkBindlessTable(IkeDeviceEngine& device, IkDeletionQueue& deletionQueue);
+
+		IkBindlessTable(const IkBindlessTable&) = delete;
+		IkBindlessTable& operator =(const IkBindlessTable&) = delete;
+
+		//the returned index is what shaders use, it stays valid until released
+		uint32_t addStorageBuffer(const VkDescriptorBufferInfo& bufferInfo);
+		uint32_t addTexture(const VkDescriptorImageInfo& imageInfo);
+		//the resource itself must outlive the frames in flight, retire it through the deletion queue as well
+		void releaseStorageBuffer(uint32_t index);
+		void releaseTexture(uint32_t index);
+
+		VkDescriptorSetLayout getDescriptorSetLayout() const { return setLayout->getDescriptorSetLayout(); }
+		VkDescriptorSet getDescriptorSet() const { return descriptorSet; }
+		void bind(
+			VkCommandBuffer commandBuffer,
+			VkPipelineLayout pipelineLayout,
+			VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS) const;
+
+		uint32_t getStorageBufferCapacity() const { return storageBuffers.capacity; }
+		uint32_t getTextureCapacity() const { return textures.capacity; }
+
+	private:
+		struct Slots {
+			uint32_t capacity = 0;
+			uint32_t used = 0; //indices below this have been handed out at least once
+			std::vector<uint32_t> released;
+		};
+
+		uint32_t acquireSlot(Slots& slots, const char* kind);
+		void releaseSlot(Slots& slots, uint32_t index);
+
+		IkeDeviceEngine& ikeDevice;
+		IkDeletionQueue& deletionQueue;
+
+		Slots storageBuffers;
+		Slots textures;
+		std::unique_ptr<IkDescriptorSetLayout> setLayout;
+		std::unique_ptr<IkDescriptorPool> pool;
+		//freed with the pool
+		VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+	};
+
+} //namepace
+#endif //header guard
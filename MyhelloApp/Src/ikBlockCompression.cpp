@@ -0,0 +1,798 @@
+#include "ikBlockCompression.hpp"
+
+//std
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+namespace ikE {
+
+	namespace {
+		//one 4x4 block of RGBA8, row major
+		using Block = std::array<std::array<uint8_t, 4>, 16>;
+
+		uint32_t blockBytes(BlockFormat format) {
+			switch (format) {
+			case BlockFormat::BC1:
+			case BlockFormat::ETC2_RGB8:
+				return 8;
+			case BlockFormat::BC3:
+			case BlockFormat::BC5:
+			case BlockFormat::BC7:
+			case BlockFormat::ETC2_RGBA8:
+			case BlockFormat::EAC_RG11:
+				return 16;
+			default:
+				return 0;
+			}
+		}
+
+		//pixels outside the image repeat the last row or column
+		Block fetchBlock(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t bx, uint32_t by) {
+			Block block{};
+			for (uint32_t i = 0; i < 16; i++) {
+				uint32_t x = std::min(bx * 4 + i % 4, width - 1);
+				uint32_t y = std::min(by * 4 + i / 4, height - 1);
+				std::memcpy(block[i].data(), rgba + (static_cast<size_t>(y) * width + x) * 4, 4);
+			}
+			return block;
+		}
+
+		void storeBlock(const Block& block, uint8_t* rgba, uint32_t width, uint32_t height, uint32_t bx, uint32_t by) {
+			for (uint32_t i = 0; i < 16; i++) {
+				uint32_t x = bx * 4 + i % 4;
+				uint32_t y = by * 4 + i / 4;
+				if (x >= width || y >= height) continue;
+				std::memcpy(rgba + (static_cast<size_t>(y) * width + x) * 4, block[i].data(), 4);
+			}
+		}
+
+		int squared(int value) { return value * value; }
+
+		uint8_t clampByte(int value) { return static_cast<uint8_t>(std::clamp(value, 0, 255)); }
+
+		uint64_t readLittleEndian64(const uint8_t* data) {
+			uint64_t value = 0;
+			for (int i = 7; i >= 0; i--) value = (value << 8) | data[i];
+			return value;
+		}
+
+		void writeLittleEndian64(uint8_t* out, uint64_t value, int bytes) {
+			for (int i = 0; i < bytes; i++) out[i] = static_cast<uint8_t>(value >> (8 * i));
+		}
+
+		//ETC and EAC blocks are stored big endian
+		uint64_t readBigEndian64(const uint8_t* data) {
+			uint64_t value = 0;
+			for (int i = 0; i < 8; i++) value = (value << 8) | data[i];
+			return value;
+		}
+
+		void writeBigEndian64(uint8_t* out, uint64_t value) {
+			for (int i = 0; i < 8; i++) out[i] = static_cast<uint8_t>(value >> (56 - 8 * i));
+		}
+
+		/*the line through the block's colors that the endpoints of BC1 and BC7 lie on, the principal axis of the first
+		  channels components found by power iteration. lo and hi are the two ends of the colors projected onto it*/
+		struct Endpoints {
+			float lo[4];
+			float hi[4];
+		};
+
+		Endpoints fitLine(const Block& block, int channels) {
+			float mean[4]{};
+			for (const auto& pixel : block) {
+				for (int c = 0; c < channels; c++) mean[c] += pixel[c];
+			}
+			for (int c = 0; c < channels; c++) mean[c] /= 16.f;
+
+			float covariance[4][4]{};
+			for (const auto& pixel : block) {
+				for (int i = 0; i < channels; i++) {
+					for (int j = 0; j < channels; j++) {
+						covariance[i][j] += (pixel[i] - mean[i]) * (pixel[j] - mean[j]);
+					}
+				}
+			}
+
+			float axis[4]{ 1.f, 1.f, 1.f, 1.f };
+			for (int iteration = 0; iteration < 8; iteration++) {
+				float next[4]{};
+				float largest = 0.f;
+				for (int i = 0; i < channels; i++) {
+					for (int j = 0; j < channels; j++) next[i] += covariance[i][j] * axis[j];
+					largest = std::max(largest, std::abs(next[i]));
+				}
+				//a block of one color has no axis, both endpoints end up at the mean
+				if (largest < 1e-6f) {
+					for (int i = 0; i < channels; i++) axis[i] = 0.f;
+					break;
+				}
+				for (int i = 0; i < channels; i++) axis[i] = next[i] / largest;
+			}
+			float length = 0.f;
+			for (int i = 0; i < channels; i++) length += axis[i] * axis[i];
+			length = std::sqrt(length);
+			if (length > 0.f) {
+				for (int i = 0; i < channels; i++) axis[i] /= length;
+			}
+
+			float tMin = 0.f, tMax = 0.f;
+			for (const auto& pixel : block) {
+				float t = 0.f;
+				for (int c = 0; c < channels; c++) t += (pixel[c] - mean[c]) * axis[c];
+				tMin = std::min(tMin, t);
+				tMax = std::max(tMax, t);
+			}
+
+			Endpoints endpoints{};
+			for (int c = 0; c < channels; c++) {
+				endpoints.lo[c] = std::clamp(mean[c] + tMin * axis[c], 0.f, 255.f);
+				endpoints.hi[c] = std::clamp(mean[c] + tMax * axis[c], 0.f, 255.f);
+			}
+			return endpoints;
+		}
+
+		//BC1: two RGB565 endpoints and 2 bit indices into the palette spanned by them
+
+		uint16_t pack565(const float color[4]) {
+			uint32_t r = static_cast<uint32_t>(std::lround(color[0] * 31.f / 255.f));
+			uint32_t g = static_cast<uint32_t>(std::lround(color[1] * 63.f / 255.f));
+			uint32_t b = static_cast<uint32_t>(std::lround(color[2] * 31.f / 255.f));
+			return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+		}
+
+		std::array<int, 3> unpack565(uint16_t color) {
+			int r = (color >> 11) & 31;
+			int g = (color >> 5) & 63;
+			int b = color & 31;
+			return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+		}
+
+		//four colors when c0 > c1, otherwise three and transparent black. the color half of BC3 always has four
+		std::array<std::array<int, 4>, 4> bc1Palette(uint16_t c0, uint16_t c1, bool fourColors) {
+			std::array<int, 3> a = unpack565(c0);
+			std::array<int, 3> b = unpack565(c1);
+			std::array<std::array<int, 4>, 4> palette{};
+			fourColors = fourColors || c0 > c1;
+			for (int c = 0; c < 3; c++) {
+				palette[0][c] = a[c];
+				palette[1][c] = b[c];
+				if (fourColors) {
+					palette[2][c] = (2 * a[c] + b[c]) / 3;
+					palette[3][c] = (a[c] + 2 * b[c]) / 3;
+				}
+				else {
+					palette[2][c] = (a[c] + b[c]) / 2;
+					palette[3][c] = 0;
+				}
+			}
+			palette[0][3] = palette[1][3] = palette[2][3] = 255;
+			palette[3][3] = fourColors ? 255 : 0;
+			return palette;
+		}
+
+		//always the four color mode, BC1 here is opaque
+		void encodeBc1Block(const Block& block, uint8_t* out) {
+			Endpoints endpoints = fitLine(block, 3);
+			uint16_t c0 = pack565(endpoints.hi);
+			uint16_t c1 = pack565(endpoints.lo);
+			if (c0 < c1) std::swap(c0, c1);
+
+			uint32_t indices = 0;
+			if (c0 != c1) {
+				auto palette = bc1Palette(c0, c1, true);
+				for (uint32_t i = 0; i < 16; i++) {
+					uint32_t best = 0;
+					int bestError = std::numeric_limits<int>::max();
+					for (uint32_t j = 0; j < 4; j++) {
+						int error = squared(block[i][0] - palette[j][0]) + squared(block[i][1] - palette[j][1]) + squared(block[i][2] - palette[j][2]);
+						if (error < bestError) {
+							bestError = error;
+							best = j;
+						}
+					}
+					indices |= best << (2 * i);
+				}
+			}
+			writeLittleEndian64(out, c0 | (static_cast<uint64_t>(c1) << 16) | (static_cast<uint64_t>(indices) << 32), 8);
+		}
+
+		void decodeBc1Block(const uint8_t* in, bool fourColors, Block& block) {
+			uint64_t bits = readLittleEndian64(in);
+			auto palette = bc1Palette(static_cast<uint16_t>(bits), static_cast<uint16_t>(bits >> 16), fourColors);
+			for (uint32_t i = 0; i < 16; i++) {
+				const auto& color = palette[(bits >> (32 + 2 * i)) & 3];
+				for (int c = 0; c < 4; c++) block[i][c] = static_cast<uint8_t>(color[c]);
+			}
+		}
+
+		//BC4: one channel, two 8 bit endpoints and 3 bit indices. it is the alpha of BC3 and both channels of BC5
+
+		std::array<int, 8> bc4Palette(int a0, int a1) {
+			std::array<int, 8> palette{ a0, a1 };
+			if (a0 > a1) {
+				for (int k = 2; k < 8; k++) palette[k] = ((8 - k) * a0 + (k - 1) * a1) / 7;
+			}
+			else {
+				for (int k = 2; k < 6; k++) palette[k] = ((6 - k) * a0 + (k - 1) * a1) / 5;
+				palette[6] = 0;
+				palette[7] = 255;
+			}
+			return palette;
+		}
+
+		void encodeBc4Block(const Block& block, int channel, uint8_t* out) {
+			int lo = 255, hi = 0;
+			for (const auto& pixel : block) {
+				lo = std::min(lo, static_cast<int>(pixel[channel]));
+				hi = std::max(hi, static_cast<int>(pixel[channel]));
+			}
+
+			uint64_t bits = static_cast<uint64_t>(hi) | (static_cast<uint64_t>(lo) << 8);
+			if (hi != lo) {
+				auto palette = bc4Palette(hi, lo);
+				for (uint32_t i = 0; i < 16; i++) {
+					uint64_t best = 0;
+					int bestError = std::numeric_limits<int>::max();
+					for (uint64_t j = 0; j < 8; j++) {
+						int error = std::abs(block[i][channel] - palette[j]);
+						if (error < bestError) {
+							bestError = error;
+							best = j;
+						}
+					}
+					bits |= best << (16 + 3 * i);
+				}
+			}
+			writeLittleEndian64(out, bits, 8);
+		}
+
+		void decodeBc4Block(const uint8_t* in, int channel, Block& block) {
+			uint64_t bits = readLittleEndian64(in);
+			auto palette = bc4Palette(static_cast<int>(bits & 0xff), static_cast<int>((bits >> 8) & 0xff));
+			for (uint32_t i = 0; i < 16; i++) {
+				block[i][channel] = static_cast<uint8_t>(palette[(bits >> (16 + 3 * i)) & 7]);
+			}
+		}
+
+		//BC7 mode 6: one subset, RGBA endpoints of 7 bits plus a p-bit each and 4 bit indices
+
+		constexpr std::array<int, 16> BC7_WEIGHTS4{ 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		class BitWriter {
+		public:
+			explicit BitWriter(uint8_t* out) : out{ out } { std::memset(out, 0, 16); }
+			void write(uint32_t value, int bits) {
+				for (int b = 0; b < bits; b++, position++) {
+					if ((value >> b) & 1) out[position / 8] |= static_cast<uint8_t>(1 << (position % 8));
+				}
+			}
+		private:
+			uint8_t* out;
+			int position = 0;
+		};
+
+		class BitReader {
+		public:
+			explicit BitReader(const uint8_t* in) : in{ in } {}
+			uint32_t read(int bits) {
+				uint32_t value = 0;
+				for (int b = 0; b < bits; b++, position++) {
+					value |= static_cast<uint32_t>((in[position / 8] >> (position % 8)) & 1) << b;
+				}
+				return value;
+			}
+		private:
+			const uint8_t* in;
+			int position = 0;
+		};
+
+		int bc7Interpolate(int e0, int e1, int index) {
+			return ((64 - BC7_WEIGHTS4[index]) * e0 + BC7_WEIGHTS4[index] * e1 + 32) >> 6;
+		}
+
+		void encodeBc7Block(const Block& block, uint8_t* out) {
+			Endpoints endpoints = fitLine(block, 4);
+
+			//every p-bit pair is tried, the endpoint is (7 bit value << 1) | p-bit
+			int bestError = std::numeric_limits<int>::max();
+			std::array<int, 4> bestQ0{}, bestQ1{};
+			int bestP0 = 0, bestP1 = 0;
+			std::array<int, 16> bestIndices{};
+			for (int p0 = 0; p0 < 2; p0++) {
+				for (int p1 = 0; p1 < 2; p1++) {
+					std::array<int, 4> q0{}, q1{}, e0{}, e1{};
+					for (int c = 0; c < 4; c++) {
+						q0[c] = std::clamp(static_cast<int>(std::lround((endpoints.lo[c] - p0) / 2.f)), 0, 127);
+						q1[c] = std::clamp(static_cast<int>(std::lround((endpoints.hi[c] - p1) / 2.f)), 0, 127);
+						e0[c] = (q0[c] << 1) | p0;
+						e1[c] = (q1[c] << 1) | p1;
+					}
+					std::array<std::array<int, 4>, 16> palette{};
+					for (int k = 0; k < 16; k++) {
+						for (int c = 0; c < 4; c++) palette[k][c] = bc7Interpolate(e0[c], e1[c], k);
+					}
+
+					int error = 0;
+					std::array<int, 16> indices{};
+					for (uint32_t i = 0; i < 16; i++) {
+						int pixelError = std::numeric_limits<int>::max();
+						for (int k = 0; k < 16; k++) {
+							int e = 0;
+							for (int c = 0; c < 4; c++) e += squared(block[i][c] - palette[k][c]);
+							if (e < pixelError) {
+								pixelError = e;
+								indices[i] = k;
+							}
+						}
+						error += pixelError;
+					}
+					if (error < bestError) {
+						bestError = error;
+						bestQ0 = q0;
+						bestQ1 = q1;
+						bestP0 = p0;
+						bestP1 = p1;
+						bestIndices = indices;
+					}
+				}
+			}
+
+			//the first index is stored without its top bit, so it has to be below 8
+			if (bestIndices[0] >= 8) {
+				std::swap(bestQ0, bestQ1);
+				std::swap(bestP0, bestP1);
+				for (int& index : bestIndices) index = 15 - index;
+			}
+
+			BitWriter writer{ out };
+			writer.write(1 << 6, 7);
+			for (int c = 0; c < 4; c++) {
+				writer.write(bestQ0[c], 7);
+				writer.write(bestQ1[c], 7);
+			}
+			writer.write(bestP0, 1);
+			writer.write(bestP1, 1);
+			writer.write(bestIndices[0], 3);
+			for (int i = 1; i < 16; i++) writer.write(bestIndices[i], 4);
+		}
+
+		void decodeBc7Block(const uint8_t* in, Block& block) {
+			int mode = 0;
+			while (mode < 8 && ((in[0] >> mode) & 1) == 0) mode++;
+			if (mode != 6) {
+				throw std::runtime_error("BC7 mode " + std::to_string(mode) + " blocks can not be transcoded!");
+			}
+
+			BitReader reader{ in };
+			reader.read(7);
+			std::array<int, 4> e0{}, e1{};
+			for (int c = 0; c < 4; c++) {
+				e0[c] = static_cast<int>(reader.read(7)) << 1;
+				e1[c] = static_cast<int>(reader.read(7)) << 1;
+			}
+			int p0 = static_cast<int>(reader.read(1));
+			int p1 = static_cast<int>(reader.read(1));
+			for (int c = 0; c < 4; c++) {
+				e0[c] |= p0;
+				e1[c] |= p1;
+			}
+			for (uint32_t i = 0; i < 16; i++) {
+				int index = static_cast<int>(reader.read(i == 0 ? 3 : 4));
+				for (int c = 0; c < 4; c++) block[i][c] = static_cast<uint8_t>(bc7Interpolate(e0[c], e1[c], index));
+			}
+		}
+
+		//ETC2 RGB: two sub-blocks of 2x4 (or 4x2 when flipped), each with a base color and one of eight modifier
+		//tables. texels are indexed column major, x * 4 + y
+
+		constexpr int ETC_MODIFIERS[8][4]{
+			{ 2, 8, -2, -8 },
+			{ 5, 17, -5, -17 },
+			{ 9, 29, -9, -29 },
+			{ 13, 42, -13, -42 },
+			{ 18, 60, -18, -60 },
+			{ 24, 80, -24, -80 },
+			{ 33, 106, -33, -106 },
+			{ 47, 183, -47, -183 },
+		};
+
+		//the texels of sub-block 0 or 1 as row major block indices
+		std::array<uint32_t, 8> etcSubblock(bool flip, int subblock) {
+			std::array<uint32_t, 8> texels{};
+			int n = 0;
+			for (uint32_t y = 0; y < 4; y++) {
+				for (uint32_t x = 0; x < 4; x++) {
+					bool second = flip ? y >= 2 : x >= 2;
+					if (static_cast<int>(second) == subblock) texels[n++] = y * 4 + x;
+				}
+			}
+			return texels;
+		}
+
+		struct EtcSubblockFit {
+			int table = 0;
+			int error = std::numeric_limits<int>::max();
+			std::array<uint32_t, 8> modifiers{}; // the 2 bit index per texel of the sub-block
+		};
+
+		EtcSubblockFit fitEtcSubblock(const Block& block, const std::array<uint32_t, 8>& texels, const std::array<int, 3>& base) {
+			EtcSubblockFit best{};
+			for (int table = 0; table < 8; table++) {
+				EtcSubblockFit fit{};
+				fit.table = table;
+				fit.error = 0;
+				for (int t = 0; t < 8; t++) {
+					int texelError = std::numeric_limits<int>::max();
+					for (uint32_t m = 0; m < 4; m++) {
+						int e = 0;
+						for (int c = 0; c < 3; c++) {
+							e += squared(block[texels[t]][c] - clampByte(base[c] + ETC_MODIFIERS[table][m]));
+						}
+						if (e < texelError) {
+							texelError = e;
+							fit.modifiers[t] = m;
+						}
+					}
+					fit.error += texelError;
+				}
+				if (fit.error < best.error) best = fit;
+			}
+			return best;
+		}
+
+		int expand4(int value) { return (value << 4) | value; }
+		int expand5(int value) { return (value << 3) | (value >> 2); }
+
+		void encodeEtc2RgbBlock(const Block& block, uint8_t* out) {
+			int bestError = std::numeric_limits<int>::max();
+			uint64_t bestBits = 0;
+			for (int flip = 0; flip < 2; flip++) {
+				std::array<uint32_t, 8> texels[2]{ etcSubblock(flip != 0, 0), etcSubblock(flip != 0, 1) };
+				float average[2][3]{};
+				for (int s = 0; s < 2; s++) {
+					for (uint32_t texel : texels[s]) {
+						for (int c = 0; c < 3; c++) average[s][c] += block[texel][c] / 8.f;
+					}
+				}
+
+				//differential mode keeps 5 bits per base, but only while the second base is within -4..3 of the first.
+				//outside that range ETC2 reads the block as one of its T, H or planar modes
+				for (int differential = 0; differential < 2; differential++) {
+					int quantized[2][3]{};
+					std::array<int, 3> bases[2]{};
+					bool fits = true;
+					for (int s = 0; s < 2; s++) {
+						for (int c = 0; c < 3; c++) {
+							int levels = differential ? 31 : 15;
+							quantized[s][c] = static_cast<int>(std::lround(average[s][c] * levels / 255.f));
+							bases[s][c] = differential ? expand5(quantized[s][c]) : expand4(quantized[s][c]);
+						}
+					}
+					if (differential) {
+						for (int c = 0; c < 3; c++) {
+							int delta = quantized[1][c] - quantized[0][c];
+							fits = fits && delta >= -4 && delta <= 3;
+						}
+					}
+					if (!fits) continue;
+
+					EtcSubblockFit subblockFits[2]{
+						fitEtcSubblock(block, texels[0], bases[0]),
+						fitEtcSubblock(block, texels[1], bases[1]) };
+					int error = subblockFits[0].error + subblockFits[1].error;
+					if (error >= bestError) continue;
+					bestError = error;
+
+					uint64_t high = 0;
+					for (int c = 0; c < 3; c++) {
+						int shift = 24 - 8 * c;
+						if (differential) {
+							high |= static_cast<uint64_t>(quantized[0][c]) << (shift + 3);
+							high |= static_cast<uint64_t>((quantized[1][c] - quantized[0][c]) & 7) << shift;
+						}
+						else {
+							high |= static_cast<uint64_t>(quantized[0][c]) << (shift + 4);
+							high |= static_cast<uint64_t>(quantized[1][c]) << shift;
+						}
+					}
+					high |= static_cast<uint64_t>(subblockFits[0].table) << 5;
+					high |= static_cast<uint64_t>(subblockFits[1].table) << 2;
+					high |= static_cast<uint64_t>(differential) << 1;
+					high |= static_cast<uint64_t>(flip);
+
+					uint64_t low = 0;
+					for (int s = 0; s < 2; s++) {
+						for (int t = 0; t < 8; t++) {
+							uint32_t texel = texels[s][t];
+							uint32_t k = (texel % 4) * 4 + texel / 4;
+							uint32_t m = subblockFits[s].modifiers[t];
+							low |= static_cast<uint64_t>(m >> 1) << (16 + k);
+							low |= static_cast<uint64_t>(m & 1) << k;
+						}
+					}
+					bestBits = (high << 32) | low;
+				}
+			}
+			writeBigEndian64(out, bestBits);
+		}
+
+		void decodeEtc2RgbBlock(const uint8_t* in, Block& block) {
+			uint64_t bits = readBigEndian64(in);
+			uint32_t high = static_cast<uint32_t>(bits >> 32);
+			bool differential = (high >> 1) & 1;
+			bool flip = high & 1;
+			int tables[2]{ static_cast<int>((high >> 5) & 7), static_cast<int>((high >> 2) & 7) };
+
+			std::array<int, 3> bases[2]{};
+			for (int c = 0; c < 3; c++) {
+				int shift = 24 - 8 * c;
+				if (differential) {
+					int first = (high >> (shift + 3)) & 31;
+					int delta = (high >> shift) & 7;
+					if (delta >= 4) delta -= 8;
+					int second = first + delta;
+					if (second < 0 || second > 31) {
+						throw std::runtime_error("ETC2 T, H and planar blocks can not be transcoded!");
+					}
+					bases[0][c] = expand5(first);
+					bases[1][c] = expand5(second);
+				}
+				else {
+					bases[0][c] = expand4((high >> (shift + 4)) & 15);
+					bases[1][c] = expand4((high >> shift) & 15);
+				}
+			}
+
+			for (int s = 0; s < 2; s++) {
+				for (uint32_t texel : etcSubblock(flip, s)) {
+					uint32_t k = (texel % 4) * 4 + texel / 4;
+					uint32_t m = static_cast<uint32_t>(((bits >> (16 + k)) & 1) << 1 | ((bits >> k) & 1));
+					for (int c = 0; c < 3; c++) block[texel][c] = clampByte(bases[s][c] + ETC_MODIFIERS[tables[s]][m]);
+					block[texel][3] = 255;
+				}
+			}
+		}
+
+		//EAC: one channel, a base, a multiplier and one of sixteen modifier tables with 3 bit indices. the alpha of
+		//ETC2_RGBA8 is 8 bit, the channels of EAC_RG11 are decoded to 11 bits
+
+		constexpr int EAC_MODIFIERS[16][8]{
+			{ -3, -6, -9, -15, 2, 5, 8, 14 },
+			{ -3, -7, -10, -13, 2, 6, 9, 12 },
+			{ -2, -5, -8, -13, 1, 4, 7, 12 },
+			{ -2, -4, -6, -13, 1, 3, 5, 12 },
+			{ -3, -6, -8, -12, 2, 5, 7, 11 },
+			{ -3, -7, -9, -11, 2, 6, 8, 10 },
+			{ -4, -7, -8, -11, 3, 6, 7, 10 },
+			{ -3, -5, -8, -11, 2, 4, 7, 10 },
+			{ -2, -6, -8, -10, 1, 5, 7, 9 },
+			{ -2, -5, -8, -10, 1, 4, 7, 9 },
+			{ -2, -4, -8, -10, 1, 3, 7, 9 },
+			{ -2, -5, -7, -10, 1, 4, 6, 9 },
+			{ -3, -4, -7, -10, 2, 3, 6, 9 },
+			{ -1, -2, -3, -10, 0, 1, 2, 9 },
+			{ -4, -6, -8, -9, 3, 5, 7, 8 },
+			{ -3, -5, -7, -9, 2, 4, 6, 8 },
+		};
+
+		//the decoded value, 8 bit for alpha and 11 bit for RG11
+		int eacValue(int base, int multiplier, int table, int index, bool elevenBit) {
+			int modifier = EAC_MODIFIERS[table][index];
+			if (!elevenBit) return std::clamp(base + modifier * multiplier, 0, 255);
+			int value = multiplier == 0 ? base * 8 + 4 + modifier : base * 8 + 4 + modifier * multiplier * 8;
+			return std::clamp(value, 0, 2047);
+		}
+
+		void encodeEacBlock(const Block& block, int channel, bool elevenBit, uint8_t* out) {
+			int lo = 255, hi = 0;
+			for (const auto& pixel : block) {
+				lo = std::min(lo, static_cast<int>(pixel[channel]));
+				hi = std::max(hi, static_cast<int>(pixel[channel]));
+			}
+			//the error is measured where the values are decoded to
+			float scale = elevenBit ? 2047.f / 255.f : 1.f;
+
+			float bestError = std::numeric_limits<float>::max();
+			uint64_t bestBits = 0;
+			for (int table = 0; table < 16; table++) {
+				const int* modifiers = EAC_MODIFIERS[table];
+				int spread = modifiers[7] - modifiers[3];
+				int guess = std::max(1, static_cast<int>(std::lround(static_cast<float>(hi - lo) / spread)));
+				for (int multiplier = std::max(1, guess - 1); multiplier <= std::min(15, guess + 1); multiplier++) {
+					int center = static_cast<int>(std::lround((hi + lo) / 2.f - (modifiers[7] + modifiers[3]) * multiplier / 2.f));
+					for (int base = std::max(0, center - 1); base <= std::min(255, center + 1); base++) {
+						float error = 0.f;
+						uint64_t indices = 0;
+						for (uint32_t i = 0; i < 16; i++) {
+							float target = block[i][channel] * scale;
+							float texelError = std::numeric_limits<float>::max();
+							uint64_t bestIndex = 0;
+							for (int index = 0; index < 8; index++) {
+								float e = std::abs(eacValue(base, multiplier, table, index, elevenBit) - target);
+								if (e < texelError) {
+									texelError = e;
+									bestIndex = static_cast<uint64_t>(index);
+								}
+							}
+							error += texelError * texelError;
+							uint32_t k = (i % 4) * 4 + i / 4;
+							indices |= bestIndex << (45 - 3 * k);
+						}
+						if (error < bestError) {
+							bestError = error;
+							bestBits = (static_cast<uint64_t>(base) << 56) | (static_cast<uint64_t>(multiplier) << 52) |
+								(static_cast<uint64_t>(table) << 48) | indices;
+						}
+					}
+				}
+			}
+			writeBigEndian64(out, bestBits);
+		}
+
+		void decodeEacBlock(const uint8_t* in, int channel, bool elevenBit, Block& block) {
+			uint64_t bits = readBigEndian64(in);
+			int base = static_cast<int>(bits >> 56);
+			int multiplier = static_cast<int>((bits >> 52) & 15);
+			int table = static_cast<int>((bits >> 48) & 15);
+			for (uint32_t i = 0; i < 16; i++) {
+				uint32_t k = (i % 4) * 4 + i / 4;
+				int value = eacValue(base, multiplier, table, static_cast<int>((bits >> (45 - 3 * k)) & 7), elevenBit);
+				block[i][channel] = static_cast<uint8_t>(elevenBit ? (value * 255 + 1023) / 2047 : value);
+			}
+		}
+	}
+
+	const char* blockFormatName(BlockFormat format) {
+		switch (format) {
+		case BlockFormat::RGBA8: return "rgba8";
+		case BlockFormat::BC1: return "bc1";
+		case BlockFormat::BC3: return "bc3";
+		case BlockFormat::BC5: return "bc5";
+		case BlockFormat::BC7: return "bc7";
+		case BlockFormat::ETC2_RGB8: return "etc2_rgb8";
+		case BlockFormat::ETC2_RGBA8: return "etc2_rgba8";
+		case BlockFormat::EAC_RG11: return "eac_rg11";
+		}
+		return "unknown";
+	}
+
+	bool parseBlockFormat(const std::string& name, BlockFormat& format) {
+		for (uint32_t i = 0; i <= static_cast<uint32_t>(BlockFormat::EAC_RG11); i++) {
+			if (name == blockFormatName(static_cast<BlockFormat>(i))) {
+				format = static_cast<BlockFormat>(i);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	BlockFormat etc2Counterpart(BlockFormat format) {
+		switch (format) {
+		case BlockFormat::BC1: return BlockFormat::ETC2_RGB8;
+		case BlockFormat::BC3:
+		case BlockFormat::BC7: return BlockFormat::ETC2_RGBA8;
+		case BlockFormat::BC5: return BlockFormat::EAC_RG11;
+		default: return format;
+		}
+	}
+
+	bool isTwoChannel(BlockFormat format) {
+		return format == BlockFormat::BC5 || format == BlockFormat::EAC_RG11;
+	}
+
+	size_t mipDataSize(BlockFormat format, uint32_t width, uint32_t height) {
+		if (format == BlockFormat::RGBA8) {
+			return static_cast<size_t>(width) * height * 4;
+		}
+		size_t blocksX = (width + 3) / 4;
+		size_t blocksY = (height + 3) / 4;
+		return blocksX * blocksY * blockBytes(format);
+	}
+
+	std::vector<uint8_t> encodeBlocks(BlockFormat format, uint32_t width, uint32_t height, const uint8_t* rgba) {
+		if (format == BlockFormat::RGBA8) {
+			return std::vector<uint8_t>(rgba, rgba + mipDataSize(format, width, height));
+		}
+
+		std::vector<uint8_t> blocks(mipDataSize(format, width, height));
+		uint32_t blocksX = (width + 3) / 4;
+		uint32_t blocksY = (height + 3) / 4;
+		uint8_t* out = blocks.data();
+		for (uint32_t by = 0; by < blocksY; by++) {
+			for (uint32_t bx = 0; bx < blocksX; bx++) {
+				Block block = fetchBlock(rgba, width, height, bx, by);
+				switch (format) {
+				case BlockFormat::BC1:
+					encodeBc1Block(block, out);
+					break;
+				case BlockFormat::BC3:
+					encodeBc4Block(block, 3, out);
+					encodeBc1Block(block, out + 8);
+					break;
+				case BlockFormat::BC5:
+					encodeBc4Block(block, 0, out);
+					encodeBc4Block(block, 1, out + 8);
+					break;
+				case BlockFormat::BC7:
+					encodeBc7Block(block, out);
+					break;
+				case BlockFormat::ETC2_RGB8:
+					encodeEtc2RgbBlock(block, out);
+					break;
+				case BlockFormat::ETC2_RGBA8:
+					encodeEacBlock(block, 3, false, out);
+					encodeEtc2RgbBlock(block, out + 8);
+					break;
+				case BlockFormat::EAC_RG11:
+					encodeEacBlock(block, 0, true, out);
+					encodeEacBlock(block, 1, true, out + 8);
+					break;
+				default:
+					throw std::runtime_error("unknown block format!");
+				}
+				out += blockBytes(format);
+			}
+		}
+		return blocks;
+	}
+
+	std::vector<uint8_t> decodeBlocks(BlockFormat format, uint32_t width, uint32_t height, const uint8_t* blocks) {
+		if (format == BlockFormat::RGBA8) {
+			return std::vector<uint8_t>(blocks, blocks + mipDataSize(format, width, height));
+		}
+
+		std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+		uint32_t blocksX = (width + 3) / 4;
+		uint32_t blocksY = (height + 3) / 4;
+		const uint8_t* in = blocks;
+		for (uint32_t by = 0; by < blocksY; by++) {
+			for (uint32_t bx = 0; bx < blocksX; bx++) {
+				Block block{};
+				switch (format) {
+				case BlockFormat::BC1:
+					decodeBc1Block(in, false, block);
+					break;
+				case BlockFormat::BC3:
+					decodeBc1Block(in + 8, true, block);
+					decodeBc4Block(in, 3, block);
+					break;
+				case BlockFormat::BC5:
+					decodeBc4Block(in, 0, block);
+					decodeBc4Block(in + 8, 1, block);
+					break;
+				case BlockFormat::BC7:
+					decodeBc7Block(in, block);
+					break;
+				case BlockFormat::ETC2_RGB8:
+					decodeEtc2RgbBlock(in, block);
+					break;
+				case BlockFormat::ETC2_RGBA8:
+					decodeEtc2RgbBlock(in + 8, block);
+					decodeEacBlock(in, 3, false, block);
+					break;
+				case BlockFormat::EAC_RG11:
+					decodeEacBlock(in, 0, true, block);
+					decodeEacBlock(in + 8, 1, true, block);
+					break;
+				default:
+					throw std::runtime_error("unknown block format!");
+				}
+				if (isTwoChannel(format)) {
+					for (auto& pixel : block) {
+						pixel[2] = 0;
+						pixel[3] = 255;
+					}
+				}
+				storeBlock(block, rgba.data(), width, height, bx, by);
+				in += blockBytes(format);
+			}
+		}
+		return rgba;
+	}
+
+}//namespace ikE
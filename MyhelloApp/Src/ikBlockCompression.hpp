@@ -0,0 +1,45 @@
+#ifndef IKBLOCKCOMPRESSION_HPP
+#define IKBLOCKCOMPRESSION_HPP
+
+//std
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+namespace ikE {
+	/*texel layouts a texture container can hold. the BC formats are what desktop GPUs sample, the ETC2/EAC ones are
+	  their counterparts on mobile GPUs, RGBA8 is uncompressed. BC5 and EAC_RG11 store the red and green channels only,
+	  e.g. for normal maps. the values are written to disk, never renumber them*/
+	enum class BlockFormat : uint32_t {
+		RGBA8 = 0,
+		BC1 = 1, // RGB, 4 bits per texel
+		BC3 = 2, // RGBA, 8 bits per texel
+		BC5 = 3, // RG, 8 bits per texel
+		BC7 = 4, // RGBA, 8 bits per texel
+		ETC2_RGB8 = 5, // RGB, 4 bits per texel
+		ETC2_RGBA8 = 6, // RGBA, 8 bits per texel
+		EAC_RG11 = 7, // RG, 8 bits per texel
+	};
+
+	const char* blockFormatName(BlockFormat format);
+	//accepts the names blockFormatName returns in lower case, e.g. "bc7" or "etc2_rgba8"
+	bool parseBlockFormat(const std::string& name, BlockFormat& format);
+	//the ETC2/EAC format holding the same channels as a BC format, RGBA8 stays RGBA8
+	BlockFormat etc2Counterpart(BlockFormat format);
+	bool isTwoChannel(BlockFormat format);
+
+	//bytes of one mip level, block formats round the size up to whole 4x4 blocks
+	size_t mipDataSize(BlockFormat format, uint32_t width, uint32_t height);
+
+	/*encodes tightly packed RGBA8 rows into format. the encoders aim at being simple and deterministic rather than at
+	  the best quality: BC1 and BC7 fit a line through each block's colors, BC7 uses mode 6 only, ETC2 writes the
+	  individual and differential modes it shares with ETC1 and EAC searches a few bases and multipliers per table*/
+	std::vector<uint8_t> encodeBlocks(BlockFormat format, uint32_t width, uint32_t height, const uint8_t* rgba);
+
+	/*decodes blocks back to RGBA8, used when a device can not sample any format a container holds.
+	  everything the encoders write is decoded, BC7 blocks of modes other than 6 and the ETC2 T, H and planar modes,
+	  which other encoders may write, throw. two channel formats decode to (r, g, 0, 255)*/
+	std::vector<uint8_t> decodeBlocks(BlockFormat format, uint32_t width, uint32_t height, const uint8_t* blocks);
+
+} //namepace
+#endif //header guard
@@ -26,9 +26,13 @@ namespace ikE {
 
 		const glm::mat4& getProjection() const { return projectionMatrix; }
 		const glm::mat4& getView() const { return viewMatrix; }
+		float getNear() const { return nearPlane; }
+		float getFar() const { return farPlane; }
 
 	private:
 		glm::mat4 projectionMatrix{ 1.f };
+		float nearPlane{ 0.f };
+		float farPlane{ 1.f };
 		glm::mat4 viewMatrix{ 1.f };
 	};
 
@@ -0,0 +1,92 @@
+#include "ikCommandPools.hpp"
+
+//std
+#include <cassert>
+#include <stdexcept>
+
+namespace ikE {
+
+	IkFrameCommandPools::IkFrameCommandPools(IkeDeviceEngine& device, uint32_t frameCount, uint32_t slotCount)
+		: ikeDevice{ device }, slotCount_{ slotCount } {
+		frames.resize(frameCount);
+		for (auto& frame : frames) {
+			frame.primaryPool = createPool();
+
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandPool = frame.primaryPool;
+			allocInfo.commandBufferCount = 1;
+			if (vkAllocateCommandBuffers(ikeDevice.device(), &allocInfo, &frame.primary) != VK_SUCCESS) {
+				throw std::runtime_error("failed to allocate command buffers");
+			}
+
+			frame.slots.resize(slotCount);
+			for (auto& slot : frame.slots) {
+				slot.commandPool = createPool();
+			}
+		}
+	}
+
+	IkFrameCommandPools::~IkFrameCommandPools() {
+		//destroying a pool frees every command buffer allocated from it
+		for (auto& frame : frames) {
+			vkDestroyCommandPool(ikeDevice.device(), frame.primaryPool, nullptr);
+			for (auto& slot : frame.slots) {
+				vkDestroyCommandPool(ikeDevice.device(), slot.commandPool, nullptr);
+			}
+		}
+	}
+
+	VkCommandPool IkFrameCommandPools::createPool() {
+		QueueFamilyIndices queueFamilyIndices = ikeDevice.findPhysicalQueueFamilies();
+
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily;
+		//buffers only live for one frame and are reset together with the pool, so no RESET_COMMAND_BUFFER bit
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+		VkCommandPool commandPool;
+		if (vkCreateCommandPool(ikeDevice.device(), &poolInfo, nullptr, &commandPool) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create frame command pool!");
+		}
+		return commandPool;
+	}
+
+	void IkFrameCommandPools::resetFrame(int frameIndex) {
+		FramePools& frame = frames[frameIndex];
+		//the primary is begun every frame, so its pool is always reset
+		if (vkResetCommandPool(ikeDevice.device(), frame.primaryPool, 0) != VK_SUCCESS) {
+			throw std::runtime_error("failed to reset frame command pool!");
+		}
+		for (auto& slot : frame.slots) {
+			if (slot.nextFree == 0) continue;
+			if (vkResetCommandPool(ikeDevice.device(), slot.commandPool, 0) != VK_SUCCESS) {
+				throw std::runtime_error("failed to reset secondary command pool!");
+			}
+			slot.nextFree = 0;
+		}
+	}
+
+	VkCommandBuffer IkFrameCommandPools::acquire(int frameIndex, uint32_t slot) {
+		assert(slot < slotCount_ && "Recording slot out of range");
+		auto& slotPool = frames[frameIndex].slots[slot];
+
+		if (slotPool.nextFree == slotPool.commandBuffers.size()) {
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+			allocInfo.commandPool = slotPool.commandPool;
+			allocInfo.commandBufferCount = 1;
+
+			VkCommandBuffer commandBuffer;
+			if (vkAllocateCommandBuffers(ikeDevice.device(), &allocInfo, &commandBuffer) != VK_SUCCESS) {
+				throw std::runtime_error("failed to allocate secondary command buffer!");
+			}
+			slotPool.commandBuffers.push_back(commandBuffer);
+		}
+		return slotPool.commandBuffers[slotPool.nextFree++];
+	}
+
+}//namespace
@@ -0,0 +1,51 @@
+#ifndef IKCOMMANDPOOLS_HPP
+#define IKCOMMANDPOOLS_HPP
+
+#include "ikDeviceEngine.hpp"
+
+//std
+#include <vector>
+
+namespace ikE {
+	/*IkFrameCommandPools keeps the command pools of every frame in flight, one for the frame's primary command buffer
+	  and one per recording slot for secondaries. a command pool must never be used from two threads at once, so every
+	  worker records from the pool of its own slot. all pools are TRANSIENT and command buffers are never reset or
+	  freed one by one, resetFrame() resets every pool of a frame in bulk once the GPU finished it. primary() then is
+	  ready to begin again and acquire() hands the already allocated secondaries out again, only allocating when a slot
+	  runs dry*/
+	class IkFrameCommandPools {
+	public:
+		IkFrameCommandPools(IkeDeviceEngine& device, uint32_t frameCount, uint32_t slotCount);
+		~IkFrameCommandPools();
+
+		IkFrameCommandPools(const IkFrameCommandPools&) = delete;
+		IkFrameCommandPools& operator =(const IkFrameCommandPools&) = delete;
+
+		uint32_t slotCount() const { return slotCount_; }
+
+		void resetFrame(int frameIndex);
+		VkCommandBuffer primary(int frameIndex) const { return frames[frameIndex].primary; }
+		VkCommandBuffer acquire(int frameIndex, uint32_t slot);
+
+	private:
+		struct SlotPool {
+			VkCommandPool commandPool = VK_NULL_HANDLE;
+			std::vector<VkCommandBuffer> commandBuffers;
+			size_t nextFree = 0;
+		};
+
+		struct FramePools {
+			VkCommandPool primaryPool = VK_NULL_HANDLE;
+			VkCommandBuffer primary = VK_NULL_HANDLE;
+			std::vector<SlotPool> slots;
+		};
+
+		VkCommandPool createPool();
+
+		IkeDeviceEngine& ikeDevice;
+		uint32_t slotCount_;
+		std::vector<FramePools> frames;
+	};
+
+}//namespace
+#endif //header guard
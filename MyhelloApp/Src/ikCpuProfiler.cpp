@@ -0,0 +1,117 @@
+#include "ikCpuProfiler.hpp"
+
+//std
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+namespace ikE {
+
+	namespace {
+		struct ZoneEvent {
+			const char* name;
+			uint64_t startNs;
+			uint64_t endNs;
+		};
+
+		//written by its own thread only, writeIndex is published after the event so a reader never sees a torn one
+		//unless the writer laps it
+		struct ThreadBuffer {
+			uint32_t threadId;
+			const char* threadName = nullptr;
+			std::atomic<uint64_t> writeIndex{ 0 };
+			std::array<ZoneEvent, IkCpuProfiler::EVENTS_PER_THREAD> events;
+		};
+
+		struct Registry {
+			std::mutex mutex;
+			std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+			std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+		};
+
+		//leaked on purpose, worker threads may still record while static destructors run
+		Registry& registry() {
+			static Registry* instance = new Registry();
+			return *instance;
+		}
+
+		ThreadBuffer& threadBuffer() {
+			thread_local ThreadBuffer* buffer = nullptr;
+			if (buffer == nullptr) {
+				Registry& reg = registry();
+				std::lock_guard<std::mutex> lock{ reg.mutex };
+				reg.buffers.push_back(std::make_unique<ThreadBuffer>());
+				buffer = reg.buffers.back().get();
+				buffer->threadId = static_cast<uint32_t>(reg.buffers.size() - 1);
+			}
+			return *buffer;
+		}
+
+		void writeJsonString(std::ofstream& file, const char* text) {
+			file << '"';
+			for (const char* c = text; *c != '\0'; c++) {
+				if (*c == '"' || *c == '\\') file << '\\';
+				file << *c;
+			}
+			file << '"';
+		}
+	}
+
+	void IkCpuProfiler::setThreadName(const char* name) {
+		threadBuffer().threadName = name;
+	}
+
+	void IkCpuProfiler::record(const char* name, uint64_t startNs, uint64_t endNs) {
+		ThreadBuffer& buffer = threadBuffer();
+		uint64_t index = buffer.writeIndex.load(std::memory_order_relaxed);
+		buffer.events[index % EVENTS_PER_THREAD] = ZoneEvent{ name, startNs, endNs };
+		buffer.writeIndex.store(index + 1, std::memory_order_release);
+	}
+
+	uint64_t IkCpuProfiler::now() {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - registry().epoch).count());
+	}
+
+	void IkCpuProfiler::writeChromeTrace(const std::string& filepath) {
+		std::ofstream file{ filepath, std::ios::trunc };
+		if (!file.is_open()) {
+			throw std::runtime_error("failed to open file: " + filepath);
+		}
+
+		Registry& reg = registry();
+		std::lock_guard<std::mutex> lock{ reg.mutex };
+
+		//complete ("X") events in microseconds, plus one metadata event per named thread
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		bool first = true;
+		for (const auto& buffer : reg.buffers) {
+			if (buffer->threadName != nullptr) {
+				file << (first ? "" : ",") << "\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":0,\"tid\":" << buffer->threadId
+					<< ",\"args\":{\"name\":";
+				writeJsonString(file, buffer->threadName);
+				file << "}}";
+				first = false;
+			}
+
+			uint64_t end = buffer->writeIndex.load(std::memory_order_acquire);
+			uint64_t begin = end > EVENTS_PER_THREAD ? end - EVENTS_PER_THREAD : 0;
+			for (uint64_t i = begin; i < end; i++) {
+				const ZoneEvent& event = buffer->events[i % EVENTS_PER_THREAD];
+				file << (first ? "" : ",") << "\n{\"ph\":\"X\",\"name\":";
+				writeJsonString(file, event.name);
+				file << ",\"pid\":0,\"tid\":" << buffer->threadId
+					<< ",\"ts\":" << event.startNs / 1000 << '.' << (event.startNs % 1000) / 100
+					<< ",\"dur\":" << (event.endNs - event.startNs) / 1000 << '.' << ((event.endNs - event.startNs) % 1000) / 100
+					<< "}";
+				first = false;
+			}
+		}
+		file << "\n]}\n";
+	}
+
+}//namespace ikE
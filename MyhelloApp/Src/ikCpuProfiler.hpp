@@ -0,0 +1,59 @@
+#ifndef IKCPUPROFILER_HPP
+#define IKCPUPROFILER_HPP
+
+//std
+#include <cstdint>
+#include <string>
+
+//build with IK_CPU_PROFILER=0 to compile every zone out, the macros then expand to nothing
+#ifndef IK_CPU_PROFILER
+#define IK_CPU_PROFILER 1
+#endif
+
+#define IK_PROFILE_CONCAT_INNER(a, b) a##b
+#define IK_PROFILE_CONCAT(a, b) IK_PROFILE_CONCAT_INNER(a, b)
+
+#if IK_CPU_PROFILER
+//times the rest of the enclosing block, name must be a string literal (only the pointer is stored)
+#define IK_PROFILE_ZONE(name) ::ikE::IkCpuZone IK_PROFILE_CONCAT(ikProfileZone, __LINE__){ name }
+//names the calling thread in the trace, also a string literal
+#define IK_PROFILE_THREAD(name) ::ikE::IkCpuProfiler::setThreadName(name)
+#else
+#define IK_PROFILE_ZONE(name) ((void)0)
+#define IK_PROFILE_THREAD(name) ((void)0)
+#endif
+
+namespace ikE {
+	/*IkCpuProfiler collects the zones of IK_PROFILE_ZONE into one ring buffer per thread.
+	  a thread only ever writes its own buffer, so recording a zone is two clock reads and a store, with no lock.
+	  the buffer is registered under a mutex the first time a thread records, and is kept until exit so threads of a
+	  thread pool that was replaced still show up. once a buffer is full the oldest zones are overwritten.
+	  writeChromeTrace() exports every buffer as Chrome trace event JSON for chrome://tracing or Perfetto, it should
+	  run while no thread is recording, e.g. after the main loop*/
+	class IkCpuProfiler {
+	public:
+		static constexpr size_t EVENTS_PER_THREAD = 1 << 15;
+
+		static void setThreadName(const char* name);
+		static void record(const char* name, uint64_t startNs, uint64_t endNs);
+		//nanoseconds since the profiler was first used
+		static uint64_t now();
+
+		static void writeChromeTrace(const std::string& filepath);
+	};
+
+	class IkCpuZone {
+	public:
+		explicit IkCpuZone(const char* name) : name{ name }, startNs{ IkCpuProfiler::now() } {}
+		~IkCpuZone() { IkCpuProfiler::record(name, startNs, IkCpuProfiler::now()); }
+
+		IkCpuZone(const IkCpuZone&) = delete;
+		IkCpuZone& operator =(const IkCpuZone&) = delete;
+
+	private:
+		const char* name;
+		uint64_t startNs;
+	};
+
+} //namepace
+#endif //header guard
@@ -0,0 +1,34 @@
+#include "ikDeletionQueue.hpp"
+
+namespace ikE {
+
+	IkDeletionQueue::IkDeletionQueue(IkeDeviceEngine& device) : ikeDevice{ device } {}
+
+	IkDeletionQueue::~IkDeletionQueue() { flush(); }
+
+	void IkDeletionQueue::retire(std::function<void()> deleter) {
+		entries.push_back(Entry{ ikeDevice.lastSubmittedFrame() + 1, std::move(deleter) });
+	}
+
+	void IkDeletionQueue::collect() {
+		if (entries.empty()) return;
+
+		//frames are tagged in submit order, so the queue is sorted by frame
+		uint64_t completedFrame = ikeDevice.completedFrame();
+		while (!entries.empty() && entries.front().frame <= completedFrame) {
+			//popped before it runs, so a deleter that retires something else does not invalidate the front
+			std::function<void()> deleter = std::move(entries.front().deleter);
+			entries.pop_front();
+			deleter();
+		}
+	}
+
+	void IkDeletionQueue::flush() {
+		while (!entries.empty()) {
+			std::function<void()> deleter = std::move(entries.front().deleter);
+			entries.pop_front();
+			deleter();
+		}
+	}
+
+}//namespace ikE
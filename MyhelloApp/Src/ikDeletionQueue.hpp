@@ -0,0 +1,43 @@
+#ifndef IKDELETIONQUEUE_HPP
+#define IKDELETIONQUEUE_HPP
+
+#include "ikDeviceEngine.hpp"
+
+//std
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+namespace ikE {
+	/*IkDeletionQueue destroys vulkan objects that frames still in flight may be using, without waiting for the device.
+	  retire() takes a function that destroys them and tags it with the next frame number the device will submit, so
+	  the frame being recorded counts as well. collect() runs every entry whose frame the device's frame timeline
+	  semaphore has reached, the renderer calls it once per frame. entries run in the order they were retired*/
+	class IkDeletionQueue {
+	public:
+		explicit IkDeletionQueue(IkeDeviceEngine& device);
+		//runs whatever is still queued, the device must be idle by then
+		~IkDeletionQueue();
+
+		IkDeletionQueue(const IkDeletionQueue&) = delete;
+		IkDeletionQueue& operator =(const IkDeletionQueue&) = delete;
+
+		void retire(std::function<void()> deleter);
+		void collect();
+		//runs every entry now, only once the device is idle
+		void flush();
+
+		size_t size() const { return entries.size(); }
+
+	private:
+		struct Entry {
+			uint64_t frame;
+			std::function<void()> deleter;
+		};
+
+		IkeDeviceEngine& ikeDevice;
+		std::deque<Entry> entries;
+	};
+
+} //namepace
+#endif //header guard
@@ -1,7 +1,9 @@
 #include "ikDescriptors.hpp"
 
 // std
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <stdexcept>
 
 namespace ikE {
@@ -12,7 +14,8 @@ namespace ikE {
         uint32_t binding,
         VkDescriptorType descriptorType,
         VkShaderStageFlags stageFlags,
-        uint32_t count) {
+        uint32_t count,
+        VkDescriptorBindingFlags flags) {
         assert(bindings.count(binding) == 0 && "Binding already in use");
         VkDescriptorSetLayoutBinding layoutBinding{};
         layoutBinding.binding = binding;
@@ -20,27 +23,70 @@ namespace ikE {
         layoutBinding.descriptorCount = count;
         layoutBinding.stageFlags = stageFlags;
         bindings[binding] = layoutBinding;
+        if (flags != 0) {
+            bindingFlags[binding] = flags;
+        }
+        return *this;
+    }
+
+    IkDescriptorSetLayout::Builder& IkDescriptorSetLayout::Builder::useUpdateTemplate() {
+        updateTemplate = true;
+        return *this;
+    }
+
+    IkDescriptorSetLayout::Builder& IkDescriptorSetLayout::Builder::setPushDescriptor() {
+        assert(ikDevice.supportsPushDescriptors() && "VK_KHR_push_descriptor is not enabled on this device");
+        pushDescriptor = true;
         return *this;
     }
 
     std::unique_ptr<IkDescriptorSetLayout> IkDescriptorSetLayout::Builder::build() const {
-        return std::make_unique<IkDescriptorSetLayout>(ikDevice, bindings);
+        return std::make_unique<IkDescriptorSetLayout>(ikDevice, bindings, bindingFlags, updateTemplate, pushDescriptor);
     }
 
     // *************** Descriptor Set Layout *********************
 
     IkDescriptorSetLayout::IkDescriptorSetLayout(
-        IkeDeviceEngine& ikDevice, std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings)
-        : ikDevice{ ikDevice }, bindings{ bindings } {
+        IkeDeviceEngine& ikDevice,
+        std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings,
+        std::unordered_map<uint32_t, VkDescriptorBindingFlags> bindingFlags,
+        bool useUpdateTemplate,
+        bool pushDescriptor)
+        : ikDevice{ ikDevice }, bindings{ bindings }, useUpdateTemplate{ useUpdateTemplate }, pushDescriptor{ pushDescriptor } {
         std::vector<VkDescriptorSetLayoutBinding> setLayoutBindings{};
+        //one entry per binding in the same order, 0 for the ones without flags
+        std::vector<VkDescriptorBindingFlags> setLayoutBindingFlags{};
+        uint32_t highestBinding = 0;
         for (auto kv : bindings) {
             setLayoutBindings.push_back(kv.second);
+            auto flags = bindingFlags.find(kv.first);
+            setLayoutBindingFlags.push_back(flags != bindingFlags.end() ? flags->second : 0);
+            highestBinding = std::max(highestBinding, kv.first);
         }
 
         VkDescriptorSetLayoutCreateInfo descriptorSetLayoutInfo{};
         descriptorSetLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
         descriptorSetLayoutInfo.bindingCount = static_cast<uint32_t>(setLayoutBindings.size());
         descriptorSetLayoutInfo.pBindings = setLayoutBindings.data();
+        if (pushDescriptor) {
+            descriptorSetLayoutInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+        }
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+        if (!bindingFlags.empty()) {
+            for (auto kv : bindingFlags) {
+                assert(
+                    (!(kv.second & VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT) || kv.first == highestBinding) &&
+                    "Only the highest binding can have a variable descriptor count");
+                if (kv.second & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT) {
+                    descriptorSetLayoutInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+                }
+            }
+            bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+            bindingFlagsInfo.bindingCount = static_cast<uint32_t>(setLayoutBindingFlags.size());
+            bindingFlagsInfo.pBindingFlags = setLayoutBindingFlags.data();
+            descriptorSetLayoutInfo.pNext = &bindingFlagsInfo;
+        }
 
         if (vkCreateDescriptorSetLayout(
             ikDevice.device(),
@@ -49,12 +95,73 @@ namespace ikE {
             &descriptorSetLayout) != VK_SUCCESS) {
             throw std::runtime_error("failed to create descriptor set layout!");
         }
+
+        if (useUpdateTemplate) {
+            std::vector<uint32_t> bindingNumbers;
+            for (auto kv : bindings) {
+                assert(kv.second.descriptorCount == 1 && "Update templates only cover single descriptor bindings");
+                bindingNumbers.push_back(kv.first);
+            }
+            std::sort(bindingNumbers.begin(), bindingNumbers.end());
+            for (uint32_t slot = 0; slot < bindingNumbers.size(); slot++) {
+                templateSlots[bindingNumbers[slot]] = slot;
+            }
+            //a push template needs the pipeline layout, see createPushTemplate
+            if (!pushDescriptor) {
+                createUpdateTemplate(
+                    VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET, VK_NULL_HANDLE, 0, VK_PIPELINE_BIND_POINT_GRAPHICS);
+            }
+        }
     }
 
     IkDescriptorSetLayout::~IkDescriptorSetLayout() {
+        if (updateTemplate != VK_NULL_HANDLE) {
+            vkDestroyDescriptorUpdateTemplate(ikDevice.device(), updateTemplate, nullptr);
+        }
         vkDestroyDescriptorSetLayout(ikDevice.device(), descriptorSetLayout, nullptr);
     }
 
+    void IkDescriptorSetLayout::createPushTemplate(
+        VkPipelineLayout pipelineLayout, uint32_t set, VkPipelineBindPoint bindPoint) {
+        assert(pushDescriptor && useUpdateTemplate && "Only push layouts built with useUpdateTemplate get a push template");
+        assert(updateTemplate == VK_NULL_HANDLE && "Push template already created");
+        createUpdateTemplate(VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR, pipelineLayout, set, bindPoint);
+        pushPipelineLayout = pipelineLayout;
+        pushSet = set;
+    }
+
+    void IkDescriptorSetLayout::createUpdateTemplate(
+        VkDescriptorUpdateTemplateType templateType,
+        VkPipelineLayout pipelineLayout,
+        uint32_t set,
+        VkPipelineBindPoint bindPoint) {
+        std::vector<VkDescriptorUpdateTemplateEntry> entries;
+        for (auto kv : templateSlots) {
+            VkDescriptorUpdateTemplateEntry entry{};
+            entry.dstBinding = kv.first;
+            entry.dstArrayElement = 0;
+            entry.descriptorCount = 1;
+            entry.descriptorType = bindings[kv.first].descriptorType;
+            entry.offset = kv.second * sizeof(TemplateSlot);
+            entry.stride = sizeof(TemplateSlot);
+            entries.push_back(entry);
+        }
+
+        VkDescriptorUpdateTemplateCreateInfo templateInfo{};
+        templateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+        templateInfo.descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size());
+        templateInfo.pDescriptorUpdateEntries = entries.data();
+        templateInfo.templateType = templateType;
+        templateInfo.descriptorSetLayout = descriptorSetLayout;
+        templateInfo.pipelineBindPoint = bindPoint;
+        templateInfo.pipelineLayout = pipelineLayout;
+        templateInfo.set = set;
+
+        if (vkCreateDescriptorUpdateTemplate(ikDevice.device(), &templateInfo, nullptr, &updateTemplate) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create descriptor update template!");
+        }
+    }
+
     // *************** Descriptor Pool Builder *********************
 
     IkDescriptorPool::Builder& IkDescriptorPool::Builder::addPoolSize(
@@ -103,15 +210,24 @@ namespace ikE {
     }
 
     bool IkDescriptorPool::allocateDescriptor(
-        const VkDescriptorSetLayout descriptorSetLayout, VkDescriptorSet& descriptor) const {
+        const VkDescriptorSetLayout descriptorSetLayout,
+        VkDescriptorSet& descriptor,
+        uint32_t variableDescriptorCount) const {
         VkDescriptorSetAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
         allocInfo.descriptorPool = descriptorPool;
         allocInfo.pSetLayouts = &descriptorSetLayout;
         allocInfo.descriptorSetCount = 1;
 
-        // Might want to create a "DescriptorPoolManager" class that handles this case, and builds
-        // a new pool whenever an old pool fills up. But this is beyond our current scope
+        VkDescriptorSetVariableDescriptorCountAllocateInfo variableCountInfo{};
+        if (variableDescriptorCount > 0) {
+            variableCountInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO;
+            variableCountInfo.descriptorSetCount = 1;
+            variableCountInfo.pDescriptorCounts = &variableDescriptorCount;
+            allocInfo.pNext = &variableCountInfo;
+        }
+
+        // IkDescriptorPoolManager handles this case and chains a new pool whenever one fills up
         if (vkAllocateDescriptorSets(ikDevice.device(), &allocInfo, &descriptor) != VK_SUCCESS) {
             return false;
         }
@@ -130,10 +246,219 @@ namespace ikE {
         vkResetDescriptorPool(ikDevice.device(), descriptorPool, 0);
     }
 
+    // *************** Descriptor Pool Manager *********************
+
+    std::vector<IkDescriptorPoolManager::PoolSizeRatio> IkDescriptorPoolManager::defaultRatios() {
+        return {
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1.f },
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3.f },
+            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.f },
+            { VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1.f } };
+    }
+
+    IkDescriptorPoolManager::IkDescriptorPoolManager(
+        IkeDeviceEngine& ikDevice,
+        IkDeletionQueue& deletionQueue,
+        uint32_t frameCount,
+        std::vector<PoolSizeRatio> ratios)
+        : ikDevice{ ikDevice }, deletionQueue{ deletionQueue }, ratios{ std::move(ratios) } {
+        frameChains.resize(frameCount);
+    }
+
+    IkDescriptorPoolManager::~IkDescriptorPoolManager() {
+        auto destroyChain = [this](PoolChain& chain) {
+            if (chain.current != VK_NULL_HANDLE) {
+                vkDestroyDescriptorPool(ikDevice.device(), chain.current, nullptr);
+            }
+            for (auto pool : chain.full) {
+                vkDestroyDescriptorPool(ikDevice.device(), pool, nullptr);
+            }
+        };
+        destroyChain(persistentChain);
+        destroyChain(cacheChain);
+        for (auto& chain : frameChains) {
+            destroyChain(chain);
+        }
+        for (auto pool : freePools) {
+            vkDestroyDescriptorPool(ikDevice.device(), pool, nullptr);
+        }
+    }
+
+    VkDescriptorSet IkDescriptorPoolManager::allocate(VkDescriptorSetLayout layout) {
+        return allocateFrom(persistentChain, layout);
+    }
+
+    void IkDescriptorPoolManager::beginFrame(int frameIndex) {
+        assert(frameIndex >= 0 && frameIndex < static_cast<int>(frameChains.size()) && "Frame index out of range");
+        recyclePools(frameChains[frameIndex]);
+        currentFrame = frameIndex;
+    }
+
+    VkDescriptorSet IkDescriptorPoolManager::allocateForFrame(VkDescriptorSetLayout layout) {
+        assert(currentFrame >= 0 && "Can not allocate frame descriptors before the first frame");
+        return allocateFrom(frameChains[currentFrame], layout);
+    }
+
+    VkDescriptorSet IkDescriptorPoolManager::getCachedSet(
+        VkDescriptorSetLayout layout, std::vector<VkWriteDescriptorSet>& writes) {
+        std::vector<uint64_t> key;
+        key.push_back(reinterpret_cast<uint64_t>(layout));
+        for (const auto& write : writes) {
+            key.push_back((static_cast<uint64_t>(write.descriptorType) << 32) | write.dstBinding);
+            if (write.pBufferInfo != nullptr) {
+                key.push_back(reinterpret_cast<uint64_t>(write.pBufferInfo->buffer));
+                key.push_back(write.pBufferInfo->offset);
+                key.push_back(write.pBufferInfo->range);
+            }
+            if (write.pImageInfo != nullptr) {
+                key.push_back(reinterpret_cast<uint64_t>(write.pImageInfo->sampler));
+                key.push_back(reinterpret_cast<uint64_t>(write.pImageInfo->imageView));
+                key.push_back(write.pImageInfo->imageLayout);
+            }
+        }
+
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            return it->second;
+        }
+
+        VkDescriptorSet set = allocateFrom(cacheChain, layout);
+        for (auto& write : writes) {
+            write.dstSet = set;
+        }
+        vkUpdateDescriptorSets(ikDevice.device(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+        cache.emplace(std::move(key), set);
+        return set;
+    }
+
+    VkDescriptorSet IkDescriptorPoolManager::getCachedSet(
+        VkDescriptorSetLayout layout, VkDescriptorUpdateTemplate updateTemplate, const void* data, size_t dataSize) {
+        assert(dataSize % sizeof(uint64_t) == 0 && "Template data is keyed in 64 bit words");
+        //the layout comes first, so these keys never collide with the ones built from writes
+        std::vector<uint64_t> key(1 + dataSize / sizeof(uint64_t));
+        key[0] = reinterpret_cast<uint64_t>(layout);
+        std::memcpy(key.data() + 1, data, dataSize);
+
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            return it->second;
+        }
+
+        VkDescriptorSet set = allocateFrom(cacheChain, layout);
+        vkUpdateDescriptorSetWithTemplate(ikDevice.device(), set, updateTemplate, data);
+        cache.emplace(std::move(key), set);
+        return set;
+    }
+
+    void IkDescriptorPoolManager::clearCache() {
+        cache.clear();
+
+        std::vector<VkDescriptorPool> pools = cacheChain.full;
+        if (cacheChain.current != VK_NULL_HANDLE) {
+            pools.push_back(cacheChain.current);
+        }
+        cacheChain = PoolChain{};
+        if (pools.empty()) return;
+
+        deletionQueue.retire([this, pools]() {
+            for (auto pool : pools) {
+                vkResetDescriptorPool(ikDevice.device(), pool, 0);
+                freePools.push_back(pool);
+            }
+        });
+    }
+
+    size_t IkDescriptorPoolManager::CacheKeyHash::operator()(const std::vector<uint64_t>& key) const {
+        //FNV-1a over the 64 bit words
+        uint64_t hash = 14695981039346656037ull;
+        for (uint64_t word : key) {
+            hash ^= word;
+            hash *= 1099511628211ull;
+        }
+        return static_cast<size_t>(hash);
+    }
+
+    VkDescriptorSet IkDescriptorPoolManager::allocateFrom(PoolChain& chain, VkDescriptorSetLayout layout) {
+        if (chain.current == VK_NULL_HANDLE) {
+            chain.current = nextPool();
+        }
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = chain.current;
+        allocInfo.pSetLayouts = &layout;
+        allocInfo.descriptorSetCount = 1;
+
+        VkDescriptorSet set;
+        VkResult result = vkAllocateDescriptorSets(ikDevice.device(), &allocInfo, &set);
+        if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+            //the pool is full, the chain moves on to a fresh one
+            chain.full.push_back(chain.current);
+            chain.current = nextPool();
+            allocInfo.descriptorPool = chain.current;
+            result = vkAllocateDescriptorSets(ikDevice.device(), &allocInfo, &set);
+        }
+        if (result != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate descriptor set!");
+        }
+        return set;
+    }
+
+    VkDescriptorPool IkDescriptorPoolManager::nextPool() {
+        if (!freePools.empty()) {
+            VkDescriptorPool pool = freePools.back();
+            freePools.pop_back();
+            return pool;
+        }
+
+        std::vector<VkDescriptorPoolSize> poolSizes;
+        for (const auto& ratio : ratios) {
+            uint32_t count = std::max(1u, static_cast<uint32_t>(ratio.descriptorsPerSet * setsPerPool));
+            poolSizes.push_back({ ratio.type, count });
+        }
+
+        VkDescriptorPoolCreateInfo descriptorPoolInfo{};
+        descriptorPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        descriptorPoolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        descriptorPoolInfo.pPoolSizes = poolSizes.data();
+        descriptorPoolInfo.maxSets = setsPerPool;
+
+        VkDescriptorPool pool;
+        if (vkCreateDescriptorPool(ikDevice.device(), &descriptorPoolInfo, nullptr, &pool) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create descriptor pool!");
+        }
+        createdPools += 1;
+        setsPerPool = std::min(2 * setsPerPool, MAX_SETS_PER_POOL);
+        return pool;
+    }
+
+    void IkDescriptorPoolManager::recyclePools(PoolChain& chain) {
+        if (chain.current != VK_NULL_HANDLE) {
+            chain.full.push_back(chain.current);
+            chain.current = VK_NULL_HANDLE;
+        }
+        for (auto pool : chain.full) {
+            vkResetDescriptorPool(ikDevice.device(), pool, 0);
+            freePools.push_back(pool);
+        }
+        chain.full.clear();
+    }
+
     // *************** Descriptor Writer *********************
 
     IkDescriptorWriter::IkDescriptorWriter(IkDescriptorSetLayout& setLayout, IkDescriptorPool& pool)
-        : setLayout{ setLayout }, pool{ pool } {
+        : setLayout{ setLayout }, pool{ &pool } {
+        //value initialized, so the padding of the image infos is zero and cache keys stay stable
+        templateData.resize(setLayout.templateSlots.size());
+    }
+
+    IkDescriptorWriter::IkDescriptorWriter(IkDescriptorSetLayout& setLayout, IkDescriptorPoolManager& poolManager)
+        : setLayout{ setLayout }, poolManager{ &poolManager } {
+        templateData.resize(setLayout.templateSlots.size());
+    }
+
+    IkeDeviceEngine& IkDescriptorWriter::device() const {
+        return setLayout.ikDevice;
     }
 
     IkDescriptorWriter& IkDescriptorWriter::writeBuffer(
@@ -146,6 +471,12 @@ namespace ikE {
             bindingDescription.descriptorCount == 1 &&
             "Binding single descriptor info, but binding expects multiple");
 
+        if (usesTemplate()) {
+            templateData[setLayout.templateSlots[binding]].buffer = *bufferInfo;
+            templateWriteCount += 1;
+            return *this;
+        }
+
         VkWriteDescriptorSet write{};
         write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
         write.descriptorType = bindingDescription.descriptorType;
@@ -167,6 +498,16 @@ namespace ikE {
             bindingDescription.descriptorCount == 1 &&
             "Binding single descriptor info, but binding expects multiple");
 
+        if (usesTemplate()) {
+            //member by member, copying the struct could bring its padding along
+            auto& slot = templateData[setLayout.templateSlots[binding]].image;
+            slot.sampler = imageInfo->sampler;
+            slot.imageView = imageInfo->imageView;
+            slot.imageLayout = imageInfo->imageLayout;
+            templateWriteCount += 1;
+            return *this;
+        }
+
         VkWriteDescriptorSet write{};
         write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
         write.descriptorType = bindingDescription.descriptorType;
@@ -179,19 +520,66 @@ namespace ikE {
     }
 
     bool IkDescriptorWriter::build(VkDescriptorSet& set) {
-        bool success = pool.allocateDescriptor(setLayout.getDescriptorSetLayout(), set);
-        if (!success) {
+        assert(!setLayout.pushDescriptor && "Push descriptor sets are pushed, not allocated");
+        if (poolManager != nullptr) {
+            set = poolManager->allocate(setLayout.getDescriptorSetLayout());
+        }
+        else if (!pool->allocateDescriptor(setLayout.getDescriptorSetLayout(), set)) {
             return false;
         }
         overwrite(set);
         return true;
     }
 
+    bool IkDescriptorWriter::buildForFrame(VkDescriptorSet& set) {
+        assert(poolManager != nullptr && "Frame descriptor sets need a pool manager");
+        set = poolManager->allocateForFrame(setLayout.getDescriptorSetLayout());
+        overwrite(set);
+        return true;
+    }
+
+    bool IkDescriptorWriter::buildCached(VkDescriptorSet& set) {
+        assert(poolManager != nullptr && "Cached descriptor sets need a pool manager");
+        if (usesTemplate()) {
+            assert(isTemplateComplete() && "Update templates write every binding of the layout");
+            set = poolManager->getCachedSet(
+                setLayout.getDescriptorSetLayout(),
+                setLayout.updateTemplate,
+                templateData.data(),
+                templateData.size() * sizeof(templateData[0]));
+            return true;
+        }
+        set = poolManager->getCachedSet(setLayout.getDescriptorSetLayout(), writes);
+        return true;
+    }
+
     void IkDescriptorWriter::overwrite(VkDescriptorSet& set) {
+        if (usesTemplate()) {
+            assert(isTemplateComplete() && "Update templates write every binding of the layout");
+            vkUpdateDescriptorSetWithTemplate(device().device(), set, setLayout.updateTemplate, templateData.data());
+            return;
+        }
         for (auto& write : writes) {
             write.dstSet = set;
         }
-        vkUpdateDescriptorSets(pool.ikDevice.device(), writes.size(), writes.data(), 0, nullptr);
+        vkUpdateDescriptorSets(device().device(), writes.size(), writes.data(), 0, nullptr);
+    }
+
+    void IkDescriptorWriter::push(
+        VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t set, VkPipelineBindPoint bindPoint) {
+        assert(setLayout.pushDescriptor && "Only push descriptor layouts can be pushed");
+        if (usesTemplate()) {
+            assert(setLayout.updateTemplate != VK_NULL_HANDLE && "createPushTemplate was not called for this layout");
+            assert(
+                pipelineLayout == setLayout.pushPipelineLayout && set == setLayout.pushSet &&
+                "The push template was created for another pipeline layout or set");
+            assert(isTemplateComplete() && "Update templates write every binding of the layout");
+            device().cmdPushDescriptorSetWithTemplate(
+                commandBuffer, setLayout.updateTemplate, pipelineLayout, set, templateData.data());
+            return;
+        }
+        device().cmdPushDescriptorSet(
+            commandBuffer, bindPoint, pipelineLayout, set, static_cast<uint32_t>(writes.size()), writes.data());
     }
 
 }  // namespace lve
@@ -3,6 +3,7 @@
 #define IKDESCRIPTORS_HPP
 
 #include "ikDeviceEngine.hpp"
+#include "ikDeletionQueue.hpp"
 
 // std
 #include <memory>
@@ -17,30 +18,79 @@ namespace ikE {
         public:
             Builder(IkeDeviceEngine& ikDevice) : ikDevice{ ikDevice } {}
 
+            /*flags are VK_DESCRIPTOR_BINDING_*_BIT (descriptor indexing). count is the array size, or its upper bound
+              with VARIABLE_DESCRIPTOR_COUNT, which only the highest binding may have. a layout with an UPDATE_AFTER_BIND
+              binding can only be allocated from a pool created with VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+              so not from IkDescriptorPoolManager*/
             Builder& addBinding(
                 uint32_t binding,
                 VkDescriptorType descriptorType,
                 VkShaderStageFlags stageFlags,
-                uint32_t count = 1);
+                uint32_t count = 1,
+                VkDescriptorBindingFlags bindingFlags = 0);
+            /*the layout also gets a VkDescriptorUpdateTemplate, IkDescriptorWriter then fills one packed struct and
+              updates with it instead of a VkWriteDescriptorSet per binding. every binding must hold a single
+              descriptor and the writer has to write all of them*/
+            Builder& useUpdateTemplate();
+            //sets are pushed into the command buffer with IkDescriptorWriter::push() instead of being allocated,
+            //needs IkeDeviceEngine::supportsPushDescriptors()
+            Builder& setPushDescriptor();
             std::unique_ptr<IkDescriptorSetLayout> build() const;
 
         private:
             IkeDeviceEngine& ikDevice;
             std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings{};
+            std::unordered_map<uint32_t, VkDescriptorBindingFlags> bindingFlags{};
+            bool updateTemplate = false;
+            bool pushDescriptor = false;
         };
 
         IkDescriptorSetLayout(
-            IkeDeviceEngine& ikDevice, std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings);
+            IkeDeviceEngine& ikDevice,
+            std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings,
+            std::unordered_map<uint32_t, VkDescriptorBindingFlags> bindingFlags = {},
+            bool useUpdateTemplate = false,
+            bool pushDescriptor = false);
         ~IkDescriptorSetLayout();
         IkDescriptorSetLayout(const IkDescriptorSetLayout&) = delete;
         IkDescriptorSetLayout& operator=(const IkDescriptorSetLayout&) = delete;
 
         VkDescriptorSetLayout getDescriptorSetLayout() const { return descriptorSetLayout; }
+        uint32_t getDescriptorCount(uint32_t binding) const { return bindings.at(binding).descriptorCount; }
+        bool isPushDescriptor() const { return pushDescriptor; }
+
+        //a push template is made for the one pipeline layout and set it is pushed to, so it is created once that
+        //pipeline layout exists. only for push layouts built with useUpdateTemplate()
+        void createPushTemplate(
+            VkPipelineLayout pipelineLayout,
+            uint32_t set,
+            VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS);
 
     private:
+        //one per binding in the packed data of the template, the image and buffer infos share the slot
+        union TemplateSlot {
+            VkDescriptorImageInfo image;
+            VkDescriptorBufferInfo buffer;
+        };
+
+        void createUpdateTemplate(
+            VkDescriptorUpdateTemplateType templateType,
+            VkPipelineLayout pipelineLayout,
+            uint32_t set,
+            VkPipelineBindPoint bindPoint);
+
         IkeDeviceEngine& ikDevice;
         VkDescriptorSetLayout descriptorSetLayout;
         std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings;
+        bool useUpdateTemplate;
+        bool pushDescriptor;
+
+        //slot of every binding, in binding order
+        std::unordered_map<uint32_t, uint32_t> templateSlots;
+        VkDescriptorUpdateTemplate updateTemplate = VK_NULL_HANDLE;
+        //what the push template was created for
+        VkPipelineLayout pushPipelineLayout = VK_NULL_HANDLE;
+        uint32_t pushSet = 0;
 
         friend class IkDescriptorWriter;
     };
@@ -72,8 +122,11 @@ namespace ikE {
         IkDescriptorPool(const IkDescriptorPool&) = delete;
         IkDescriptorPool& operator=(const IkDescriptorPool&) = delete;
 
+        //variableDescriptorCount sizes the VARIABLE_DESCRIPTOR_COUNT binding of the layout, if it has one
         bool allocateDescriptor(
-            const VkDescriptorSetLayout descriptorSetLayout, VkDescriptorSet& descriptor) const;
+            const VkDescriptorSetLayout descriptorSetLayout,
+            VkDescriptorSet& descriptor,
+            uint32_t variableDescriptorCount = 0) const;
 
         void freeDescriptors(std::vector<VkDescriptorSet>& descriptors) const;
 
@@ -86,20 +139,114 @@ namespace ikE {
         friend class IkDescriptorWriter;
     };
 
+    /*IkDescriptorPoolManager hands out descriptor sets without running out of pool space. when the current pool of a
+      chain is full the next one is taken from the recycled pools or created, twice the size of the last one up to
+      MAX_SETS_PER_POOL. pool sizes are ratios per set, so one pool fits a mix of layouts. sets are never freed one by one
+      - allocate() gives a set that lives as long as the manager
+      - allocateForFrame() gives a set for the frame being recorded only, beginFrame() resets the pools of a frame in
+        bulk once the GPU finished it and recycles them
+      - getCachedSet() returns the same set for the same layout and writes, allocated and written the first time.
+        entries hold raw handles, so clearCache() must be called once a buffer or view they point at is destroyed
+      main thread only*/
+    class IkDescriptorPoolManager {
+    public:
+        struct PoolSizeRatio {
+            VkDescriptorType type;
+            float descriptorsPerSet;
+        };
+
+        static constexpr uint32_t INITIAL_SETS_PER_POOL = 64;
+        static constexpr uint32_t MAX_SETS_PER_POOL = 4096;
+        static std::vector<PoolSizeRatio> defaultRatios();
+
+        IkDescriptorPoolManager(
+            IkeDeviceEngine& ikDevice,
+            IkDeletionQueue& deletionQueue,
+            uint32_t frameCount,
+            std::vector<PoolSizeRatio> ratios = defaultRatios());
+        ~IkDescriptorPoolManager();
+        IkDescriptorPoolManager(const IkDescriptorPoolManager&) = delete;
+        IkDescriptorPoolManager& operator=(const IkDescriptorPoolManager&) = delete;
+
+        VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+
+        //frameIndex must have finished on the GPU, the renderer calls it from beginFrame
+        void beginFrame(int frameIndex);
+        VkDescriptorSet allocateForFrame(VkDescriptorSetLayout layout);
+
+        //writes are the writer's, their dstSet is filled in when the set is new
+        VkDescriptorSet getCachedSet(VkDescriptorSetLayout layout, std::vector<VkWriteDescriptorSet>& writes);
+        //the same for a layout with an update template, keyed by its packed data
+        VkDescriptorSet getCachedSet(
+            VkDescriptorSetLayout layout, VkDescriptorUpdateTemplate updateTemplate, const void* data, size_t dataSize);
+        //frames in flight may still use the cached sets, their pools are recycled through the deletion queue
+        void clearCache();
+
+        size_t poolCount() const { return createdPools; }
+        size_t cachedSetCount() const { return cache.size(); }
+
+    private:
+        struct PoolChain {
+            VkDescriptorPool current = VK_NULL_HANDLE;
+            std::vector<VkDescriptorPool> full;
+        };
+
+        struct CacheKeyHash {
+            size_t operator()(const std::vector<uint64_t>& key) const;
+        };
+
+        VkDescriptorSet allocateFrom(PoolChain& chain, VkDescriptorSetLayout layout);
+        VkDescriptorPool nextPool();
+        void recyclePools(PoolChain& chain);
+
+        IkeDeviceEngine& ikDevice;
+        IkDeletionQueue& deletionQueue;
+        std::vector<PoolSizeRatio> ratios;
+        uint32_t setsPerPool = INITIAL_SETS_PER_POOL;
+        size_t createdPools = 0;
+
+        std::vector<VkDescriptorPool> freePools; //reset and ready for any chain
+        PoolChain persistentChain;
+        PoolChain cacheChain;
+        std::vector<PoolChain> frameChains;
+        int currentFrame = -1;
+
+        //layout, then type, binding and the handles of every write
+        std::unordered_map<std::vector<uint64_t>, VkDescriptorSet, CacheKeyHash> cache;
+    };
+
     class IkDescriptorWriter {
     public:
         IkDescriptorWriter(IkDescriptorSetLayout& setLayout, IkDescriptorPool& pool);
+        IkDescriptorWriter(IkDescriptorSetLayout& setLayout, IkDescriptorPoolManager& poolManager);
 
         IkDescriptorWriter& writeBuffer(uint32_t binding, VkDescriptorBufferInfo* bufferInfo);
         IkDescriptorWriter& writeImage(uint32_t binding, VkDescriptorImageInfo* imageInfo);
 
+        //from a pool manager these never fail
         bool build(VkDescriptorSet& set);
+        bool buildForFrame(VkDescriptorSet& set);
+        bool buildCached(VkDescriptorSet& set);
         void overwrite(VkDescriptorSet& set);
+        //records the writes into commandBuffer for a push descriptor layout, no set is allocated
+        void push(
+            VkCommandBuffer commandBuffer,
+            VkPipelineLayout pipelineLayout,
+            uint32_t set,
+            VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS);
 
     private:
+        IkeDeviceEngine& device() const;
+        bool usesTemplate() const { return setLayout.useUpdateTemplate; }
+        bool isTemplateComplete() const { return templateWriteCount == templateData.size(); }
+
         IkDescriptorSetLayout& setLayout;
-        IkDescriptorPool& pool;
+        IkDescriptorPool* pool = nullptr;
+        IkDescriptorPoolManager* poolManager = nullptr;
+        //one of the two, depending on whether the layout has an update template
         std::vector<VkWriteDescriptorSet> writes;
+        std::vector<IkDescriptorSetLayout::TemplateSlot> templateData;
+        size_t templateWriteCount = 0;
     };
 
 }  // namespace lve
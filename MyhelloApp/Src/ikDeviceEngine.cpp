@@ -2,7 +2,11 @@
 
 //std headers
 //#include <stdexcept>
+#include <algorithm>
+#include <cassert>
+#include <fstream>
 #include <iostream>
+#include <limits>
 #include <set>
 #include <unordered_set>
 #include <cstring>
@@ -58,17 +62,26 @@ namespace ikE {
 		createSurface();
 		pickPhysicalDevice();
 		createLogicalDevice();
+		createFrameTimeline();
+		createPipelineCache();
 		createCommandPool();
 	}
 	//destructor
 	IkeDeviceEngine::~IkeDeviceEngine() {
+		savePipelineCache();
+		vkDestroyPipelineCache(device_, pipelineCache_, nullptr);
+		vkDestroySemaphore(device_, frameTimeline_, nullptr);
+		vkDestroyFence(device_, uploadFence, nullptr);
+		vkDestroyCommandPool(device_, uploadCommandPool, nullptr);
 		vkDestroyDevice(device_, nullptr);
 		//
 		if (enableValidationlayers) {
 			DestroyDebugUtilsMessengerEXT(instance, debugMessenger, nullptr);
 		}
 		//
-		vkDestroySurfaceKHR(instance, surface_, nullptr);
+		if (surface_ != VK_NULL_HANDLE) {
+			vkDestroySurfaceKHR(instance, surface_, nullptr);
+		}
 		vkDestroyInstance(instance, nullptr);
 
 		glfwTerminate();
@@ -86,7 +99,8 @@ namespace ikE {
 		appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
 		appInfo.pEngineName = "No Engine";
 		appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-		appInfo.apiVersion = VK_API_VERSION_1_0;
+		//1.2 for timeline semaphores, which track frame completion, descriptor indexing and vkGetPhysicalDeviceFeatures2 for optional features
+		appInfo.apiVersion = VK_API_VERSION_1_2;
 
 		VkInstanceCreateInfo createInfo = {};
 		createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -112,7 +126,9 @@ namespace ikE {
 			throw std::runtime_error("failed to create instance");
 
 		}
-		hasGlfwRequiredInstanceExtensions();
+		if (!window.isHeadless()) {
+			hasGlfwRequiredInstanceExtensions();
+		}
 	}
 
 	void IkeDeviceEngine::pickPhysicalDevice() {
@@ -137,6 +153,12 @@ namespace ikE {
 			throw std::runtime_error("failed to find a suitable GPU!");
 		}
 		vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+		descriptorIndexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+		VkPhysicalDeviceProperties2 properties2{};
+		properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties2.pNext = &descriptorIndexingProperties;
+		vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
 		std::cout << "physcial device :" << properties.deviceName << std::endl;
 
 	}
@@ -161,16 +183,69 @@ namespace ikE {
 		VkPhysicalDeviceFeatures deviceFeatures = {};
 		deviceFeatures.samplerAnisotropy = VK_TRUE;
 
+		//VK_KHR_swapchain enabling, headless rendering never presents so it needs no device extension
+		std::vector<const char*> enabledExtensions;
+		if (!window.isHeadless()) {
+			enabledExtensions = deviceExtensions;
+		}
+
+		//present wait is optional, it is only used for frame pacing (see FramePacing::presentWait)
+		VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+		presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+		VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+		presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+		presentIdFeatures.pNext = &presentWaitFeatures;
+		if (!window.isHeadless() &&
+			isDeviceExtensionAvailable(VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+			isDeviceExtensionAvailable(VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+			VkPhysicalDeviceFeatures2 features2{};
+			features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+			features2.pNext = &presentIdFeatures;
+			vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+			presentWaitSupported = presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+		}
+		if (presentWaitSupported) {
+			enabledExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+			enabledExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+		}
+
+		//push descriptors are optional as well, IkDescriptorWriter::push() and the descriptor benchmark use them
+		pushDescriptorSupported = isDeviceExtensionAvailable(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+		if (pushDescriptorSupported) {
+			enabledExtensions.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+		}
+
+		//required, isDeviceSuitable already checked it
+		VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+		timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+		timelineFeatures.timelineSemaphore = VK_TRUE;
+		if (presentWaitSupported) {
+			timelineFeatures.pNext = &presentIdFeatures;
+		}
+
+		//also required, only what IkBindlessTable and the shaders indexing it use
+		VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures{};
+		indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+		indexingFeatures.runtimeDescriptorArray = VK_TRUE;
+		indexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+		indexingFeatures.descriptorBindingVariableDescriptorCount = VK_TRUE;
+		indexingFeatures.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+		indexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+		indexingFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+		indexingFeatures.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+		indexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+		indexingFeatures.pNext = &timelineFeatures;
+
 		VkDeviceCreateInfo createInfo = {};
 		createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		createInfo.pNext = &indexingFeatures;
 
 		createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 		createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
 		createInfo.pEnabledFeatures = &deviceFeatures;
-		//VK_KHR_swapchain enabling
-		createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-		createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+		createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+		createInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
 		//Might not be necessary anymore but  we will still write it
 		if (enableValidationlayers) {
@@ -189,24 +264,199 @@ namespace ikE {
 		vkGetDeviceQueue(device_, indices.graphicsFamily, 0, &graphicsQueue_);
 		vkGetDeviceQueue(device_, indices.presentFamily, 0, &presentQueue_);
 
+		if (presentWaitSupported) {
+			vkWaitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(vkGetDeviceProcAddr(device_, "vkWaitForPresentKHR"));
+			presentWaitSupported = vkWaitForPresent != nullptr;
+		}
+		if (pushDescriptorSupported) {
+			vkCmdPushDescriptorSet = reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>(
+				vkGetDeviceProcAddr(device_, "vkCmdPushDescriptorSetKHR"));
+			vkCmdPushDescriptorSetWithTemplate = reinterpret_cast<PFN_vkCmdPushDescriptorSetWithTemplateKHR>(
+				vkGetDeviceProcAddr(device_, "vkCmdPushDescriptorSetWithTemplateKHR"));
+			pushDescriptorSupported = vkCmdPushDescriptorSet != nullptr && vkCmdPushDescriptorSetWithTemplate != nullptr;
+		}
+	}
+
+	VkResult IkeDeviceEngine::waitForPresent(VkSwapchainKHR swapChain, uint64_t presentId, uint64_t timeout) {
+		assert(presentWaitSupported && "VK_KHR_present_wait is not enabled on this device");
+		return vkWaitForPresent(device_, swapChain, presentId, timeout);
+	}
+
+	void IkeDeviceEngine::cmdPushDescriptorSet(
+		VkCommandBuffer commandBuffer,
+		VkPipelineBindPoint bindPoint,
+		VkPipelineLayout pipelineLayout,
+		uint32_t set,
+		uint32_t writeCount,
+		const VkWriteDescriptorSet* writes) {
+		assert(pushDescriptorSupported && "VK_KHR_push_descriptor is not enabled on this device");
+		vkCmdPushDescriptorSet(commandBuffer, bindPoint, pipelineLayout, set, writeCount, writes);
+	}
+
+	void IkeDeviceEngine::cmdPushDescriptorSetWithTemplate(
+		VkCommandBuffer commandBuffer,
+		VkDescriptorUpdateTemplate updateTemplate,
+		VkPipelineLayout pipelineLayout,
+		uint32_t set,
+		const void* data) {
+		assert(pushDescriptorSupported && "VK_KHR_push_descriptor is not enabled on this device");
+		vkCmdPushDescriptorSetWithTemplate(commandBuffer, updateTemplate, pipelineLayout, set, data);
+	}
+
+	void IkeDeviceEngine::createFrameTimeline() {
+		VkSemaphoreTypeCreateInfo typeInfo{};
+		typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+		typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		typeInfo.initialValue = 0;
+
+		VkSemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		semaphoreInfo.pNext = &typeInfo;
+
+		if (vkCreateSemaphore(device_, &semaphoreInfo, nullptr, &frameTimeline_) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create frame timeline semaphore!");
+		}
+	}
+
+	uint64_t IkeDeviceEngine::completedFrame() {
+		//the value only grows, so once a frame is known to be done the semaphore does not have to be asked again
+		if (completedFrame_ < submittedFrame_) {
+			if (vkGetSemaphoreCounterValue(device_, frameTimeline_, &completedFrame_) != VK_SUCCESS) {
+				throw std::runtime_error("failed to read frame timeline semaphore!");
+			}
+		}
+		return completedFrame_;
+	}
+
+	void IkeDeviceEngine::waitForFrame(uint64_t frame) {
+		assert(frame <= submittedFrame_ && "Can not wait for a frame that was never submitted");
+		if (frame <= completedFrame_) return;
+
+		VkSemaphoreWaitInfo waitInfo{};
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores = &frameTimeline_;
+		waitInfo.pValues = &frame;
+		if (vkWaitSemaphores(device_, &waitInfo, std::numeric_limits<uint64_t>::max()) != VK_SUCCESS) {
+			throw std::runtime_error("failed to wait for frame timeline semaphore!");
+		}
+		completedFrame_ = std::max(completedFrame_, frame);
+	}
+
+	bool IkeDeviceEngine::isDeviceExtensionAvailable(const char* extensionName) {
+		uint32_t extensionCount;
+		vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+		std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+		vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, availableExtensions.data());
+
+		for (const auto& extension : availableExtensions) {
+			if (std::strcmp(extension.extensionName, extensionName) == 0) return true;
+		}
+		return false;
+	}
+
+
+	// the cache file starts with a VkPipelineCacheHeaderVersionOne, data written by another GPU or driver version
+	// is useless (and some drivers crash on it) so it is only handed to vulkan when the header matches this device
+	bool IkeDeviceEngine::isPipelineCacheCompatible(const std::vector<char>& cacheData) {
+		VkPipelineCacheHeaderVersionOne header{};
+		if (cacheData.size() < sizeof(header)) {
+			return false;
+		}
+		std::memcpy(&header, cacheData.data(), sizeof(header));
+
+		return header.headerSize >= sizeof(header) &&
+			header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+			header.vendorID == properties.vendorID &&
+			header.deviceID == properties.deviceID &&
+			std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+	}
+
+	void IkeDeviceEngine::createPipelineCache() {
+		std::vector<char> cacheData;
+		std::ifstream file{ PIPELINE_CACHE_FILE, std::ios::ate | std::ios::binary };
+		if (file.is_open()) {
+			cacheData.resize(static_cast<size_t>(file.tellg()));
+			file.seekg(0);
+			file.read(cacheData.data(), cacheData.size());
+			if (!file || !isPipelineCacheCompatible(cacheData)) {
+				std::cout << "ignoring stale pipeline cache " << PIPELINE_CACHE_FILE << std::endl;
+				cacheData.clear();
+			}
+		}
+
+		VkPipelineCacheCreateInfo cacheInfo{};
+		cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		cacheInfo.initialDataSize = cacheData.size();
+		cacheInfo.pInitialData = cacheData.empty() ? nullptr : cacheData.data();
+
+		if (vkCreatePipelineCache(device_, &cacheInfo, nullptr, &pipelineCache_) != VK_SUCCESS) {
+			//the driver may still reject data that passed the header check, start from an empty cache then
+			cacheInfo.initialDataSize = 0;
+			cacheInfo.pInitialData = nullptr;
+			cacheData.clear();
+			if (vkCreatePipelineCache(device_, &cacheInfo, nullptr, &pipelineCache_) != VK_SUCCESS) {
+				throw std::runtime_error("failed to create pipeline cache!");
+			}
+		}
+		pipelineCacheWarm = !cacheData.empty();
+	}
+
+	// a failed save only costs the next launch its warm start, so it is reported instead of thrown from the destructor
+	void IkeDeviceEngine::savePipelineCache() {
+		size_t dataSize = 0;
+		if (vkGetPipelineCacheData(device_, pipelineCache_, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0) {
+			return;
+		}
+		std::vector<char> cacheData(dataSize);
+		if (vkGetPipelineCacheData(device_, pipelineCache_, &dataSize, cacheData.data()) != VK_SUCCESS) {
+			return;
+		}
+
+		std::ofstream file{ PIPELINE_CACHE_FILE, std::ios::binary | std::ios::trunc };
+		file.write(cacheData.data(), dataSize);
+		if (!file) {
+			std::cerr << "failed to write pipeline cache " << PIPELINE_CACHE_FILE << std::endl;
+		}
 	}
 
-	
 	void IkeDeviceEngine::createCommandPool() {
 		QueueFamilyIndices queueFamilyIndices = findPhysicalQueueFamilies();
 
 		VkCommandPoolCreateInfo poolInfo = {};
 		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 		poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily;
-		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+		//only the one upload buffer lives here and it is reset with the pool, frames record from IkFrameCommandPools
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
 
-		if (vkCreateCommandPool(device_, &poolInfo, nullptr, &commandPool) != VK_SUCCESS) {
+		if (vkCreateCommandPool(device_, &poolInfo, nullptr, &uploadCommandPool) != VK_SUCCESS) {
 			throw std::runtime_error("failed to create command pool");
 		}
+
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandPool = uploadCommandPool;
+		allocInfo.commandBufferCount = 1;
+		if (vkAllocateCommandBuffers(device_, &allocInfo, &uploadCommandBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("failed to allocate upload command buffer!");
+		}
+
+		VkFenceCreateInfo fenceInfo{};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		if (vkCreateFence(device_, &fenceInfo, nullptr, &uploadFence) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create upload fence!");
+		}
 	}
 
 	//Note:this needs explanation
-	void IkeDeviceEngine::createSurface() { window.createWindowSurface(instance, &surface_); };
+	void IkeDeviceEngine::createSurface() {
+		if (window.isHeadless()) {
+			surface_ = VK_NULL_HANDLE;
+			return;
+		}
+		window.createWindowSurface(instance, &surface_);
+	};
 
 
 	
@@ -216,6 +466,16 @@ namespace ikE {
 	
 	bool IkeDeviceEngine::isDeviceSuitable(VkPhysicalDevice device) {
 		QueueFamilyIndices indices = findQueueFamilies(device);
+		if (!supportsTimelineSemaphores(device) || !supportsDescriptorIndexing(device)) {
+			return false;
+		}
+
+		if (window.isHeadless()) {
+			//offscreen images only need a graphics queue, software devices such as lavapipe qualify
+			VkPhysicalDeviceFeatures supportedFeatures;
+			vkGetPhysicalDeviceFeatures(device, &supportedFeatures);
+			return indices.isComplete() && supportedFeatures.samplerAnisotropy;
+		}
 
 		bool extensionsSupported = checkDeviceExtensionSupport(device);
 
@@ -231,6 +491,40 @@ namespace ikE {
 		return indices.isComplete() && extensionsSupported && swapChainAdequate && supportedFeatures.samplerAnisotropy;
 	}
 
+	bool IkeDeviceEngine::supportsTimelineSemaphores(VkPhysicalDevice device) {
+		VkPhysicalDeviceProperties deviceProperties;
+		vkGetPhysicalDeviceProperties(device, &deviceProperties);
+		if (deviceProperties.apiVersion < VK_API_VERSION_1_2) {
+			return false;
+		}
+
+		VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+		timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+		VkPhysicalDeviceFeatures2 features2{};
+		features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features2.pNext = &timelineFeatures;
+		vkGetPhysicalDeviceFeatures2(device, &features2);
+		return timelineFeatures.timelineSemaphore == VK_TRUE;
+	}
+
+	bool IkeDeviceEngine::supportsDescriptorIndexing(VkPhysicalDevice device) {
+		//only called after supportsTimelineSemaphores, so the device is known to be 1.2
+		VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures{};
+		indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+		VkPhysicalDeviceFeatures2 features2{};
+		features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features2.pNext = &indexingFeatures;
+		vkGetPhysicalDeviceFeatures2(device, &features2);
+		return indexingFeatures.runtimeDescriptorArray
+			&& indexingFeatures.descriptorBindingPartiallyBound
+			&& indexingFeatures.descriptorBindingVariableDescriptorCount
+			&& indexingFeatures.descriptorBindingStorageBufferUpdateAfterBind
+			&& indexingFeatures.descriptorBindingSampledImageUpdateAfterBind
+			&& indexingFeatures.descriptorBindingUpdateUnusedWhilePending
+			&& indexingFeatures.shaderStorageBufferArrayNonUniformIndexing
+			&& indexingFeatures.shaderSampledImageArrayNonUniformIndexing;
+	}
+
 	void IkeDeviceEngine::populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo) {
 		createInfo = {};
 		createInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
@@ -287,11 +581,15 @@ namespace ikE {
 	
 
 	std::vector<const char*> IkeDeviceEngine::getRequiredExtensions() {
-		uint32_t glfwExtensionCount = 0;
-		const char** glfwExtensions;
-		glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-		// Create a vector from GLFW extensions
-		std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+		std::vector<const char*> extensions;
+		//glfw is never initialized without a window, and there is no surface to create
+		if (!window.isHeadless()) {
+			uint32_t glfwExtensionCount = 0;
+			const char** glfwExtensions;
+			glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+			// Create a vector from GLFW extensions
+			extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+		}
 
 		// Add debug extension if validation layers are enabled
 		if (enableValidationlayers) {
@@ -372,7 +670,13 @@ namespace ikE {
 			}
 			//Note:this need explanation
 			VkBool32 presentSupport = false;
-			vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface_, &presentSupport);
+			if (window.isHeadless()) {
+				//nothing is presented, the present queue is just the graphics queue
+				presentSupport = indices.graphicsFamilyHasValue && indices.graphicsFamily == static_cast<uint32_t>(i);
+			}
+			else {
+				vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface_, &presentSupport);
+			}
 			if (queueFamily.queueCount > 0 && presentSupport) {
 				indices.presentFamily = i;
 				indices.presentFamilyHasValue = true;
@@ -416,18 +720,25 @@ namespace ikE {
 
 	VkFormat IkeDeviceEngine::findSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features) {
 		for (VkFormat format : candidates) {
-			VkFormatProperties props;
-			vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &props);
-
-			if (tiling == VK_IMAGE_TILING_LINEAR && (props.linearTilingFeatures & features) == features) {
-				return format;
-			}
-			else if (tiling == VK_IMAGE_TILING_OPTIMAL && (props.optimalTilingFeatures & features) == features) {
+			if (supportsFormatFeatures(format, tiling, features)) {
 				return format;
 			}
 		}
 		throw std::runtime_error("failed to find supported format");
 	}
+
+	bool IkeDeviceEngine::supportsFormatFeatures(VkFormat format, VkImageTiling tiling, VkFormatFeatureFlags features) {
+		VkFormatProperties props;
+		vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &props);
+
+		if (tiling == VK_IMAGE_TILING_LINEAR) {
+			return (props.linearTilingFeatures & features) == features;
+		}
+		if (tiling == VK_IMAGE_TILING_OPTIMAL) {
+			return (props.optimalTilingFeatures & features) == features;
+		}
+		return false;
+	}
    
 	
 
@@ -443,6 +754,28 @@ namespace ikE {
 		throw std::runtime_error("failed to find suitable memory type !");
 	}
 
+	bool IkeDeviceEngine::hasMemoryProperties(VkMemoryPropertyFlags properties) {
+		VkPhysicalDeviceMemoryProperties memProperties;
+		vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+		for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+			if ((memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	uint32_t IkeDeviceEngine::graphicsTimestampValidBits() {
+		QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
+
+		uint32_t queueFamilyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+		return queueFamilies[indices.graphicsFamily].timestampValidBits;
+	}
+
 
 
 
@@ -483,14 +816,9 @@ namespace ikE {
 
 
 	VkCommandBuffer IkeDeviceEngine::beginSingleTimeCommands() {
-		VkCommandBufferAllocateInfo allocInfo{};                             // initializes a struct with zero/default values
-		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;   //  required for vulkan structures to identify them self
-		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		allocInfo.commandPool = commandPool;
-		allocInfo.commandBufferCount = 1;
-
-		VkCommandBuffer commandBuffer;                                   // the handle we need to begin recording
-		vkAllocateCommandBuffers(device_, &allocInfo, &commandBuffer);   //
+		assert(!uploadRecording && "Single time commands can not be nested");
+		uploadRecording = true;
+		VkCommandBuffer commandBuffer = uploadCommandBuffer;            // allocated once in createCommandPool, the pool reset leaves it ready to begin
 
 		VkCommandBufferBeginInfo beginInfo{};                           // initializes a struct with zero/default values
 		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;  // Required for vulkan structures to identify them self
@@ -508,11 +836,15 @@ namespace ikE {
 		submitInfo.commandBufferCount = 1;
 		submitInfo.pCommandBuffers = &commandBuffer;
 
-		vkQueueSubmit(graphicsQueue_, 1, &submitInfo, VK_NULL_HANDLE);
-		vkQueueWaitIdle(graphicsQueue_);
-
-		vkFreeCommandBuffers(device_, commandPool, 1, &commandBuffer);
+		//waits for this submission only, not for the frames in flight on the same queue
+		if (vkQueueSubmit(graphicsQueue_, 1, &submitInfo, uploadFence) != VK_SUCCESS) {
+			throw std::runtime_error("failed to submit upload command buffer!");
+		}
+		vkWaitForFences(device_, 1, &uploadFence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+		vkResetFences(device_, 1, &uploadFence);
 
+		vkResetCommandPool(device_, uploadCommandPool, 0);
+		uploadRecording = false;
 	}
 	
 	void IkeDeviceEngine::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) {
@@ -548,6 +880,46 @@ namespace ikE {
 		endSingleTimeCommands(commandBuffer);
 	}
 
+	//reads back a color attachment that a render pass left in layout. the render pass ends with no dependency of
+	//its own, so this barrier moves the image to TRANSFER_SRC and orders the copy after every color write submitted
+	//before it on the graphics queue, without the device being idle
+	void IkeDeviceEngine::copyImageToBuffer(VkImage image, VkImageLayout layout, VkBuffer buffer, uint32_t width, uint32_t height) {
+		VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		barrier.oldLayout = layout;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+		vkCmdPipelineBarrier(commandBuffer,
+			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		VkBufferImageCopy region{};
+		region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent = { width, height, 1 };
+
+		vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer, 1, &region);
+
+		//back to the layout the next frame's render pass expects, its writes wait for the read
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		barrier.newLayout = layout;
+		vkCmdPipelineBarrier(commandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+		endSingleTimeCommands(commandBuffer);
+	}
+
 
 	void IkeDeviceEngine::createImageWithInfo(
 		const VkImageCreateInfo& imageInfo,
@@ -60,23 +60,65 @@ namespace ikE{
       IkeDeviceEngine& operator=(IkeDeviceEngine&&) = delete;
 
       //getter functions
-      VkCommandPool getCommandPool() { return commandPool; };
       VkDevice device() { return device_; };
 
+      /*shared by every ikePipeline, loaded from PIPELINE_CACHE_FILE at startup and written back on shutdown
+        so the driver can skip shader compilation on later launches. warm tells whether a valid file was loaded*/
+      VkPipelineCache pipelineCache() { return pipelineCache_; }
+      bool isPipelineCacheWarm() const { return pipelineCacheWarm; }
+      static constexpr const char* PIPELINE_CACHE_FILE = "pipeline_cache.bin";
+
       //surface() needs explanation
       VkSurfaceKHR surface() { return surface_;}
+      //a headless device has no surface and renders into offscreen images instead of a swap chain
+      bool isHeadless() const { return window.isHeadless(); }
       VkQueue graphicsQueue() { return graphicsQueue_;};
       VkQueue presentQueue() { return presentQueue_;};
 
       SwapChainSupportDetails getSwapChainSupport() { return querySwapChainSupport(physicalDevice); };
       uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
-
+      //true when any memory type has all of the given property bits, e.g. LAZILY_ALLOCATED on tile based GPUs
+      bool hasMemoryProperties(VkMemoryPropertyFlags properties);
+      //VK_KHR_present_id and VK_KHR_present_wait are both enabled, never on a headless device
+      bool supportsPresentWait() const { return presentWaitSupported; }
+      VkResult waitForPresent(VkSwapchainKHR swapChain, uint64_t presentId, uint64_t timeout);
+      //VK_KHR_push_descriptor is enabled, layouts built with setPushDescriptor() need it
+      bool supportsPushDescriptors() const { return pushDescriptorSupported; }
+      void cmdPushDescriptorSet(
+          VkCommandBuffer commandBuffer,
+          VkPipelineBindPoint bindPoint,
+          VkPipelineLayout pipelineLayout,
+          uint32_t set,
+          uint32_t writeCount,
+          const VkWriteDescriptorSet* writes);
+      void cmdPushDescriptorSetWithTemplate(
+          VkCommandBuffer commandBuffer,
+          VkDescriptorUpdateTemplate updateTemplate,
+          VkPipelineLayout pipelineLayout,
+          uint32_t set,
+          const void* data);
+
+      /*one timeline semaphore for the whole device whose value is the number of the last frame the GPU finished.
+        every frame submit signals the number advanceFrame() gave it, frames count from 1. CPU waits, deferred
+        deletion and other submits (vkQueueSubmit with a VkTimelineSemaphoreSubmitInfo wait) all sync on it*/
+      VkSemaphore frameTimeline() { return frameTimeline_; }
+      //reserves the number of the frame about to be submitted
+      uint64_t advanceFrame() { return ++submittedFrame_; }
+      uint64_t lastSubmittedFrame() const { return submittedFrame_; }
+      uint64_t completedFrame();
+      //blocks until the GPU finished frame, returns at once for frame 0 or a frame known to be done
+      void waitForFrame(uint64_t frame);
+
+      //bits of a timestamp query on the graphics queue that hold the counter, 0 when it has no timestamps
+      uint32_t graphicsTimestampValidBits();
 
 
       //used for commandpool
       QueueFamilyIndices findPhysicalQueueFamilies() { return findQueueFamilies(physicalDevice); };
       //findSupportedFormat needs explanation
       VkFormat findSupportedFormat(const std::vector<VkFormat> &candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
+      //true when images of format with the given tiling support every one of features, e.g. linear filtered blits
+      bool supportsFormatFeatures(VkFormat format, VkImageTiling tiling, VkFormatFeatureFlags features);
 
       //Buffer Helper functions
       //public createcommandpool
@@ -88,10 +130,14 @@ namespace ikE{
           VkMemoryPropertyFlags properties,
           VkBuffer& buffer,
           VkDeviceMemory& bufferMemory);
+      /*one shot uploads record into a command buffer of their own pool, which is reset after the submit has finished
+        instead of allocating and freeing a buffer every time. main thread only, and never nested*/
       VkCommandBuffer beginSingleTimeCommands();
       void endSingleTimeCommands(VkCommandBuffer commandBuffer);
       void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
       void copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, uint32_t layerCount);
+      //layout is the final layout of the render pass that wrote the image, it is back in it once the copy is done
+      void copyImageToBuffer(VkImage image, VkImageLayout layout, VkBuffer buffer, uint32_t width, uint32_t height);
 
       void createImageWithInfo(
           const VkImageCreateInfo& imageInfo,
@@ -100,6 +146,8 @@ namespace ikE{
           VkDeviceMemory &imageMemory);
 
       VkPhysicalDeviceProperties properties;
+      //limits of update after bind descriptors, which are counted apart from properties.limits
+      VkPhysicalDeviceDescriptorIndexingProperties descriptorIndexingProperties{};
 
 
 
@@ -110,6 +158,9 @@ namespace ikE{
       void createSurface();
       void pickPhysicalDevice();
       void createLogicalDevice();
+      void createFrameTimeline();
+      void createPipelineCache();
+      void savePipelineCache();
       //
       //void createCommandPool();
 
@@ -122,7 +173,11 @@ namespace ikE{
       void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo);
       void hasGlfwRequiredInstanceExtensions();
       bool checkDeviceExtensionSupport(VkPhysicalDevice device);
+      bool isDeviceExtensionAvailable(const char* extensionName);
+      bool supportsTimelineSemaphores(VkPhysicalDevice device);
+      bool supportsDescriptorIndexing(VkPhysicalDevice device);
       SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device);
+      bool isPipelineCacheCompatible(const std::vector<char>& cacheData);
      
 
 
@@ -135,7 +190,10 @@ namespace ikE{
       /*VkPhysicalDevice Represents the actual GPU hardware e.g your NVIDIA RTX,AMD Radeon, or Intel GPU
         we set it to vk_null_handle before it is properly created or assigned*/
       VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
-      VkCommandPool commandPool;
+      VkCommandPool uploadCommandPool;
+      VkCommandBuffer uploadCommandBuffer;
+      VkFence uploadFence;
+      bool uploadRecording = false;
 
       //getters headers
       /*VkDevice is the logical device a software connection to the GPU, it
@@ -145,6 +203,16 @@ namespace ikE{
       VkSurfaceKHR surface_;
       VkQueue graphicsQueue_;
       VkQueue presentQueue_;
+      VkPipelineCache pipelineCache_ = VK_NULL_HANDLE;
+      bool pipelineCacheWarm = false;
+      bool presentWaitSupported = false;
+      PFN_vkWaitForPresentKHR vkWaitForPresent = nullptr;
+      bool pushDescriptorSupported = false;
+      PFN_vkCmdPushDescriptorSetKHR vkCmdPushDescriptorSet = nullptr;
+      PFN_vkCmdPushDescriptorSetWithTemplateKHR vkCmdPushDescriptorSetWithTemplate = nullptr;
+      VkSemaphore frameTimeline_ = VK_NULL_HANDLE;
+      uint64_t submittedFrame_ = 0;
+      uint64_t completedFrame_ = 0;
 
 
 
@@ -0,0 +1,64 @@
+#include "ikEmbeddedShaders.hpp"
+
+//every list is generated by Shaders/compile.bat, the pre-build step of the project
+#if !__has_include("../Shaders/embedded/vert.inc") || \
+	!__has_include("../Shaders/embedded/frag.inc") || \
+	!__has_include("../Shaders/embedded/pointlight_vert.inc") || \
+	!__has_include("../Shaders/embedded/pointlight_frag.inc") || \
+	!__has_include("../Shaders/embedded/depth_vert.inc") || \
+	!__has_include("../Shaders/embedded/gbuffer_frag.inc") || \
+	!__has_include("../Shaders/embedded/deferred_vert.inc") || \
+	!__has_include("../Shaders/embedded/deferred_frag.inc")
+#error "Shaders/embedded is incomplete, run Shaders/compile.bat (glslc from the Vulkan SDK must be on the PATH)"
+#endif
+
+namespace ikE {
+
+	namespace {
+		constexpr uint32_t VERT_SPV[] = {
+#include "../Shaders/embedded/vert.inc"
+		};
+		constexpr uint32_t FRAG_SPV[] = {
+#include "../Shaders/embedded/frag.inc"
+		};
+		constexpr uint32_t POINTLIGHT_VERT_SPV[] = {
+#include "../Shaders/embedded/pointlight_vert.inc"
+		};
+		constexpr uint32_t POINTLIGHT_FRAG_SPV[] = {
+#include "../Shaders/embedded/pointlight_frag.inc"
+		};
+		constexpr uint32_t DEPTH_VERT_SPV[] = {
+#include "../Shaders/embedded/depth_vert.inc"
+		};
+		constexpr uint32_t GBUFFER_FRAG_SPV[] = {
+#include "../Shaders/embedded/gbuffer_frag.inc"
+		};
+		constexpr uint32_t DEFERRED_VERT_SPV[] = {
+#include "../Shaders/embedded/deferred_vert.inc"
+		};
+		constexpr uint32_t DEFERRED_FRAG_SPV[] = {
+#include "../Shaders/embedded/deferred_frag.inc"
+		};
+
+		constexpr EmbeddedShader EMBEDDED_SHADERS[] = {
+			{ "Shaders/vert.spv", VERT_SPV, sizeof(VERT_SPV) / sizeof(uint32_t) },
+			{ "Shaders/frag.spv", FRAG_SPV, sizeof(FRAG_SPV) / sizeof(uint32_t) },
+			{ "Shaders/pointlight_vert.spv", POINTLIGHT_VERT_SPV, sizeof(POINTLIGHT_VERT_SPV) / sizeof(uint32_t) },
+			{ "Shaders/pointlight_frag.spv", POINTLIGHT_FRAG_SPV, sizeof(POINTLIGHT_FRAG_SPV) / sizeof(uint32_t) },
+			{ "Shaders/depth_vert.spv", DEPTH_VERT_SPV, sizeof(DEPTH_VERT_SPV) / sizeof(uint32_t) },
+			{ "Shaders/gbuffer_frag.spv", GBUFFER_FRAG_SPV, sizeof(GBUFFER_FRAG_SPV) / sizeof(uint32_t) },
+			{ "Shaders/deferred_vert.spv", DEFERRED_VERT_SPV, sizeof(DEFERRED_VERT_SPV) / sizeof(uint32_t) },
+			{ "Shaders/deferred_frag.spv", DEFERRED_FRAG_SPV, sizeof(DEFERRED_FRAG_SPV) / sizeof(uint32_t) },
+		};
+	}
+
+	const EmbeddedShader* findEmbeddedShader(const std::string& filepath) {
+		for (const auto& shader : EMBEDDED_SHADERS) {
+			if (filepath == shader.filepath) {
+				return &shader;
+			}
+		}
+		return nullptr;
+	}
+
+}//namespace ikE
@@ -0,0 +1,23 @@
+#ifndef IKEMBEDDEDSHADERS_HPP
+#define IKEMBEDDEDSHADERS_HPP
+
+//std
+#include <cstddef>
+#include <cstdint>
+#include <string>
+namespace ikE {
+	/*SPIR-V compiled into the executable. Shaders/compile.bat, which the project runs before every build, writes every
+	  shader a second time as a list of words (glslc -mfmt=num) into Shaders/embedded, and ikEmbeddedShaders.cpp
+	  includes those lists as constant arrays. a missing list fails the build, only a shader that is not one of the
+	  app's own, e.g. one added without a line in compile.bat, is read from disk by IkShaderRegistry*/
+	struct EmbeddedShader {
+		const char* filepath; //the .spv path the shader would otherwise be loaded from
+		const uint32_t* code;
+		size_t wordCount;
+	};
+
+	//nullptr for a shader that is not embedded
+	const EmbeddedShader* findEmbeddedShader(const std::string& filepath);
+
+} //namepace
+#endif //header guard
@@ -1,4 +1,5 @@
 #include "ikEngineModel.hpp"
+#include "ikCpuProfiler.hpp"
 #include "ikUtils.hpp"
 //libs
 #define TINYOBJLOADER_IMPLEMENTATION
@@ -29,6 +30,7 @@ namespace ikE {
 
 	ikEngineModel::ikEngineModel(IkeDeviceEngine &device, const ikEngineModel::Builder& builder) : IkeDevice(device) {
 		createVertexBuffers(builder.vertices);
+		createPositionBuffer(builder.vertices);
 		createIndexBuffers(builder.indices);
 
 	}
@@ -38,6 +40,7 @@ namespace ikE {
 	ikEngineModel::~ikEngineModel() {}
 
 	std::unique_ptr<ikEngineModel> ikEngineModel::createModelFromFile(IkeDeviceEngine& device, const std::string& filepath) {
+		IK_PROFILE_ZONE("ikEngineModel::createModelFromFile");
 
 		Builder builder{};
 		builder.loadModel(filepath);
@@ -82,6 +85,37 @@ namespace ikE {
 
 	}
 
+	//the depth pre-pass only needs positions, keeping them in their own buffer means it fetches 12 bytes
+	//per vertex instead of the whole 44 byte Vertex
+	void ikEngineModel::createPositionBuffer(const std::vector<Vertex>& vertices) {
+		std::vector<glm::vec3> positions(vertices.size());
+		for (size_t i = 0; i < vertices.size(); i++) {
+			positions[i] = vertices[i].position;
+		}
+
+		uint32_t positionSize = sizeof(positions[0]);
+		VkDeviceSize bufferSize = positionSize * static_cast<VkDeviceSize>(vertexCount);
+
+		IkBuffer stagingBuffer{
+			IkeDevice,positionSize,vertexCount,
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		};
+
+		stagingBuffer.map();
+		stagingBuffer.writeToBuffer((void*)positions.data());
+
+		positionBuffer = std::make_unique<IkBuffer>(
+			IkeDevice,
+			positionSize,
+			vertexCount,
+			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+		);
+
+		IkeDevice.copyBuffer(stagingBuffer.getBuffer(), positionBuffer->getBuffer(), bufferSize);
+	}
+
 	void ikEngineModel::createIndexBuffers(const std::vector<uint32_t>& indices) {
 		indexCount = static_cast<uint32_t>(indices.size());
 		hasIndexBuffer = indexCount > 0;
@@ -121,12 +155,12 @@ namespace ikE {
 
 
 
-	void ikEngineModel::draw(VkCommandBuffer commandBuffer) {
+	void ikEngineModel::draw(VkCommandBuffer commandBuffer, uint32_t firstInstance) {
 		if (hasIndexBuffer) {
-			vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, 0);
+			vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, firstInstance);
 		}
 		else {
-	        vkCmdDraw(commandBuffer, vertexCount, 1, 0, 0);
+	        vkCmdDraw(commandBuffer, vertexCount, 1, 0, firstInstance);
 		}
 	}
 
@@ -145,6 +179,16 @@ namespace ikE {
 	   }
 	}
 
+	void ikEngineModel::bindPositions(VkCommandBuffer commandBuffer) {
+		VkBuffer buffers[] = { positionBuffer->getBuffer() };
+		VkDeviceSize offsets[] = { 0 };
+		vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+
+		if (hasIndexBuffer) {
+			vkCmdBindIndexBuffer(commandBuffer, indexBuffer->getBuffer(), 0, VK_INDEX_TYPE_UINT32);
+		}
+	}
+
 
 
 	std::vector<VkVertexInputBindingDescription>ikEngineModel::Vertex::getBindingDescriptions() {
@@ -174,6 +218,20 @@ namespace ikE {
 
 	}
 
+	std::vector<VkVertexInputBindingDescription>ikEngineModel::Vertex::getPositionBindingDescriptions() {
+		std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
+		bindingDescriptions[0].binding = 0;
+		bindingDescriptions[0].stride = sizeof(glm::vec3);
+		bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+		return bindingDescriptions;
+	}
+
+	std::vector<VkVertexInputAttributeDescription>ikEngineModel::Vertex::getPositionAttributeDescriptions() {
+		std::vector<VkVertexInputAttributeDescription> attributeDescriptions{};
+		attributeDescriptions.push_back({ 0,0, VK_FORMAT_R32G32B32_SFLOAT, 0 });
+		return attributeDescriptions;
+	}
+
 	void ikEngineModel::Builder::loadModel(const std::string& filepath) {
 		tinyobj::attrib_t attrib;
 		std::vector<tinyobj::shape_t> shapes;
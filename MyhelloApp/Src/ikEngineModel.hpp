@@ -34,6 +34,10 @@ namespace ikE {
 			static std::vector<VkVertexInputBindingDescription> getBindingDescriptions();
 			static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
 
+			//layout of the separate position stream used by depth only passes, a tightly packed vec3 per vertex
+			static std::vector<VkVertexInputBindingDescription> getPositionBindingDescriptions();
+			static std::vector<VkVertexInputAttributeDescription> getPositionAttributeDescriptions();
+
 			bool operator==(const Vertex& other) const {
 				return position == other.position && color == other.color && normal == other.normal && uv == other.uv;
 			}
@@ -61,17 +65,22 @@ namespace ikE {
 		static std::unique_ptr<ikEngineModel> createModelFromFile(IkeDeviceEngine& device, const std::string& filepath);
 
 		void bind(VkCommandBuffer commandBuffer);
-		void draw(VkCommandBuffer commandBuffer);
+		//binds the 12 byte position stream instead of the interleaved vertices, draw() is used the same way afterwards
+		void bindPositions(VkCommandBuffer commandBuffer);
+		//firstInstance reaches the vertex shader as gl_InstanceIndex, IkRenderSystem passes the material id in it
+		void draw(VkCommandBuffer commandBuffer, uint32_t firstInstance = 0);
 
 
 	private:
 		void createVertexBuffers(const std::vector<Vertex>& vertices);
+		void createPositionBuffer(const std::vector<Vertex>& vertices);
 		void createIndexBuffers(const std::vector<uint32_t>& indices);
 
 
 		IkeDeviceEngine &IkeDevice;
 		
 		std::unique_ptr<IkBuffer> vertexBuffer;
+		std::unique_ptr<IkBuffer> positionBuffer;
 		uint32_t vertexCount;
 
 		bool hasIndexBuffer = false;
@@ -0,0 +1,45 @@
+#include "ikEntityRegistry.hpp"
+
+namespace ikE {
+
+	IkEntity IkEntityRegistry::create(const TransformComponent& transform) {
+		IkEntity entity = nextEntity++;
+		transforms.add(entity, transform);
+		return entity;
+	}
+
+	IkEntity IkEntityRegistry::createPointLight(float intensity, float radius, glm::vec3 color) {
+		TransformComponent transform{};
+		transform.scale.x = radius;
+		IkEntity entity = create(transform);
+		pointLights.add(entity, PointLightComponent{ intensity });
+		colors.add(entity, ColorComponent{ color });
+		return entity;
+	}
+
+	void IkEntityRegistry::destroy(IkEntity entity) {
+		transforms.remove(entity);
+		removeModel(entity);
+		pointLights.remove(entity);
+		colors.remove(entity);
+	}
+
+	void IkEntityRegistry::addModel(IkEntity entity, ModelComponent model) {
+		if (model.isStatic) staticGeneration++;
+		models.add(entity, std::move(model));
+	}
+
+	void IkEntityRegistry::setModel(IkEntity entity, std::shared_ptr<ikEngineModel> model) {
+		ModelComponent& component = models.get(entity);
+		if (component.model == model) return;
+		if (component.isStatic) staticGeneration++;
+		component.model = std::move(model);
+	}
+
+	void IkEntityRegistry::removeModel(IkEntity entity) {
+		if (!models.contains(entity)) return;
+		if (models.get(entity).isStatic) staticGeneration++;
+		models.remove(entity);
+	}
+
+}//namespace ikE
@@ -0,0 +1,126 @@
+#ifndef IKENTITYREGISTRY_HPP
+#define IKENTITYREGISTRY_HPP
+
+#include "ikgameObject.hpp"
+
+//std
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+namespace ikE {
+	//an entity is only an id, what it is made of is the set of component pools that contain it
+	using IkEntity = uint32_t;
+
+	/*IkComponentPool stores one component type as a sparse set. the components are packed without holes in a dense
+	  array and entities() holds the entity of every element at the same index, so a system walks exactly the
+	  entities that have the component, in memory order. sparse maps an entity to its dense index in O(1).
+	  removing moves the last element into the hole, which changes the order of the pool but no other pool.
+	  concurrent reads are fine, anything that adds or removes is main thread only*/
+	template <typename T>
+	class IkComponentPool {
+	public:
+		bool contains(IkEntity entity) const {
+			return entity < sparse.size() && sparse[entity] != NO_INDEX;
+		}
+
+		T& get(IkEntity entity) {
+			assert(contains(entity) && "Entity does not have this component");
+			return dense[sparse[entity]];
+		}
+		const T& get(IkEntity entity) const {
+			assert(contains(entity) && "Entity does not have this component");
+			return dense[sparse[entity]];
+		}
+
+		T& add(IkEntity entity, T component = T{}) {
+			assert(!contains(entity) && "Entity already has this component");
+			if (entity >= sparse.size()) {
+				sparse.resize(entity + 1, NO_INDEX);
+			}
+			sparse[entity] = static_cast<uint32_t>(dense.size());
+			denseEntities.push_back(entity);
+			dense.push_back(std::move(component));
+			return dense.back();
+		}
+
+		void remove(IkEntity entity) {
+			if (!contains(entity)) return;
+			uint32_t index = sparse[entity];
+			IkEntity last = denseEntities.back();
+			if (last != entity) {
+				dense[index] = std::move(dense.back());
+				denseEntities[index] = last;
+				sparse[last] = index;
+			}
+			sparse[entity] = NO_INDEX;
+			dense.pop_back();
+			denseEntities.pop_back();
+		}
+
+		void reserve(size_t count) {
+			dense.reserve(count);
+			denseEntities.reserve(count);
+		}
+
+		size_t size() const { return dense.size(); }
+		bool empty() const { return dense.empty(); }
+
+		//the dense arrays, component i belongs to entities()[i]
+		std::vector<T>& components() { return dense; }
+		const std::vector<T>& components() const { return dense; }
+		const std::vector<IkEntity>& entities() const { return denseEntities; }
+
+	private:
+		static constexpr uint32_t NO_INDEX = 0xffffffff;
+
+		std::vector<uint32_t> sparse;
+		std::vector<T> dense;
+		std::vector<IkEntity> denseEntities;
+	};
+
+	/*IkEntityRegistry is the scene, one IkComponentPool per component type. every entity has a transform, the other
+	  components are optional: a model makes it drawn by IkRenderSystem, a point light (with its color) makes it a
+	  light of IkPointLightSystem. ids are never reused, so an id the render system cached can not come back as a
+	  different entity.
+	  models are only changed through the registry, which counts every change to the static ones in the static
+	  generation. the render system replays its recorded static draws for as long as the generation stays the same*/
+	class IkEntityRegistry {
+	public:
+		IkEntityRegistry() = default;
+
+		IkEntityRegistry(const IkEntityRegistry&) = delete;
+		IkEntityRegistry& operator =(const IkEntityRegistry&) = delete;
+
+		IkEntity create(const TransformComponent& transform = TransformComponent{});
+		IkEntity createPointLight(
+			float intensity = 10.f,
+			float radius = 0.1f,
+			glm::vec3 color = glm::vec3(1.f));
+		//removes the entity from every pool
+		void destroy(IkEntity entity);
+
+		bool isAlive(IkEntity entity) const { return transforms.contains(entity); }
+		size_t size() const { return transforms.size(); }
+
+		void addModel(IkEntity entity, ModelComponent model);
+		//the model of a static entity is baked into the recorded static draws, swapping it re-records them
+		void setModel(IkEntity entity, std::shared_ptr<ikEngineModel> model);
+		void removeModel(IkEntity entity);
+		void reserveModels(size_t count) { models.reserve(count); }
+		const IkComponentPool<ModelComponent>& getModels() const { return models; }
+		uint64_t getStaticGeneration() const { return staticGeneration; }
+
+		IkComponentPool<TransformComponent> transforms;
+		IkComponentPool<PointLightComponent> pointLights;
+		IkComponentPool<ColorComponent> colors;
+
+	private:
+		IkComponentPool<ModelComponent> models;
+		IkEntity nextEntity = 0;
+		uint64_t staticGeneration = 0;
+	};
+
+} //namepace
+#endif //header guard
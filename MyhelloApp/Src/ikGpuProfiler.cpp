@@ -0,0 +1,146 @@
+#include "ikGpuProfiler.hpp"
+
+//std
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <stdexcept>
+namespace ikE {
+
+	IkGpuProfiler::IkGpuProfiler(IkeDeviceEngine& device, uint32_t frameCount) : ikeDevice{ device } {
+		uint32_t validBits = ikeDevice.graphicsTimestampValidBits();
+		supported = validBits > 0;
+		timestampPeriod = ikeDevice.properties.limits.timestampPeriod;
+		timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+		frames.resize(frameCount);
+		if (!supported) return;
+
+		VkQueryPoolCreateInfo queryPoolInfo{};
+		queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		queryPoolInfo.queryCount = 2 * MAX_SCOPES_PER_FRAME;
+
+		for (auto& frame : frames) {
+			if (vkCreateQueryPool(ikeDevice.device(), &queryPoolInfo, nullptr, &frame.queryPool) != VK_SUCCESS) {
+				throw std::runtime_error("failed to create timestamp query pool!");
+			}
+		}
+	}
+
+	IkGpuProfiler::~IkGpuProfiler() {
+		for (auto& frame : frames) {
+			vkDestroyQueryPool(ikeDevice.device(), frame.queryPool, nullptr);
+		}
+	}
+
+	void IkGpuProfiler::beginFrame(int frameIndex, VkCommandBuffer commandBuffer) {
+		currentFrame = frameIndex;
+		if (!supported) return;
+
+		FrameQueries& frame = frames[frameIndex];
+		if (!frame.scopeNames.empty()) {
+			collectResults(frame);
+			frame.scopeNames.clear();
+		}
+		//queries have to be reset before they are written again, including the first time
+		vkCmdResetQueryPool(commandBuffer, frame.queryPool, 0, 2 * MAX_SCOPES_PER_FRAME);
+	}
+
+	uint32_t IkGpuProfiler::beginScope(VkCommandBuffer commandBuffer, const std::string& name) {
+		assert(currentFrame >= 0 && "Can not begin a GPU scope before the first frame");
+		FrameQueries& frame = frames[currentFrame];
+		if (!supported || frame.scopeNames.size() == MAX_SCOPES_PER_FRAME) return INVALID_SCOPE;
+
+		uint32_t scope = static_cast<uint32_t>(frame.scopeNames.size());
+		frame.scopeNames.push_back(findName(name));
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.queryPool, 2 * scope);
+		return scope;
+	}
+
+	void IkGpuProfiler::endScope(VkCommandBuffer commandBuffer, uint32_t scope) {
+		if (scope == INVALID_SCOPE) return;
+		//bottom of pipe only signals once every command before it has finished all of its stages
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frames[currentFrame].queryPool, 2 * scope + 1);
+	}
+
+	void IkGpuProfiler::collectResults(FrameQueries& frame) {
+		//value and availability of every query, a scope that was never ended is simply not available.
+		//VK_NOT_READY only means some query was unavailable, the available ones are still written
+		uint32_t queryCount = 2 * static_cast<uint32_t>(frame.scopeNames.size());
+		std::vector<std::array<uint64_t, 2>> results(queryCount);
+		VkResult result = vkGetQueryPoolResults(
+			ikeDevice.device(),
+			frame.queryPool,
+			0,
+			queryCount,
+			results.size() * sizeof(results[0]),
+			results.data(),
+			sizeof(results[0]),
+			VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+		if (result != VK_SUCCESS && result != VK_NOT_READY) {
+			throw std::runtime_error("failed to read timestamp queries!");
+		}
+
+		std::vector<double> frameTotals(histories.size(), 0.0);
+		std::vector<bool> measured(histories.size(), false);
+		for (size_t scope = 0; scope < frame.scopeNames.size(); scope++) {
+			const auto& begin = results[2 * scope];
+			const auto& end = results[2 * scope + 1];
+			if (begin[1] == 0 || end[1] == 0) continue;
+
+			uint64_t ticks = (end[0] - begin[0]) & timestampMask;
+			uint32_t name = frame.scopeNames[scope];
+			frameTotals[name] += static_cast<double>(ticks) * timestampPeriod / 1000000.0;
+			measured[name] = true;
+		}
+
+		for (size_t name = 0; name < histories.size(); name++) {
+			if (!measured[name]) continue;
+			ScopeHistory& history = histories[name];
+			if (history.samples.size() < HISTORY_SIZE) {
+				history.samples.push_back(frameTotals[name]);
+			}
+			else {
+				history.samples[history.nextSample] = frameTotals[name];
+			}
+			history.nextSample = (history.nextSample + 1) % HISTORY_SIZE;
+		}
+	}
+
+	uint32_t IkGpuProfiler::findName(const std::string& name) {
+		for (uint32_t i = 0; i < histories.size(); i++) {
+			if (histories[i].name == name) return i;
+		}
+		histories.push_back(ScopeHistory{ name });
+		return static_cast<uint32_t>(histories.size() - 1);
+	}
+
+	std::vector<IkGpuProfiler::ScopeStats> IkGpuProfiler::getStats() const {
+		std::vector<ScopeStats> stats;
+		for (const auto& history : histories) {
+			if (history.samples.empty()) continue;
+
+			std::vector<double> sorted = history.samples;
+			std::sort(sorted.begin(), sorted.end());
+			//nearest rank, so p99 of a short history is its slowest frame rather than an interpolation
+			auto percentile = [&](double p) {
+				size_t rank = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+				return sorted[rank];
+			};
+
+			ScopeStats scopeStats{};
+			scopeStats.name = history.name;
+			scopeStats.sampleCount = sorted.size();
+			for (double sample : sorted) scopeStats.averageMs += sample;
+			scopeStats.averageMs /= sorted.size();
+			scopeStats.p50Ms = percentile(.5);
+			scopeStats.p95Ms = percentile(.95);
+			scopeStats.p99Ms = percentile(.99);
+			scopeStats.maxMs = sorted.back();
+			stats.push_back(scopeStats);
+		}
+		return stats;
+	}
+
+}//namespace ikE
@@ -0,0 +1,80 @@
+#ifndef IKGPUPROFILER_HPP
+#define IKGPUPROFILER_HPP
+
+#include "ikDeviceEngine.hpp"
+
+//std
+#include <string>
+#include <vector>
+namespace ikE {
+	/*IkGpuProfiler measures how long the GPU spends in named scopes of a frame.
+	  every scope is a pair of vkCmdWriteTimestamp into the query pool of the frame in flight that recorded it.
+	  beginFrame() is called once the frame that last used its index has finished, so the queries written the last time the same frame
+	  index was used are read back without waiting, converted to milliseconds with timestampPeriod and reset.
+	  a scope that is used several times in a frame (one per render pass, or a system called twice) adds up to one
+	  sample per frame, the last HISTORY_SIZE samples of every scope give its rolling average and percentiles.
+	  scopes are recorded from the thread that records the primary command buffer only*/
+	class IkGpuProfiler {
+	public:
+		static constexpr uint32_t MAX_SCOPES_PER_FRAME = 64;
+		static constexpr size_t HISTORY_SIZE = 256;
+		//returned by beginScope when the queue has no timestamps or the frame ran out of queries, endScope ignores it
+		static constexpr uint32_t INVALID_SCOPE = 0xffffffff;
+
+		struct ScopeStats {
+			std::string name;
+			size_t sampleCount;
+			double averageMs;
+			double p50Ms;
+			double p95Ms;
+			double p99Ms;
+			double maxMs;
+		};
+
+		IkGpuProfiler(IkeDeviceEngine& device, uint32_t frameCount);
+		~IkGpuProfiler();
+
+		IkGpuProfiler(const IkGpuProfiler&) = delete;
+		IkGpuProfiler& operator =(const IkGpuProfiler&) = delete;
+
+		//false when the graphics queue does not support timestamps, every scope is then INVALID_SCOPE
+		bool isSupported() const { return supported; }
+
+		//collects the results the frame's queries held and resets its query pool, commandBuffer must be outside
+		//of a render pass and is the first thing the frame submits
+		void beginFrame(int frameIndex, VkCommandBuffer commandBuffer);
+		uint32_t beginScope(VkCommandBuffer commandBuffer, const std::string& name);
+		void endScope(VkCommandBuffer commandBuffer, uint32_t scope);
+
+		//one entry per scope name that has at least one sample, in the order the scopes were first seen
+		std::vector<ScopeStats> getStats() const;
+
+	private:
+		//the scopes recorded into one frame's query pool, scope i owns queries 2*i and 2*i+1
+		struct FrameQueries {
+			VkQueryPool queryPool = VK_NULL_HANDLE;
+			std::vector<uint32_t> scopeNames;
+		};
+
+		//ring buffer of the per frame totals of one scope name
+		struct ScopeHistory {
+			std::string name;
+			std::vector<double> samples;
+			size_t nextSample = 0;
+		};
+
+		void collectResults(FrameQueries& frame);
+		uint32_t findName(const std::string& name);
+
+		IkeDeviceEngine& ikeDevice;
+		bool supported{ false };
+		float timestampPeriod{ 1.f }; //nanoseconds per tick
+		uint64_t timestampMask{ 0 }; //only timestampValidBits of a result are meaningful
+
+		std::vector<FrameQueries> frames;
+		int currentFrame{ -1 };
+		std::vector<ScopeHistory> histories;
+	};
+
+} //namepace
+#endif //header guard
@@ -0,0 +1,151 @@
+#include "ikImageReader.hpp"
+
+//std
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+namespace ikE {
+
+	namespace {
+		constexpr size_t TGA_HEADER_SIZE = 18;
+		constexpr uint8_t TGA_TRUE_COLOR = 2;
+		constexpr uint8_t TGA_GREY = 3;
+		constexpr uint8_t TGA_RLE_TRUE_COLOR = 10;
+		constexpr uint8_t TGA_RLE_GREY = 11;
+		//image descriptor bits
+		constexpr uint8_t TGA_RIGHT_TO_LEFT = 0x10;
+		constexpr uint8_t TGA_TOP_TO_BOTTOM = 0x20;
+
+		uint16_t readLittleEndian16(const uint8_t* data) {
+			return static_cast<uint16_t>(data[0] | (data[1] << 8));
+		}
+
+		//TGA stores BGR(A) or a single grey value
+		void toRgba(const uint8_t* pixel, uint32_t bytesPerPixel, uint8_t* out) {
+			if (bytesPerPixel == 1) {
+				out[0] = out[1] = out[2] = pixel[0];
+				out[3] = 255;
+				return;
+			}
+			out[0] = pixel[2];
+			out[1] = pixel[1];
+			out[2] = pixel[0];
+			out[3] = bytesPerPixel == 4 ? pixel[3] : 255;
+		}
+
+		DecodedImage readTga(const std::string& filepath, const std::vector<uint8_t>& file) {
+			if (file.size() < TGA_HEADER_SIZE) {
+				throw std::runtime_error("failed to read TGA header: " + filepath);
+			}
+			const uint8_t* header = file.data();
+			uint8_t idLength = header[0];
+			uint8_t colorMapType = header[1];
+			uint8_t imageType = header[2];
+			uint32_t width = readLittleEndian16(header + 12);
+			uint32_t height = readLittleEndian16(header + 14);
+			uint32_t bytesPerPixel = header[16] / 8;
+			uint8_t descriptor = header[17];
+
+			bool grey = imageType == TGA_GREY || imageType == TGA_RLE_GREY;
+			bool rle = imageType == TGA_RLE_TRUE_COLOR || imageType == TGA_RLE_GREY;
+			if (colorMapType != 0 || (!grey && imageType != TGA_TRUE_COLOR && !rle)) {
+				throw std::runtime_error("unsupported TGA image type: " + filepath);
+			}
+			if ((grey && bytesPerPixel != 1) || (!grey && bytesPerPixel != 3 && bytesPerPixel != 4)) {
+				throw std::runtime_error("unsupported TGA pixel depth: " + filepath);
+			}
+			if (width == 0 || height == 0) {
+				throw std::runtime_error("TGA image is empty: " + filepath);
+			}
+
+			//decoded in file order first, the rows and columns are put in place below
+			size_t pixelCount = static_cast<size_t>(width) * height;
+			std::vector<uint8_t> pixels(pixelCount * 4);
+			size_t offset = TGA_HEADER_SIZE + idLength;
+			size_t decoded = 0;
+			auto readPixel = [&](uint8_t* out) {
+				if (offset + bytesPerPixel > file.size()) {
+					throw std::runtime_error("TGA pixel data is truncated: " + filepath);
+				}
+				toRgba(file.data() + offset, bytesPerPixel, out);
+				offset += bytesPerPixel;
+			};
+			while (decoded < pixelCount) {
+				if (!rle) {
+					readPixel(&pixels[decoded * 4]);
+					decoded++;
+					continue;
+				}
+				//a packet header holds the pixel count minus one, the high bit marks a run of one repeated pixel
+				if (offset >= file.size()) {
+					throw std::runtime_error("TGA pixel data is truncated: " + filepath);
+				}
+				uint8_t packet = file[offset++];
+				size_t count = (packet & 0x7f) + 1u;
+				if (decoded + count > pixelCount) {
+					throw std::runtime_error("TGA run exceeds the image: " + filepath);
+				}
+				if (packet & 0x80) {
+					readPixel(&pixels[decoded * 4]);
+					for (size_t i = 1; i < count; i++) {
+						std::memcpy(&pixels[(decoded + i) * 4], &pixels[decoded * 4], 4);
+					}
+				}
+				else {
+					for (size_t i = 0; i < count; i++) {
+						readPixel(&pixels[(decoded + i) * 4]);
+					}
+				}
+				decoded += count;
+			}
+
+			DecodedImage image{};
+			image.width = width;
+			image.height = height;
+			bool flipRows = (descriptor & TGA_TOP_TO_BOTTOM) == 0; // bottom up unless the descriptor says otherwise
+			bool flipColumns = (descriptor & TGA_RIGHT_TO_LEFT) != 0;
+			if (!flipRows && !flipColumns) {
+				image.rgba = std::move(pixels);
+				return image;
+			}
+			image.rgba.resize(pixels.size());
+			for (uint32_t y = 0; y < height; y++) {
+				uint32_t srcY = flipRows ? height - 1 - y : y;
+				for (uint32_t x = 0; x < width; x++) {
+					uint32_t srcX = flipColumns ? width - 1 - x : x;
+					std::memcpy(
+						&image.rgba[(static_cast<size_t>(y) * width + x) * 4],
+						&pixels[(static_cast<size_t>(srcY) * width + srcX) * 4],
+						4);
+				}
+			}
+			return image;
+		}
+
+		bool hasExtension(const std::string& filepath, const char* extension) {
+			size_t length = std::strlen(extension);
+			if (filepath.size() < length) return false;
+			for (size_t i = 0; i < length; i++) {
+				char c = filepath[filepath.size() - length + i];
+				if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+				if (c != extension[i]) return false;
+			}
+			return true;
+		}
+	}
+
+	DecodedImage readImage(const std::string& filepath) {
+		if (!hasExtension(filepath, ".tga")) {
+			throw std::runtime_error("unsupported image format, only TGA can be read: " + filepath);
+		}
+
+		std::ifstream file{ filepath, std::ios::binary };
+		if (!file.is_open()) {
+			throw std::runtime_error("failed to open file: " + filepath);
+		}
+		std::vector<uint8_t> bytes{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+		return readTga(filepath, bytes);
+	}
+
+}//namespace ikE
@@ -0,0 +1,22 @@
+#ifndef IKIMAGEREADER_HPP
+#define IKIMAGEREADER_HPP
+
+//std
+#include <cstdint>
+#include <string>
+#include <vector>
+namespace ikE {
+	//tightly packed RGBA8 rows, the first row is the top of the image
+	struct DecodedImage {
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<uint8_t> rgba;
+	};
+
+	/*reads a texture from disk as RGBA8. like ikImageWriter it needs no image library, so only TGA is read:
+	  true color (24 or 32 bit) and greyscale (8 bit), raw or run length encoded. color mapped TGAs and any other
+	  format throw. safe to call from any thread*/
+	DecodedImage readImage(const std::string& filepath);
+
+} //namepace
+#endif //header guard
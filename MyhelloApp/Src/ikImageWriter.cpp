@@ -0,0 +1,130 @@
+#include "ikImageWriter.hpp"
+
+//std
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <fstream>
+#include <stdexcept>
+namespace ikE {
+
+	namespace {
+		//largest payload of one deflate stored block
+		constexpr size_t MAX_STORED_BLOCK = 65535;
+
+		uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0) {
+			static const std::array<uint32_t, 256> table = [] {
+				std::array<uint32_t, 256> t{};
+				for (uint32_t n = 0; n < 256; n++) {
+					uint32_t c = n;
+					for (int k = 0; k < 8; k++) {
+						c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+					}
+					t[n] = c;
+				}
+				return t;
+			}();
+
+			crc = ~crc;
+			for (size_t i = 0; i < size; i++) {
+				crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+			}
+			return ~crc;
+		}
+
+		uint32_t adler32(const std::vector<uint8_t>& data) {
+			uint32_t a = 1, b = 0;
+			for (uint8_t byte : data) {
+				a = (a + byte) % 65521;
+				b = (b + a) % 65521;
+			}
+			return (b << 16) | a;
+		}
+
+		void appendBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+			out.push_back(static_cast<uint8_t>(value >> 24));
+			out.push_back(static_cast<uint8_t>(value >> 16));
+			out.push_back(static_cast<uint8_t>(value >> 8));
+			out.push_back(static_cast<uint8_t>(value));
+		}
+
+		//length, type, data, then the crc over type and data
+		void writeChunk(std::ofstream& file, const char type[4], const std::vector<uint8_t>& data) {
+			std::vector<uint8_t> chunk;
+			chunk.reserve(data.size() + 12);
+			appendBigEndian(chunk, static_cast<uint32_t>(data.size()));
+			chunk.insert(chunk.end(), type, type + 4);
+			chunk.insert(chunk.end(), data.begin(), data.end());
+			appendBigEndian(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+			file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+		}
+	}
+
+	void writePng(const std::string& filepath, uint32_t width, uint32_t height, const std::vector<uint8_t>& rgba) {
+		assert(rgba.size() == static_cast<size_t>(width) * height * 4 && "Pixel data does not match the image size");
+
+		std::ofstream file{ filepath, std::ios::binary };
+		if (!file) {
+			throw std::runtime_error("failed to open file: " + filepath);
+		}
+
+		static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+		file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+		std::vector<uint8_t> header;
+		appendBigEndian(header, width);
+		appendBigEndian(header, height);
+		header.push_back(8); //bit depth
+		header.push_back(6); //color type RGBA
+		header.push_back(0); //deflate
+		header.push_back(0); //adaptive filtering
+		header.push_back(0); //no interlace
+		writeChunk(file, "IHDR", header);
+
+		//every scanline starts with filter type 0, the rows are stored as they are
+		size_t rowSize = static_cast<size_t>(width) * 4;
+		std::vector<uint8_t> scanlines;
+		scanlines.reserve((rowSize + 1) * height);
+		for (uint32_t y = 0; y < height; y++) {
+			scanlines.push_back(0);
+			scanlines.insert(scanlines.end(), rgba.begin() + y * rowSize, rgba.begin() + (y + 1) * rowSize);
+		}
+
+		//zlib stream made of stored blocks: header, blocks of at most 64KiB, adler32 of the uncompressed data
+		std::vector<uint8_t> zlib;
+		zlib.reserve(scanlines.size() + scanlines.size() / MAX_STORED_BLOCK * 5 + 16);
+		zlib.push_back(0x78);
+		zlib.push_back(0x01);
+		size_t offset = 0;
+		do {
+			size_t blockSize = std::min(MAX_STORED_BLOCK, scanlines.size() - offset);
+			bool last = offset + blockSize == scanlines.size();
+			zlib.push_back(last ? 1 : 0);
+			zlib.push_back(static_cast<uint8_t>(blockSize));
+			zlib.push_back(static_cast<uint8_t>(blockSize >> 8));
+			zlib.push_back(static_cast<uint8_t>(~blockSize));
+			zlib.push_back(static_cast<uint8_t>(~blockSize >> 8));
+			zlib.insert(zlib.end(), scanlines.begin() + offset, scanlines.begin() + offset + blockSize);
+			offset += blockSize;
+		} while (offset < scanlines.size());
+		appendBigEndian(zlib, adler32(scanlines));
+		writeChunk(file, "IDAT", zlib);
+
+		writeChunk(file, "IEND", {});
+		if (!file) {
+			throw std::runtime_error("failed to write file: " + filepath);
+		}
+	}
+
+	void writeRaw(const std::string& filepath, const std::vector<uint8_t>& rgba) {
+		std::ofstream file{ filepath, std::ios::binary };
+		if (!file) {
+			throw std::runtime_error("failed to open file: " + filepath);
+		}
+		file.write(reinterpret_cast<const char*>(rgba.data()), rgba.size());
+		if (!file) {
+			throw std::runtime_error("failed to write file: " + filepath);
+		}
+	}
+
+}//namespace ikE
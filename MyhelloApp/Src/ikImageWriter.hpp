@@ -0,0 +1,16 @@
+#ifndef IKIMAGEWRITER_HPP
+#define IKIMAGEWRITER_HPP
+
+//std
+#include <cstdint>
+#include <string>
+#include <vector>
+namespace ikE {
+	/*writes tightly packed RGBA8 rows, as read back from a headless frame, to disk.
+	  the PNG is stored uncompressed (deflate stored blocks) so no image library is needed, any viewer opens it.
+	  the raw file is just the pixel bytes, width and height are not recorded*/
+	void writePng(const std::string& filepath, uint32_t width, uint32_t height, const std::vector<uint8_t>& rgba);
+	void writeRaw(const std::string& filepath, const std::vector<uint8_t>& rgba);
+
+} //namepace
+#endif //header guard
@@ -0,0 +1,75 @@
+#include "ikMappedFile.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//std
+#include <stdexcept>
+namespace ikE {
+
+#ifdef _WIN32
+	IkMappedFile::IkMappedFile(const std::string& filepath) {
+		HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			throw std::runtime_error("failed to open file: " + filepath);
+		}
+		LARGE_INTEGER fileSize{};
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+			CloseHandle(file);
+			throw std::runtime_error("failed to map empty file: " + filepath);
+		}
+
+		//the view keeps the mapping alive, both handles can be closed once it exists
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (mapping == nullptr) {
+			throw std::runtime_error("failed to map file: " + filepath);
+		}
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if (view == nullptr) {
+			throw std::runtime_error("failed to map file: " + filepath);
+		}
+		mapped = static_cast<const uint8_t*>(view);
+		mappedSize = static_cast<size_t>(fileSize.QuadPart);
+	}
+
+	IkMappedFile::~IkMappedFile() {
+		UnmapViewOfFile(mapped);
+	}
+#else
+	IkMappedFile::IkMappedFile(const std::string& filepath) {
+		int file = open(filepath.c_str(), O_RDONLY);
+		if (file < 0) {
+			throw std::runtime_error("failed to open file: " + filepath);
+		}
+		struct stat fileInfo {};
+		if (fstat(file, &fileInfo) != 0 || fileInfo.st_size == 0) {
+			close(file);
+			throw std::runtime_error("failed to map empty file: " + filepath);
+		}
+
+		//the mapping holds its own reference to the file
+		void* view = mmap(nullptr, static_cast<size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+		if (view == MAP_FAILED) {
+			throw std::runtime_error("failed to map file: " + filepath);
+		}
+		mapped = static_cast<const uint8_t*>(view);
+		mappedSize = static_cast<size_t>(fileInfo.st_size);
+	}
+
+	IkMappedFile::~IkMappedFile() {
+		munmap(const_cast<uint8_t*>(mapped), mappedSize);
+	}
+#endif
+
+}//namespace ikE
@@ -0,0 +1,28 @@
+#ifndef IKMAPPEDFILE_HPP
+#define IKMAPPEDFILE_HPP
+
+//std
+#include <cstddef>
+#include <cstdint>
+#include <string>
+namespace ikE {
+	/*IkMappedFile maps a whole file read only into memory (mmap, MapViewOfFile on windows), so large assets are paged
+	  in by the OS as they are read instead of being copied into a buffer first. the mapping lives as long as the object*/
+	class IkMappedFile {
+	public:
+		explicit IkMappedFile(const std::string& filepath);
+		~IkMappedFile();
+
+		IkMappedFile(const IkMappedFile&) = delete;
+		IkMappedFile& operator =(const IkMappedFile&) = delete;
+
+		const uint8_t* data() const { return mapped; }
+		size_t size() const { return mappedSize; }
+
+	private:
+		const uint8_t* mapped = nullptr;
+		size_t mappedSize = 0;
+	};
+
+} //namepace
+#endif //header guard
@@ -1,7 +1,7 @@
 #include "ikPipeline.hpp"
 #include "ikEngineModel.hpp"
+#include "ikUtils.hpp"
 //std
-#include <fstream>
 #include <stdexcept>
 #include <iostream>
 #include <cassert>
@@ -11,73 +11,33 @@ namespace ikE {
 
     /* notice how we start the constructor by using the aggregate relationship instance IkeDevice and using the reference of IkeDeviceEngine device as an argument*/
     ikePipeline::ikePipeline(IkeDeviceEngine& device, 
-                             const std::string& vertFilepath, 
-                             const std::string& fragFilepath, 
+                             VkShaderModule vertShaderModule, 
+                             VkShaderModule fragShaderModule, 
                              const PipelineConfigInfo& configInfo) : IkeDevice(device){
-        createGraphicsPipeline(configInfo,vertFilepath, fragFilepath);
+        createGraphicsPipeline(configInfo, vertShaderModule, fragShaderModule);
     }
 
     //destructor
+    //the shader modules belong to IkShaderRegistry, a linked pipeline does not need them anymore
     ikePipeline::~ikePipeline() {
-        vkDestroyShaderModule(IkeDevice.device(), vertShaderModule, nullptr);
-        vkDestroyShaderModule(IkeDevice.device(), fragShaderModule, nullptr);
         vkDestroyPipeline(IkeDevice.device(), graphicsPipeline, nullptr);
     }
 
-     std::vector<char> ikePipeline::readFile(const std::string& filepath) {
-
-         // with the input file stream we can read from the file and its
-         // argument are 3 . the file, ios::ate opens the file and move
-         // the read pointer to the end so that we can get the size
-         // we can know the size immediately using tellg
-        std::ifstream file(filepath, std::ios::ate | std::ios::binary);
-        //throws error if the file can not be opened
-        if (!file.is_open()) {
-            throw std::runtime_error("failed to open file" + filepath);
-        }
-        //we get the file size 
-        // there will be no runtime checks because of static_cast
-        // tellg returns the current position of the file pointer which
-        //is because of set::ios::ate meaning at the end of file
-        // so we know the file size thanks to tellg()
-        size_t fileSize = static_cast<size_t>(file.tellg());
-
-        // we allocate buffer for the file we want to read via a vector with type char and the file size
-        std::vector<char> buffer(fileSize);
-
-        // seekg() sets the position of the input pointer it can also jump to 
-        // a specific position if we want but here we move back to 0 index
-        // meaning it moves the file pointer back to the 
-        // beginning so we can read it
-        file.seekg(0);
-        // we read the data and we also have the size
-        // meaning we will read the file data until we get to the end of the file
-        file.read(buffer.data(), fileSize);
-        //we close the file and return the buffer
-        file.close();
-        return buffer;
-    }
-
      // in crateGraphicsPipelin we have the PipelineConfigInfo struct that has
-     // the whole pipe line states the vert and frag file paths
-     //
-     // we call the readFile() function to read both files
+     // the whole pipe line states and the vert and frag shader modules
      //
     void ikePipeline::createGraphicsPipeline(const PipelineConfigInfo& configInfo,
-                                             const std::string& vertFilepath,
-                                             const std::string& fragFilepath) {
+                                             VkShaderModule vertShaderModule,
+                                             VkShaderModule fragShaderModule) {
         
         assert(configInfo.pipelineLayout != VK_NULL_HANDLE &&
             "can not create graphics pipeline :: no pipelineLayout provided in configInfo");
 
         assert(configInfo.renderPass != VK_NULL_HANDLE &&
             "can not create graphics pipeline :: no renderPass provided in configInfo");
-        //we read both frag and vert via readFile()
-        auto vertCode = readFile(vertFilepath);
-        auto fragCode = readFile(fragFilepath);
-
-        createShaderModule(vertCode, &vertShaderModule);
-        createShaderModule(fragCode, &fragShaderModule);
+        assert(vertShaderModule != VK_NULL_HANDLE && "can not create graphics pipeline :: no vertex shader");
+        //the fragment stage is optional, a depth only pipeline has nothing to shade
+        bool hasFragmentStage = fragShaderModule != VK_NULL_HANDLE;
         
         VkPipelineShaderStageCreateInfo shaderStages[2];
         shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -86,7 +46,10 @@ namespace ikE {
         shaderStages[0].pName = "main";
         shaderStages[0].flags = 0;
         shaderStages[0].pNext = nullptr;
-        shaderStages[0].pSpecializationInfo = nullptr;
+        VkSpecializationInfo specializationInfo = configInfo.specialization.info();
+        const VkSpecializationInfo* pSpecializationInfo =
+            configInfo.specialization.empty() ? nullptr : &specializationInfo;
+        shaderStages[0].pSpecializationInfo = pSpecializationInfo;
 
         shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
@@ -94,7 +57,7 @@ namespace ikE {
         shaderStages[1].pName = "main";
         shaderStages[1].flags = 0;
         shaderStages[1].pNext = nullptr;
-        shaderStages[1].pSpecializationInfo = nullptr;
+        shaderStages[1].pSpecializationInfo = pSpecializationInfo;
 
         //we tell our pipeline to use the ikEngineModel here
         auto &bindingDescriptions = configInfo.bindingDescriptions;
@@ -113,16 +76,23 @@ namespace ikE {
 
 
      
+        //a subpass with several color attachments needs one blend state per attachment
+        std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachments(
+            configInfo.colorAttachmentCount, configInfo.colorBlendAttachment);
+        VkPipelineColorBlendStateCreateInfo colorBlendInfo = configInfo.colorBlendInfo;
+        colorBlendInfo.attachmentCount = static_cast<uint32_t>(colorBlendAttachments.size());
+        colorBlendInfo.pAttachments = colorBlendAttachments.data();
+
         VkGraphicsPipelineCreateInfo pipelineInfo{};
         pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        pipelineInfo.stageCount = 2;
+        pipelineInfo.stageCount = hasFragmentStage ? 2 : 1;
         pipelineInfo.pStages = shaderStages;
         pipelineInfo.pVertexInputState = &vertexInputInfo;
         pipelineInfo.pInputAssemblyState = &configInfo.inputAssemblyInfo;
         pipelineInfo.pViewportState = &configInfo.viewportInfo;
         pipelineInfo.pRasterizationState = &configInfo.rasterizationInfo;
         pipelineInfo.pMultisampleState = &configInfo.multisampleInfo;
-        pipelineInfo.pColorBlendState = &configInfo.colorBlendInfo;
+        pipelineInfo.pColorBlendState = &colorBlendInfo;
         pipelineInfo.pDepthStencilState = &configInfo.depthStencilInfo;
         pipelineInfo.pDynamicState = &configInfo.dynamicStateInfo;
 
@@ -134,7 +104,7 @@ namespace ikE {
         pipelineInfo.basePipelineIndex = -1;
         pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-        if (vkCreateGraphicsPipelines(IkeDevice.device(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &graphicsPipeline) != VK_SUCCESS) {
+        if (vkCreateGraphicsPipelines(IkeDevice.device(), IkeDevice.pipelineCache(), 1, &pipelineInfo, nullptr, &graphicsPipeline) != VK_SUCCESS) {
             throw std::runtime_error(" failed to create graphics pipeline");
         }
 
@@ -142,30 +112,73 @@ namespace ikE {
     }
 
 
-    //createShaderModule is responsible for creating the frag and vert shader modules
-    // it has two arguments a dynamic array with a reference code and VkShaderModule which is a handle
-    // that is responsible for where the shader modules will be stored
-    void ikePipeline::createShaderModule(const std::vector<char>& code, VkShaderModule* shaderModule) {
-        //we declare and zero initializes a VkShaderModuleCreateInfo struct
-        // that will hold the information needed to create a vulkan shader module
-       
-        VkShaderModuleCreateInfo createInfo{};
-        //.sType this is required by vulkan to identify the type of structure
-        //.codeSize sets the field to the size in bytes of shader bytecode
-        //  and it tells the vulkan how large the shader code is
-        //.pCode expects a pointer to uint32_t because SPIR-v bytecode
-        // is and array of 32-bit words
-         // we need reinterpret_cast because of unrelated types or pointers
-        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        createInfo.codeSize = code.size();
-        createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
-        // we then call vkCreateShaderModule()
-        if (vkCreateShaderModule(IkeDevice.device(), &createInfo, nullptr, shaderModule) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create shader module");
+    void ShaderSpecialization::set(uint32_t constantId, uint32_t value) {
+        for (auto& entry : entries) {
+            if (entry.constantID == constantId) {
+                data[entry.offset / sizeof(uint32_t)] = value;
+                return;
+            }
         }
+        VkSpecializationMapEntry entry{};
+        entry.constantID = constantId;
+        entry.offset = static_cast<uint32_t>(data.size() * sizeof(uint32_t));
+        entry.size = sizeof(uint32_t);
+        entries.push_back(entry);
+        data.push_back(value);
+    }
+
+    VkSpecializationInfo ShaderSpecialization::info() const {
+        VkSpecializationInfo specializationInfo{};
+        specializationInfo.mapEntryCount = static_cast<uint32_t>(entries.size());
+        specializationInfo.pMapEntries = entries.data();
+        specializationInfo.dataSize = data.size() * sizeof(uint32_t);
+        specializationInfo.pData = data.data();
+        return specializationInfo;
+    }
 
+    PipelinePermutation ikePipeline::permutation(const std::string& vertFilepath, const std::string& fragFilepath, const PipelineConfigInfo& configInfo) {
+        PipelinePermutation permutation{};
+        permutation.vertFilepath = vertFilepath;
+        permutation.fragFilepath = fragFilepath;
+        permutation.pipelineLayout = configInfo.pipelineLayout;
+        permutation.renderPass = configInfo.renderPass;
+        permutation.state = {
+            configInfo.subpass,
+            configInfo.colorAttachmentCount,
+            static_cast<uint32_t>(configInfo.inputAssemblyInfo.topology),
+            static_cast<uint32_t>(configInfo.rasterizationInfo.polygonMode),
+            static_cast<uint32_t>(configInfo.rasterizationInfo.cullMode),
+            static_cast<uint32_t>(configInfo.rasterizationInfo.frontFace),
+            static_cast<uint32_t>(configInfo.depthStencilInfo.depthTestEnable),
+            static_cast<uint32_t>(configInfo.depthStencilInfo.depthWriteEnable),
+            static_cast<uint32_t>(configInfo.depthStencilInfo.depthCompareOp),
+            static_cast<uint32_t>(configInfo.colorBlendAttachment.blendEnable),
+            static_cast<uint32_t>(configInfo.colorBlendAttachment.colorWriteMask) };
+        std::vector<uint32_t>& state = permutation.state;
+        state.push_back(static_cast<uint32_t>(configInfo.bindingDescriptions.size()));
+        for (const auto& binding : configInfo.bindingDescriptions) {
+            state.insert(state.end(), { binding.binding, binding.stride, static_cast<uint32_t>(binding.inputRate) });
+        }
+        state.push_back(static_cast<uint32_t>(configInfo.attributeDescriptions.size()));
+        for (const auto& attribute : configInfo.attributeDescriptions) {
+            state.insert(state.end(), { attribute.location, attribute.binding, static_cast<uint32_t>(attribute.format), attribute.offset });
+        }
+        state.push_back(static_cast<uint32_t>(configInfo.specialization.entries.size()));
+        for (const auto& entry : configInfo.specialization.entries) {
+            state.insert(state.end(), { entry.constantID, configInfo.specialization.data[entry.offset / sizeof(uint32_t)] });
+        }
+        return permutation;
+    }
 
+    size_t PipelinePermutation::Hash::operator()(const PipelinePermutation& permutation) const {
+        size_t seed = 0;
+        hashCombine(seed, permutation.vertFilepath, permutation.fragFilepath, permutation.pipelineLayout, permutation.renderPass);
+        for (uint32_t value : permutation.state) {
+            hashCombine(seed, value);
+        }
+        return seed;
     }
+
     //need explanation
     /*
       VK_PIPELINE_BIND_POINT_GRAPHICES specifies binding as a graphics pipeline
@@ -274,6 +287,16 @@ namespace ikE {
 
     }
 
+    /*the pre-pass only fills the depth buffer, the main pass then tests with EQUAL so the expensive fragment shader runs
+      once per pixel. color writes are masked off and the vertex input is the separate position stream of ikEngineModel*/
+    void ikePipeline::depthPrepassPipelineConfigInfo(PipelineConfigInfo& configInfo) {
+        defaultPipelineConfigInfo(configInfo);
+
+        configInfo.colorBlendAttachment.colorWriteMask = 0;
+        configInfo.bindingDescriptions = ikEngineModel::Vertex::getPositionBindingDescriptions();
+        configInfo.attributeDescriptions = ikEngineModel::Vertex::getPositionAttributeDescriptions();
+    }
+
 
 
 
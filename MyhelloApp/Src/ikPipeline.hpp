@@ -46,7 +46,21 @@ namespace ikE {
 
 
        */
+    /*values for the layout(constant_id = N) constants of the shaders. the same map is given to every stage, a stage
+      simply ignores ids it does not declare. the driver folds the values in when it compiles the pipeline, so loops
+      bounded by a constant can be unrolled and branches on it removed*/
+    struct ShaderSpecialization {
+        void set(uint32_t constantId, uint32_t value);
+        bool empty() const { return entries.empty(); }
+        //points into this struct, it must stay alive and unchanged while the pipeline is created
+        VkSpecializationInfo info() const;
+
+        std::vector<VkSpecializationMapEntry> entries{};
+        std::vector<uint32_t> data{};
+    };
+
     struct PipelineConfigInfo {
+        PipelineConfigInfo() = default;
         PipelineConfigInfo(const PipelineConfigInfo&) = delete;
         PipelineConfigInfo& operator = (const PipelineConfigInfo&) = delete;
        //new
@@ -68,17 +82,42 @@ namespace ikE {
         VkPipelineLayout pipelineLayout = nullptr;
         VkRenderPass renderPass = nullptr;
         uint32_t subpass = 0;
+        //number of color attachments in the subpass, each one gets colorBlendAttachment
+        uint32_t colorAttachmentCount = 1;
+        ShaderSpecialization specialization{};
+    };
+
+    /*everything that tells two pipelines apart: the shaders, layout, render pass and the fixed function state the
+      systems change, with the specialization values. state holds the numeric fields one after the other, the vertex
+      input and specialization lists are preceded by their length so no two configs flatten the same*/
+    struct PipelinePermutation {
+        std::string vertFilepath;
+        std::string fragFilepath;
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        std::vector<uint32_t> state{};
+
+        bool operator==(const PipelinePermutation& other) const {
+            return vertFilepath == other.vertFilepath && fragFilepath == other.fragFilepath &&
+                pipelineLayout == other.pipelineLayout && renderPass == other.renderPass && state == other.state;
+        }
+
+        struct Hash {
+            size_t operator()(const PipelinePermutation& permutation) const;
+        };
     };
 
     class ikePipeline {
     public:
         /* we will include IkeDeviceEngine , PipelineConfigInfo struct to the ikePipeline constructor and in createGraphicsPipeline we will include the PipelineConfigInfo struct
           then create a destructor notice that the danglin braces has no semicolon
+          the shader modules come from IkShaderRegistry and are only used while the pipeline is created,
+          a null fragShaderModule creates a vertex only pipeline, e.g for depth only passes
         
         */
         ikePipeline(IkeDeviceEngine& device,
-                     const std::string& vertFilepath, 
-                     const std::string& fragFilepath, const PipelineConfigInfo& configInfo);
+                     VkShaderModule vertShaderModule, 
+                     VkShaderModule fragShaderModule, const PipelineConfigInfo& configInfo);
         ~ikePipeline();
 
         //we delete the copy constructors
@@ -91,27 +130,22 @@ namespace ikE {
 
        // static PipelineConfigInfo defaultPipelineConfigInfo(uint32_t width, uint32_t height);
         static void defaultPipelineConfigInfo(PipelineConfigInfo& configInfo);
+        //depth pre-pass: positions only, writes depth and nothing else
+        static void depthPrepassPipelineConfigInfo(PipelineConfigInfo& configInfo);
 
-    private:
-        static std::vector<char> readFile(const std::string& filepath);
+        //two configs with equal permutations build the same pipeline
+        static PipelinePermutation permutation(const std::string& vertFilepath, const std::string& fragFilepath, const PipelineConfigInfo& configInfo);
 
+    private:
         /*GraphicsPipeline consist of multiple shader stages, multiple fixed function pipeline stages meaning we can not hard
           code this stage but only apply rules on how we want it to operate, and a pipeline layout*/
-        void createGraphicsPipeline(const PipelineConfigInfo& configInfo,const std::string& vertFilepath, const std::string& fragFilepath);
-
-        /* we will create a vector to our code and a pointer to the shaderModule  which is also a pointer making it shaderModule a pointer to a pointer
-        
-        */
-        void createShaderModule(const std::vector<char>&  code, VkShaderModule* shaderModule);
+        void createGraphicsPipeline(const PipelineConfigInfo& configInfo, VkShaderModule vertShaderModule, VkShaderModule fragShaderModule);
 
         /* we will instance IkeDeviceEngine using reference which makes it an agregate because it will outlive the rest functions
            notice the remaining handles are typedef pointers
         */
         IkeDeviceEngine& IkeDevice;
         VkPipeline graphicsPipeline;
-        // VkShaderModule is a handle
-        VkShaderModule vertShaderModule;
-        VkShaderModule fragShaderModule;
     };
 
 
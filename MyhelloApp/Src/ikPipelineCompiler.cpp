@@ -0,0 +1,83 @@
+#include "ikPipelineCompiler.hpp"
+#include "ikCpuProfiler.hpp"
+
+//std
+#include <cassert>
+#include <exception>
+namespace ikE {
+
+	IkPipelineHandle::~IkPipelineHandle() { wait(); }
+
+	IkPipelineHandle& IkPipelineHandle::operator =(IkPipelineHandle other) {
+		wait();
+		future = std::move(other.future);
+		return *this;
+	}
+
+	IkPipelineCompiler::IkPipelineCompiler(IkeDeviceEngine& device, uint32_t threadCount)
+		: ikeDeviceEngine{ device }, shaderRegistry{ device }, buildPool{ threadCount } {}
+
+	IkPipelineCompiler::~IkPipelineCompiler() { waitAll(); }
+
+	IkPipelineHandle IkPipelineCompiler::compile(
+		const std::string& vertFilepath,
+		const std::string& fragFilepath,
+		std::unique_ptr<PipelineConfigInfo> configInfo) {
+		assert(configInfo != nullptr && "Cannot compile a pipeline without a config");
+
+		PipelinePermutation key = ikePipeline::permutation(vertFilepath, fragFilepath, *configInfo);
+		auto existing = pipelines.find(key);
+		if (existing != pipelines.end()) {
+			return existing->second;
+		}
+
+		//std::function needs a copyable task, so the promise and the config are shared with it
+		auto promise = std::make_shared<std::promise<std::shared_ptr<ikePipeline>>>();
+		std::shared_ptr<PipelineConfigInfo> config = std::move(configInfo);
+		std::shared_future<std::shared_ptr<ikePipeline>> future = promise->get_future().share();
+
+		//modules are acquired here so a missing shader throws at the call site, variants of one shader share its module
+		VkShaderModule vertModule = shaderRegistry.acquire(vertFilepath);
+		VkShaderModule fragModule = VK_NULL_HANDLE;
+		if (!fragFilepath.empty()) {
+			try {
+				fragModule = shaderRegistry.acquire(fragFilepath);
+			}
+			catch (...) {
+				shaderRegistry.release(vertFilepath);
+				throw;
+			}
+		}
+
+		buildPool.submit([this, promise, config, vertFilepath, fragFilepath, vertModule, fragModule] {
+			std::shared_ptr<ikePipeline> pipeline;
+			std::exception_ptr error;
+			try {
+				IK_PROFILE_ZONE("build pipeline");
+				pipeline = std::make_shared<ikePipeline>(ikeDeviceEngine, vertModule, fragModule, *config);
+			}
+			catch (...) {
+				error = std::current_exception();
+			}
+			//a linked pipeline no longer needs its modules. released before the promise is set,
+			//so once waitAll() returns no worker touches the registry any more
+			shaderRegistry.release(vertFilepath);
+			if (!fragFilepath.empty()) shaderRegistry.release(fragFilepath);
+
+			//the error goes to whoever uses the pipeline first, not to the next unrelated buildPool.wait()
+			if (error) promise->set_exception(error);
+			else promise->set_value(std::move(pipeline));
+		});
+
+		IkPipelineHandle handle{ std::move(future) };
+		pipelines.emplace(std::move(key), handle);
+		return handle;
+	}
+
+	void IkPipelineCompiler::waitAll() {
+		for (auto& kv : pipelines) {
+			kv.second.wait();
+		}
+	}
+
+}//namespace ikE
@@ -0,0 +1,78 @@
+#ifndef IKPIPELINECOMPILER_HPP
+#define IKPIPELINECOMPILER_HPP
+
+#include "ikDeviceEngine.hpp"
+#include "ikPipeline.hpp"
+#include "ikShaderRegistry.hpp"
+#include "ikThreadPool.hpp"
+
+//std
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+namespace ikE {
+	/*IkPipelineHandle is a pipeline that may still be compiling on a worker thread. the first use waits for it and
+	  rethrows whatever the build threw, after that it is a plain pointer. get() is const and safe to call from
+	  several recording threads at once. copies share the pipeline, which lives until the last copy is gone.
+	  destroying a handle waits for its build, because the build reads the pipeline layout and render pass
+	  that the owning system destroys next*/
+	class IkPipelineHandle {
+	public:
+		IkPipelineHandle() = default;
+		explicit IkPipelineHandle(std::shared_future<std::shared_ptr<ikePipeline>> future) : future{ std::move(future) } {}
+		~IkPipelineHandle();
+
+		IkPipelineHandle(const IkPipelineHandle&) = default;
+		IkPipelineHandle(IkPipelineHandle&&) = default;
+		IkPipelineHandle& operator =(IkPipelineHandle other);
+
+		ikePipeline& get() const { return *future.get(); }
+		ikePipeline& operator*() const { return get(); }
+		ikePipeline* operator->() const { return &get(); }
+		explicit operator bool() const { return future.valid(); }
+		//blocks until the build is done without rethrowing its error, for owners about to destroy what it reads
+		void wait() const {
+			if (future.valid()) future.wait();
+		}
+
+	private:
+		std::shared_future<std::shared_ptr<ikePipeline>> future;
+	};
+
+	/*IkPipelineCompiler builds pipelines on worker threads so the systems of a scene compile their shaders side by side
+	  instead of one after the other. every build goes through the device's pipeline cache, which vulkan synchronizes
+	  internally. the workers are the compiler's own, not the recording pool, whose wait() would then block a frame on
+	  builds it never asked for. waitAll() blocks until every build so far has finished.
+	  the compiler keeps every pipeline it built under its ikePipeline::permutation, so systems asking for the same
+	  config and specialization values share one pipeline, and the pipelines live as long as the compiler.
+	  shader modules are taken from the compiler's IkShaderRegistry and handed back as soon as the build is done*/
+	class IkPipelineCompiler {
+	public:
+		IkPipelineCompiler(IkeDeviceEngine& device, uint32_t threadCount = IkThreadPool::defaultThreadCount());
+		~IkPipelineCompiler();
+
+		IkPipelineCompiler(const IkPipelineCompiler&) = delete;
+		IkPipelineCompiler& operator =(const IkPipelineCompiler&) = delete;
+
+		//the config is handed over because the worker reads it after this returns, an empty fragFilepath builds
+		//a vertex only pipeline just like ikePipeline. a config that is already built is dropped and the existing
+		//pipeline returned
+		IkPipelineHandle compile(
+			const std::string& vertFilepath,
+			const std::string& fragFilepath,
+			std::unique_ptr<PipelineConfigInfo> configInfo);
+
+		void waitAll();
+
+	private:
+		IkeDeviceEngine& ikeDeviceEngine;
+		IkShaderRegistry shaderRegistry;
+		std::unordered_map<PipelinePermutation, IkPipelineHandle, PipelinePermutation::Hash> pipelines;
+		//declared last, so its workers are joined before anything they use is destroyed
+		IkThreadPool buildPool;
+	};
+
+} //namepace
+#endif //header guard
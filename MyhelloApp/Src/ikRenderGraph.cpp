@@ -0,0 +1,776 @@
+#include "ikRenderGraph.hpp"
+#include "ikGpuProfiler.hpp"
+
+//std
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <stdexcept>
+namespace ikE {
+
+	static constexpr VkAccessFlags WRITE_ACCESS = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+	IkRenderGraph::PassBuilder& IkRenderGraph::PassBuilder::writeColor(ResourceId resource) {
+		graph.addUse(pass, resource, Usage::ColorWrite, nullptr);
+		return *this;
+	}
+
+	IkRenderGraph::PassBuilder& IkRenderGraph::PassBuilder::writeColor(ResourceId resource, VkClearColorValue clear) {
+		VkClearValue clearValue{};
+		clearValue.color = clear;
+		graph.addUse(pass, resource, Usage::ColorWrite, &clearValue);
+		return *this;
+	}
+
+	IkRenderGraph::PassBuilder& IkRenderGraph::PassBuilder::writeDepth(ResourceId resource) {
+		graph.addUse(pass, resource, Usage::DepthWrite, nullptr);
+		return *this;
+	}
+
+	IkRenderGraph::PassBuilder& IkRenderGraph::PassBuilder::writeDepth(ResourceId resource, VkClearDepthStencilValue clear) {
+		VkClearValue clearValue{};
+		clearValue.depthStencil = clear;
+		graph.addUse(pass, resource, Usage::DepthWrite, &clearValue);
+		return *this;
+	}
+
+	IkRenderGraph::PassBuilder& IkRenderGraph::PassBuilder::readDepth(ResourceId resource) {
+		graph.addUse(pass, resource, Usage::DepthRead, nullptr);
+		return *this;
+	}
+
+	IkRenderGraph::PassBuilder& IkRenderGraph::PassBuilder::readInput(ResourceId resource) {
+		graph.addUse(pass, resource, Usage::InputRead, nullptr);
+		return *this;
+	}
+
+	IkRenderGraph::PassBuilder& IkRenderGraph::PassBuilder::sampleImage(ResourceId resource) {
+		graph.addUse(pass, resource, Usage::Sampled, nullptr);
+		return *this;
+	}
+
+	IkRenderGraph::IkRenderGraph(IkeDeviceEngine& device) : ikeDeviceEngine{ device } {}
+
+	IkRenderGraph::~IkRenderGraph() { destroyCompiled(); }
+
+	IkRenderGraph::ResourceId IkRenderGraph::importImage(const std::string& name, VkFormat format, VkImageLayout finalLayout) {
+		Resource resource{};
+		resource.name = name;
+		resource.format = format;
+		resource.imported = true;
+		resource.importedFinalLayout = finalLayout;
+		resources.push_back(std::move(resource));
+		return static_cast<ResourceId>(resources.size() - 1);
+	}
+
+	void IkRenderGraph::setImportedViews(ResourceId resource, const std::vector<VkImageView>& views) {
+		assert(resource < resources.size() && resources[resource].imported && "Only imported images have views set from outside");
+		resources[resource].importedViews = views;
+	}
+
+	IkRenderGraph::ResourceId IkRenderGraph::createImage(const std::string& name, VkFormat format) {
+		Resource resource{};
+		resource.name = name;
+		resource.format = format;
+		resource.imported = false;
+		resources.push_back(std::move(resource));
+		return static_cast<ResourceId>(resources.size() - 1);
+	}
+
+	IkRenderGraph::PassBuilder IkRenderGraph::addPass(const std::string& name) {
+		Pass pass{};
+		pass.name = name;
+		passes.push_back(std::move(pass));
+		return PassBuilder{ *this, static_cast<PassId>(passes.size() - 1) };
+	}
+
+	void IkRenderGraph::setExecute(PassId pass, std::function<void(FrameInfo&)> execute) {
+		assert(pass < passes.size() && "Pass out of range");
+		passes[pass].execute = std::move(execute);
+	}
+
+	void IkRenderGraph::addUse(PassId pass, ResourceId resource, Usage usage, const VkClearValue* clear) {
+		assert(pass < passes.size() && resource < resources.size() && "Pass or resource out of range");
+		assert(!compiled && "Passes can not change once the graph is compiled");
+		ResourceUse use{};
+		use.resource = resource;
+		use.usage = usage;
+		use.clear = clear != nullptr;
+		if (clear) use.clearValue = *clear;
+		passes[pass].uses.push_back(use);
+	}
+
+	void IkRenderGraph::compile(VkExtent2D extent, uint32_t frameCount) {
+		assert(frameCount > 0 && "Render graph needs at least one frame");
+		destroyCompiled();
+		this->extent = extent;
+		this->frameCount = frameCount;
+
+		cullPasses();
+		groupRenderPasses();
+		createImages();
+		createRenderPasses();
+		createFramebuffers();
+		compiled = true;
+	}
+
+	void IkRenderGraph::resize(VkExtent2D extent, IkDeletionQueue& deletionQueue) {
+		assert(compiled && "Render graph must be compiled before it is resized");
+		//frames in flight may still render into the old images, they are destroyed once those frames have finished
+		deletionQueue.retire(releaseSizedObjects());
+		this->extent = extent;
+
+		//passes, culling, grouping and the render passes only depend on formats, which the swap chain keeps
+		createImages();
+		createFramebuffers();
+	}
+
+	void IkRenderGraph::destroyCompiled() {
+		releaseSizedObjects()();
+
+		for (auto& renderPass : renderPasses) {
+			vkDestroyRenderPass(ikeDeviceEngine.device(), renderPass.renderPass, nullptr);
+		}
+		renderPasses.clear();
+		compiled = false;
+	}
+
+	std::function<void()> IkRenderGraph::releaseSizedObjects() {
+		std::vector<VkFramebuffer> framebuffers;
+		std::vector<VkImageView> views;
+		std::vector<VkImage> images;
+		std::vector<VkDeviceMemory> memorys;
+
+		for (auto& renderPass : renderPasses) {
+			framebuffers.insert(framebuffers.end(), renderPass.framebuffers.begin(), renderPass.framebuffers.end());
+			renderPass.framebuffers.clear();
+		}
+
+		for (auto& resource : resources) {
+			views.insert(views.end(), resource.imageViews.begin(), resource.imageViews.end());
+			images.insert(images.end(), resource.images.begin(), resource.images.end());
+			memorys.insert(memorys.end(), resource.imageMemorys.begin(), resource.imageMemorys.end());
+			resource.imageViews.clear();
+			resource.images.clear();
+			resource.imageMemorys.clear();
+		}
+
+		//freed after the images, which are the ones bound to it
+		for (auto& block : aliasBlocks) {
+			memorys.insert(memorys.end(), block.memorys.begin(), block.memorys.end());
+		}
+		aliasBlocks.clear();
+
+		transientMemorySize = 0;
+		aliasedMemorySize = 0;
+
+		VkDevice device = ikeDeviceEngine.device();
+		return [device, framebuffers, views, images, memorys]() {
+			for (auto framebuffer : framebuffers) {
+				vkDestroyFramebuffer(device, framebuffer, nullptr);
+			}
+			for (auto view : views) {
+				vkDestroyImageView(device, view, nullptr);
+			}
+			for (auto image : images) {
+				vkDestroyImage(device, image, nullptr);
+			}
+			for (auto memory : memorys) {
+				vkFreeMemory(device, memory, nullptr);
+			}
+		};
+	}
+
+	void IkRenderGraph::cullPasses() {
+		//walk the passes backwards, a pass is needed when it writes something a later needed pass or the frame's
+		//output still depends on. a cleared image does not depend on anything written before it
+		std::vector<bool> needed(resources.size(), false);
+		for (size_t i = 0; i < resources.size(); i++) {
+			needed[i] = resources[i].imported;
+		}
+
+		for (size_t i = passes.size(); i-- > 0;) {
+			Pass& pass = passes[i];
+			pass.culled = true;
+			for (const auto& use : pass.uses) {
+				bool writes = use.usage == Usage::ColorWrite || use.usage == Usage::DepthWrite;
+				if (writes && needed[use.resource]) pass.culled = false;
+			}
+			if (pass.culled) continue;
+
+			for (const auto& use : pass.uses) {
+				if (use.clear) needed[use.resource] = false;
+			}
+			for (const auto& use : pass.uses) {
+				if (!use.clear) needed[use.resource] = true;
+			}
+		}
+	}
+
+	void IkRenderGraph::groupRenderPasses() {
+		for (auto& resource : resources) {
+			resource.used = false;
+			resource.usage = 0;
+			resource.aliasBlock = -1;
+		}
+
+		for (PassId p = 0; p < passes.size(); p++) {
+			Pass& pass = passes[p];
+			if (pass.culled) continue;
+
+			//sampling reads texels of other pixels, which a subpass dependency can not make visible
+			bool newRenderPass = renderPasses.empty();
+			for (const auto& use : pass.uses) {
+				if (newRenderPass || use.usage != Usage::Sampled) continue;
+				for (PassId earlier : renderPasses.back().passes) {
+					for (const auto& earlierUse : passes[earlier].uses) {
+						if (earlierUse.resource == use.resource && earlierUse.usage != Usage::Sampled) newRenderPass = true;
+					}
+				}
+			}
+			if (newRenderPass) renderPasses.emplace_back();
+
+			RenderPass& renderPass = renderPasses.back();
+			pass.renderPass = static_cast<uint32_t>(renderPasses.size() - 1);
+			pass.subpass = static_cast<uint32_t>(renderPass.passes.size());
+			renderPass.passes.push_back(p);
+			renderPass.name += (renderPass.name.empty() ? "render pass " : "+") + pass.name;
+
+			for (const auto& use : pass.uses) {
+				Resource& resource = resources[use.resource];
+				if (!resource.used) resource.firstRenderPass = pass.renderPass;
+				resource.lastRenderPass = pass.renderPass;
+				resource.used = true;
+
+				switch (use.usage) {
+				case Usage::ColorWrite: resource.usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT; break;
+				case Usage::DepthWrite:
+				case Usage::DepthRead: resource.usage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT; break;
+				case Usage::InputRead: resource.usage |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT; break;
+				case Usage::Sampled: resource.usage |= VK_IMAGE_USAGE_SAMPLED_BIT; break;
+				}
+
+				if (use.usage != Usage::Sampled &&
+					std::find(renderPass.attachments.begin(), renderPass.attachments.end(), use.resource) == renderPass.attachments.end()) {
+					renderPass.attachments.push_back(use.resource);
+				}
+			}
+		}
+	}
+
+	void IkRenderGraph::createImages() {
+		VkDevice device = ikeDeviceEngine.device();
+		bool lazyMemory = ikeDeviceEngine.hasMemoryProperties(VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+
+		//aliasing is assigned in the order the images are first needed, so a block is reused as soon as it is free
+		std::vector<ResourceId> order(resources.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [this](ResourceId a, ResourceId b) {
+			return resources[a].firstRenderPass < resources[b].firstRenderPass;
+		});
+
+		VkDeviceSize aliasedRequirements = 0;
+		for (ResourceId id : order) {
+			Resource& resource = resources[id];
+			if (resource.imported || !resource.used) continue;
+
+			//an image that lives and dies inside one render pass never has to reach memory on a tiler
+			bool transient = resource.firstRenderPass == resource.lastRenderPass && !(resource.usage & VK_IMAGE_USAGE_SAMPLED_BIT);
+
+			VkImageCreateInfo imageInfo{};
+			imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			imageInfo.imageType = VK_IMAGE_TYPE_2D;
+			imageInfo.extent.width = extent.width;
+			imageInfo.extent.height = extent.height;
+			imageInfo.extent.depth = 1;
+			imageInfo.mipLevels = 1;
+			imageInfo.arrayLayers = 1;
+			imageInfo.format = resource.format;
+			imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+			imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			imageInfo.usage = resource.usage | (transient ? VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT : 0);
+			imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+			imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			imageInfo.flags = 0;
+
+			if (transient) {
+				VkMemoryPropertyFlags memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+				if (lazyMemory) memoryProperties |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+
+				resource.images.resize(frameCount);
+				resource.imageMemorys.resize(frameCount);
+				for (uint32_t i = 0; i < frameCount; i++) {
+					ikeDeviceEngine.createImageWithInfo(imageInfo, memoryProperties, resource.images[i], resource.imageMemorys[i]);
+				}
+				VkMemoryRequirements requirements;
+				vkGetImageMemoryRequirements(device, resource.images[0], &requirements);
+				transientMemorySize += requirements.size;
+				continue;
+			}
+
+			resource.images.resize(frameCount);
+			for (uint32_t i = 0; i < frameCount; i++) {
+				if (vkCreateImage(device, &imageInfo, nullptr, &resource.images[i]) != VK_SUCCESS) {
+					throw std::runtime_error("failed to create render graph image!");
+				}
+			}
+
+			VkMemoryRequirements requirements;
+			vkGetImageMemoryRequirements(device, resource.images[0], &requirements);
+			aliasedRequirements += requirements.size;
+
+			int blockIndex = -1;
+			for (size_t b = 0; b < aliasBlocks.size(); b++) {
+				if (aliasBlocks[b].lastRenderPass < resource.firstRenderPass &&
+					(aliasBlocks[b].memoryTypeBits & requirements.memoryTypeBits) != 0) {
+					blockIndex = static_cast<int>(b);
+					break;
+				}
+			}
+			if (blockIndex < 0) {
+				AliasBlock block{};
+				block.memoryTypeBits = requirements.memoryTypeBits;
+				aliasBlocks.push_back(block);
+				blockIndex = static_cast<int>(aliasBlocks.size() - 1);
+			}
+
+			AliasBlock& block = aliasBlocks[blockIndex];
+			block.size = std::max(block.size, requirements.size);
+			block.alignment = std::max(block.alignment, requirements.alignment);
+			block.memoryTypeBits &= requirements.memoryTypeBits;
+			block.lastRenderPass = resource.lastRenderPass;
+			resource.aliasBlock = blockIndex;
+		}
+
+		VkDeviceSize blockSizes = 0;
+		for (auto& block : aliasBlocks) {
+			VkMemoryAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+			allocInfo.allocationSize = block.size;
+			allocInfo.memoryTypeIndex = ikeDeviceEngine.findMemoryType(block.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+			block.memorys.resize(frameCount);
+			for (uint32_t i = 0; i < frameCount; i++) {
+				if (vkAllocateMemory(device, &allocInfo, nullptr, &block.memorys[i]) != VK_SUCCESS) {
+					throw std::runtime_error("failed to allocate render graph memory!");
+				}
+			}
+			blockSizes += block.size;
+		}
+		transientMemorySize += blockSizes;
+		aliasedMemorySize = aliasedRequirements - blockSizes;
+
+		for (auto& resource : resources) {
+			if (resource.images.empty()) continue;
+
+			resource.imageViews.resize(frameCount);
+			for (uint32_t i = 0; i < frameCount; i++) {
+				if (resource.aliasBlock >= 0) {
+					if (vkBindImageMemory(device, resource.images[i], aliasBlocks[resource.aliasBlock].memorys[i], 0) != VK_SUCCESS) {
+						throw std::runtime_error("failed to bind render graph image memory!");
+					}
+				}
+
+				VkImageViewCreateInfo viewInfo{};
+				viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+				viewInfo.image = resource.images[i];
+				viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+				viewInfo.format = resource.format;
+				viewInfo.subresourceRange.aspectMask = isDepthFormat(resource.format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+				viewInfo.subresourceRange.baseMipLevel = 0;
+				viewInfo.subresourceRange.levelCount = 1;
+				viewInfo.subresourceRange.baseArrayLayer = 0;
+				viewInfo.subresourceRange.layerCount = 1;
+
+				if (vkCreateImageView(device, &viewInfo, nullptr, &resource.imageViews[i]) != VK_SUCCESS) {
+					throw std::runtime_error("failed to create render graph image view!");
+				}
+			}
+		}
+	}
+
+	std::vector<IkRenderGraph::UseRef> IkRenderGraph::timeline(ResourceId resource) const {
+		std::vector<UseRef> uses;
+		for (PassId p = 0; p < passes.size(); p++) {
+			if (passes[p].culled) continue;
+			for (const auto& use : passes[p].uses) {
+				if (use.resource == resource) uses.push_back({ p, &use });
+			}
+		}
+		return uses;
+	}
+
+	void IkRenderGraph::createRenderPasses() {
+		for (uint32_t g = 0; g < renderPasses.size(); g++) {
+			RenderPass& renderPass = renderPasses[g];
+			auto attachmentIndex = [&renderPass](ResourceId resource) {
+				return static_cast<uint32_t>(
+					std::find(renderPass.attachments.begin(), renderPass.attachments.end(), resource) - renderPass.attachments.begin());
+			};
+
+			//load and store ops and layouts follow from the uses before, inside and after this render pass
+			std::vector<VkAttachmentDescription> attachments(renderPass.attachments.size());
+			renderPass.clearValues.assign(renderPass.attachments.size(), VkClearValue{});
+			for (size_t a = 0; a < renderPass.attachments.size(); a++) {
+				const Resource& resource = resources[renderPass.attachments[a]];
+				std::vector<UseRef> uses = timeline(renderPass.attachments[a]);
+
+				const UseRef* firstInside = nullptr;
+				const UseRef* lastInside = nullptr;
+				const UseRef* nextAfter = nullptr;
+				bool writtenBefore = false;
+				for (const auto& use : uses) {
+					uint32_t useRenderPass = passes[use.pass].renderPass;
+					if (useRenderPass < g) writtenBefore = true;
+					if (useRenderPass == g) {
+						if (!firstInside) firstInside = &use;
+						lastInside = &use;
+					}
+					if (useRenderPass > g && !nextAfter) nextAfter = &use;
+				}
+
+				VkPipelineStageFlags stages;
+				VkAccessFlags access;
+				VkImageLayout firstLayout, lastLayout, nextLayout;
+				describeUse(firstInside->use->usage, resource.format, stages, access, firstLayout);
+				describeUse(lastInside->use->usage, resource.format, stages, access, lastLayout);
+
+				VkAttachmentDescription& description = attachments[a];
+				description.format = resource.format;
+				description.samples = VK_SAMPLE_COUNT_1_BIT;
+				if (firstInside->use->clear) {
+					description.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+					renderPass.clearValues[a] = firstInside->use->clearValue;
+				}
+				else {
+					description.loadOp = writtenBefore ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+				}
+				description.storeOp = (resource.imported || nextAfter) ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+				description.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+				description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+				//the render pass that loads the image left it in the layout of its first use here
+				description.initialLayout = description.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD ? firstLayout : VK_IMAGE_LAYOUT_UNDEFINED;
+				if (resource.imported) {
+					description.finalLayout = resource.importedFinalLayout;
+				}
+				else if (nextAfter) {
+					describeUse(nextAfter->use->usage, resource.format, stages, access, nextLayout);
+					description.finalLayout = nextLayout;
+				}
+				else {
+					description.finalLayout = lastLayout;
+				}
+			}
+
+			std::vector<VkSubpassDescription> subpasses(renderPass.passes.size());
+			std::vector<std::vector<VkAttachmentReference>> colorRefs(renderPass.passes.size());
+			std::vector<std::vector<VkAttachmentReference>> inputRefs(renderPass.passes.size());
+			std::vector<VkAttachmentReference> depthRefs(renderPass.passes.size());
+			for (uint32_t s = 0; s < renderPass.passes.size(); s++) {
+				bool hasDepth = false;
+				for (const auto& use : passes[renderPass.passes[s]].uses) {
+					VkPipelineStageFlags stages;
+					VkAccessFlags access;
+					VkImageLayout layout;
+					describeUse(use.usage, resources[use.resource].format, stages, access, layout);
+					VkAttachmentReference ref{ attachmentIndex(use.resource), layout };
+
+					switch (use.usage) {
+					case Usage::ColorWrite: colorRefs[s].push_back(ref); break;
+					case Usage::DepthWrite:
+					case Usage::DepthRead:
+						assert(!hasDepth && "A pass can only have one depth attachment");
+						depthRefs[s] = ref;
+						hasDepth = true;
+						break;
+					case Usage::InputRead: inputRefs[s].push_back(ref); break;
+					case Usage::Sampled: break;
+					}
+				}
+
+				subpasses[s].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+				subpasses[s].colorAttachmentCount = static_cast<uint32_t>(colorRefs[s].size());
+				subpasses[s].pColorAttachments = colorRefs[s].data();
+				subpasses[s].inputAttachmentCount = static_cast<uint32_t>(inputRefs[s].size());
+				subpasses[s].pInputAttachments = inputRefs[s].data();
+				subpasses[s].pDepthStencilAttachment = hasDepth ? &depthRefs[s] : nullptr;
+			}
+
+			//one dependency per pair of subpasses that share an image, with exactly the stages and accesses of the two uses
+			std::vector<VkSubpassDependency>& dependencies = renderPass.dependencies;
+			dependencies.clear();
+			auto addDependency = [&dependencies](uint32_t srcSubpass, uint32_t dstSubpass,
+				VkPipelineStageFlags srcStages, VkAccessFlags srcAccess,
+				VkPipelineStageFlags dstStages, VkAccessFlags dstAccess, bool byRegion) {
+				auto existing = std::find_if(dependencies.begin(), dependencies.end(), [&](const VkSubpassDependency& dependency) {
+					return dependency.srcSubpass == srcSubpass && dependency.dstSubpass == dstSubpass;
+				});
+				if (existing == dependencies.end()) {
+					VkSubpassDependency dependency{};
+					dependency.srcSubpass = srcSubpass;
+					dependency.dstSubpass = dstSubpass;
+					dependency.dependencyFlags = byRegion ? VK_DEPENDENCY_BY_REGION_BIT : 0;
+					dependencies.push_back(dependency);
+					existing = dependencies.end() - 1;
+				}
+				else if (!byRegion) {
+					existing->dependencyFlags &= ~VK_DEPENDENCY_BY_REGION_BIT;
+				}
+				existing->srcStageMask |= srcStages;
+				existing->srcAccessMask |= srcAccess & WRITE_ACCESS;
+				existing->dstStageMask |= dstStages;
+				existing->dstAccessMask |= dstAccess;
+			};
+			auto addUseStages = [this](const UseRef& ref, VkPipelineStageFlags& stages, VkAccessFlags& access) {
+				VkPipelineStageFlags useStages;
+				VkAccessFlags useAccess;
+				VkImageLayout layout;
+				describeUse(ref.use->usage, resources[ref.use->resource].format, useStages, useAccess, layout);
+				stages |= useStages;
+				access |= useAccess;
+			};
+
+			for (uint32_t s = 0; s < renderPass.passes.size(); s++) {
+				PassId p = renderPass.passes[s];
+				for (const auto& use : passes[p].uses) {
+					if (use.usage == Usage::Sampled) continue;
+
+					VkPipelineStageFlags dstStages = 0;
+					VkAccessFlags dstAccess = 0;
+					VkImageLayout layout;
+					describeUse(use.usage, resources[use.resource].format, dstStages, dstAccess, layout);
+
+					//the closest earlier use by another pass
+					std::vector<UseRef> uses = timeline(use.resource);
+					const UseRef* previous = nullptr;
+					for (const auto& other : uses) {
+						if (other.pass >= p) break;
+						previous = &other;
+					}
+
+					VkPipelineStageFlags srcStages = 0;
+					VkAccessFlags srcAccess = 0;
+					if (previous && passes[previous->pass].renderPass == g) {
+						addUseStages(*previous, srcStages, srcAccess);
+						addDependency(passes[previous->pass].subpass, s, srcStages, srcAccess, dstStages, dstAccess, true);
+						continue;
+					}
+
+					if (previous) {
+						addUseStages(*previous, srcStages, srcAccess);
+					}
+					else if (resources[use.resource].imported) {
+						//the swap chain image is handed over by the acquire semaphore, which waits at color output
+						srcStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+					}
+					else {
+						//first use this frame, it must wait for the last user of the same memory: the image aliased with it
+						//that was last used closest before it this frame, else the last user in the previous frame, which
+						//is the last image aliased with it or itself
+						ResourceId lastUser = use.resource;
+						int block = resources[use.resource].aliasBlock;
+						if (block >= 0) {
+							uint32_t firstRenderPass = resources[use.resource].firstRenderPass;
+							bool earlierMember = false;
+							for (ResourceId other = 0; other < resources.size(); other++) {
+								if (resources[other].aliasBlock != block || resources[other].lastRenderPass >= firstRenderPass) continue;
+								if (!earlierMember || resources[other].lastRenderPass > resources[lastUser].lastRenderPass) lastUser = other;
+								earlierMember = true;
+							}
+							for (ResourceId other = 0; other < resources.size() && !earlierMember; other++) {
+								if (resources[other].aliasBlock == block &&
+									resources[other].lastRenderPass >= resources[lastUser].lastRenderPass) lastUser = other;
+							}
+						}
+						std::vector<UseRef> lastUses = timeline(lastUser);
+						for (const auto& other : lastUses) {
+							if (passes[other.pass].renderPass == resources[lastUser].lastRenderPass) addUseStages(other, srcStages, srcAccess);
+						}
+					}
+					addDependency(VK_SUBPASS_EXTERNAL, s, srcStages, srcAccess, dstStages, dstAccess, false);
+				}
+			}
+
+			//images used again by a later render pass are made visible to that use when this one ends
+			for (ResourceId id : renderPass.attachments) {
+				std::vector<UseRef> uses = timeline(id);
+				const UseRef* lastInside = nullptr;
+				const UseRef* nextAfter = nullptr;
+				for (const auto& use : uses) {
+					uint32_t useRenderPass = passes[use.pass].renderPass;
+					if (useRenderPass == g) lastInside = &use;
+					if (useRenderPass > g && !nextAfter) nextAfter = &use;
+				}
+				if (!nextAfter) continue;
+
+				VkPipelineStageFlags srcStages = 0, dstStages = 0;
+				VkAccessFlags srcAccess = 0, dstAccess = 0;
+				addUseStages(*lastInside, srcStages, srcAccess);
+				addUseStages(*nextAfter, dstStages, dstAccess);
+				addDependency(passes[lastInside->pass].subpass, VK_SUBPASS_EXTERNAL, srcStages, srcAccess, dstStages, dstAccess, false);
+			}
+
+			VkRenderPassCreateInfo renderPassInfo{};
+			renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+			renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+			renderPassInfo.pAttachments = attachments.data();
+			renderPassInfo.subpassCount = static_cast<uint32_t>(subpasses.size());
+			renderPassInfo.pSubpasses = subpasses.data();
+			renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+			renderPassInfo.pDependencies = dependencies.data();
+
+			if (vkCreateRenderPass(ikeDeviceEngine.device(), &renderPassInfo, nullptr, &renderPass.renderPass) != VK_SUCCESS) {
+				throw std::runtime_error("failed to create render graph render pass!");
+			}
+		}
+	}
+
+	void IkRenderGraph::createFramebuffers() {
+		for (auto& renderPass : renderPasses) {
+			renderPass.importedViewCount = 1;
+			for (ResourceId id : renderPass.attachments) {
+				if (resources[id].imported) {
+					assert(!resources[id].importedViews.empty() && "Imported image has no views");
+					renderPass.importedViewCount = static_cast<uint32_t>(resources[id].importedViews.size());
+				}
+			}
+
+			renderPass.framebuffers.resize(frameCount * renderPass.importedViewCount);
+			for (uint32_t i = 0; i < renderPass.framebuffers.size(); i++) {
+				uint32_t frame = i / renderPass.importedViewCount;
+				uint32_t image = i % renderPass.importedViewCount;
+				std::vector<VkImageView> views;
+				for (ResourceId id : renderPass.attachments) {
+					views.push_back(getImageView(id, resources[id].imported ? image : frame));
+				}
+
+				VkFramebufferCreateInfo framebufferInfo{};
+				framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+				framebufferInfo.renderPass = renderPass.renderPass;
+				framebufferInfo.attachmentCount = static_cast<uint32_t>(views.size());
+				framebufferInfo.pAttachments = views.data();
+				framebufferInfo.width = extent.width;
+				framebufferInfo.height = extent.height;
+				framebufferInfo.layers = 1;
+
+				if (vkCreateFramebuffer(ikeDeviceEngine.device(), &framebufferInfo, nullptr, &renderPass.framebuffers[i]) != VK_SUCCESS) {
+					throw std::runtime_error("failed to create render graph framebuffer!");
+				}
+			}
+		}
+	}
+
+	void IkRenderGraph::execute(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t imageIndex, FrameInfo& frameInfo) {
+		assert(compiled && "Render graph must be compiled before it is executed");
+		assert(frameIndex < frameCount && "Render graph frame index out of range");
+
+		for (auto& renderPass : renderPasses) {
+			uint32_t framebufferIndex = frameIndex * renderPass.importedViewCount;
+			if (renderPass.importedViewCount > 1) framebufferIndex += imageIndex;
+
+			VkRenderPassBeginInfo renderPassInfo{};
+			renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+			renderPassInfo.renderPass = renderPass.renderPass;
+			renderPassInfo.framebuffer = renderPass.framebuffers[framebufferIndex];
+			renderPassInfo.renderArea.offset = { 0,0 };
+			renderPassInfo.renderArea.extent = extent;
+			renderPassInfo.clearValueCount = static_cast<uint32_t>(renderPass.clearValues.size());
+			renderPassInfo.pClearValues = renderPass.clearValues.data();
+
+			//timestamps go on the primary, outside the render pass, since its subpasses only take secondaries
+			uint32_t gpuScope = profiler ? profiler->beginScope(commandBuffer, renderPass.name) : 0;
+			vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+			activeRenderPass = renderPass.renderPass;
+			activeFramebuffer = renderPass.framebuffers[framebufferIndex];
+
+			for (uint32_t s = 0; s < renderPass.passes.size(); s++) {
+				if (s > 0) vkCmdNextSubpass(commandBuffer, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+				activeSubpass = s;
+				const Pass& pass = passes[renderPass.passes[s]];
+				if (pass.execute) pass.execute(frameInfo);
+			}
+
+			vkCmdEndRenderPass(commandBuffer);
+			if (profiler) profiler->endScope(commandBuffer, gpuScope);
+		}
+
+		activeRenderPass = VK_NULL_HANDLE;
+		activeFramebuffer = VK_NULL_HANDLE;
+		activeSubpass = 0;
+	}
+
+	VkRenderPass IkRenderGraph::getRenderPass(PassId pass) const {
+		assert(compiled && !passes[pass].culled && "Culled passes have no render pass");
+		return renderPasses[passes[pass].renderPass].renderPass;
+	}
+
+	const std::vector<VkSubpassDependency>& IkRenderGraph::getDependencies(PassId pass) const {
+		assert(compiled && !passes[pass].culled && "Culled passes have no render pass");
+		return renderPasses[passes[pass].renderPass].dependencies;
+	}
+
+	bool IkRenderGraph::sharesMemory(ResourceId a, ResourceId b) const {
+		return resources[a].aliasBlock >= 0 && resources[a].aliasBlock == resources[b].aliasBlock;
+	}
+
+	VkImageView IkRenderGraph::getImageView(ResourceId resource, uint32_t index) const {
+		const Resource& image = resources[resource];
+		if (image.imported) {
+			assert(index < image.importedViews.size() && "Imported image has no view for this swap chain image");
+			return image.importedViews[index];
+		}
+		assert(index < image.imageViews.size() && "Image is not used by any pass that survived culling");
+		return image.imageViews[index];
+	}
+
+	VkImageLayout IkRenderGraph::getFinalLayout(ResourceId resource) const {
+		assert(resources[resource].imported && "Only imported images keep a layout past the frame");
+		return resources[resource].importedFinalLayout;
+	}
+
+	bool IkRenderGraph::isDepthFormat(VkFormat format) {
+		switch (format) {
+		case VK_FORMAT_D16_UNORM:
+		case VK_FORMAT_X8_D24_UNORM_PACK32:
+		case VK_FORMAT_D32_SFLOAT:
+		case VK_FORMAT_D16_UNORM_S8_UINT:
+		case VK_FORMAT_D24_UNORM_S8_UINT:
+		case VK_FORMAT_D32_SFLOAT_S8_UINT:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	void IkRenderGraph::describeUse(Usage usage, VkFormat format, VkPipelineStageFlags& stages, VkAccessFlags& access, VkImageLayout& layout) {
+		VkImageLayout readLayout = isDepthFormat(format) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		switch (usage) {
+		case Usage::ColorWrite:
+			stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			access = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+			break;
+		case Usage::DepthWrite:
+			stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+			break;
+		case Usage::DepthRead:
+			stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+			layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+			break;
+		case Usage::InputRead:
+			stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+			access = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+			layout = readLayout;
+			break;
+		case Usage::Sampled:
+			stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+			access = VK_ACCESS_SHADER_READ_BIT;
+			layout = readLayout;
+			break;
+		}
+	}
+
+}//namespace ikE
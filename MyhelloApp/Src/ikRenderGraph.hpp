@@ -0,0 +1,214 @@
+#ifndef IKRENDERGRAPH_HPP
+#define IKRENDERGRAPH_HPP
+
+#include "ikDeviceEngine.hpp"
+#include "ikDeletionQueue.hpp"
+
+//std
+#include <functional>
+#include <string>
+#include <vector>
+namespace ikE {
+	struct FrameInfo;
+	class IkGpuProfiler;
+
+	/*IkRenderGraph turns a list of passes into render passes, framebuffers and barriers.
+	  every pass declares which images it writes as attachments and which it reads as input attachments, read only depth
+	  or sampled images, in the order the passes run. compile() then
+	  - culls every pass whose results never reach an imported image (the swap chain) through the passes that follow it
+	  - merges consecutive passes into the subpasses of one VkRenderPass, a pass that samples an image written earlier in
+	    the same render pass starts a new one
+	  - derives load/store ops, layouts and subpass dependencies from the uses before and after each one, instead of
+	    one conservative dependency for everything
+	  - creates the images the graph owns, an image that never leaves its render pass is a lazily allocated transient
+	    attachment, the others share memory with any image whose render passes do not overlap with theirs
+	  all images have the extent given to compile() or resize(). the graph owns one copy of its images per frame in flight, not per
+	  swap chain image, since a frame can only reuse them once the frame framesInFlight frames earlier has finished.
+	  framebuffers of render passes that use an imported image exist for every pair of frame and imported view.
+	  passes only record draws, compute work is not part of the graph yet.
+  with a profiler set, every render pass is timed as the GPU scope "render pass <pass names>"*/
+	class IkRenderGraph {
+	public:
+		using ResourceId = uint32_t;
+		using PassId = uint32_t;
+
+		class PassBuilder {
+		public:
+			PassBuilder(IkRenderGraph& graph, PassId pass) : graph{ graph }, pass{ pass } {}
+
+			//color attachments get their locations in the order they are written, without a clear value
+			//the previous contents are loaded
+			PassBuilder& writeColor(ResourceId resource);
+			PassBuilder& writeColor(ResourceId resource, VkClearColorValue clear);
+			PassBuilder& writeDepth(ResourceId resource);
+			PassBuilder& writeDepth(ResourceId resource, VkClearDepthStencilValue clear);
+			//bound as a read only depth attachment, for depth testing without depth writes
+			PassBuilder& readDepth(ResourceId resource);
+			//the pass reads the texel of its own pixel, input attachments get their indices in the order they are read
+			PassBuilder& readInput(ResourceId resource);
+			//the pass samples the image anywhere, so it can not share a render pass with the pass that wrote it
+			PassBuilder& sampleImage(ResourceId resource);
+
+			PassId id() const { return pass; }
+
+		private:
+			IkRenderGraph& graph;
+			PassId pass;
+		};
+
+		IkRenderGraph(IkeDeviceEngine& device);
+		~IkRenderGraph();
+
+		IkRenderGraph(const IkRenderGraph&) = delete;
+		IkRenderGraph& operator =(const IkRenderGraph&) = delete;
+
+		//an image owned by someone else, it is left in finalLayout at the end of the frame and its passes are never culled
+		ResourceId importImage(const std::string& name, VkFormat format, VkImageLayout finalLayout);
+		//one view per swap chain image, must be set again before every compile() and resize()
+		void setImportedViews(ResourceId resource, const std::vector<VkImageView>& views);
+		ResourceId createImage(const std::string& name, VkFormat format);
+
+		//passes run in the order they are added
+		PassBuilder addPass(const std::string& name);
+		//records the draws of a pass, it runs with the pass's subpass active, see getActiveRenderPass
+		void setExecute(PassId pass, std::function<void(FrameInfo&)> execute);
+
+		//(re)creates every vulkan object of the graph, the device must be idle if it was compiled before
+		void compile(VkExtent2D extent, uint32_t frameCount);
+		bool isCompiled() const { return compiled; }
+		/*recreates the images and framebuffers with a new extent and keeps the render passes, so pipelines stay valid.
+		  the old ones go to deletionQueue since frames in flight may still use them, the device does not have to idle.
+		  formats must not change, set the imported views first*/
+		void resize(VkExtent2D extent, IkDeletionQueue& deletionQueue);
+		//frameIndex picks the copy of the graph's images, imageIndex the view of the imported images
+		void execute(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t imageIndex, FrameInfo& frameInfo);
+		void setProfiler(IkGpuProfiler* gpuProfiler) { profiler = gpuProfiler; }
+
+		//where a pass ended up, pipelines of the pass are built against this render pass and subpass
+		VkRenderPass getRenderPass(PassId pass) const;
+		uint32_t getSubpass(PassId pass) const { return passes[pass].subpass; }
+		//the subpass dependencies compiled into the render pass of pass
+		const std::vector<VkSubpassDependency>& getDependencies(PassId pass) const;
+		//both images are bound to the same alias block
+		bool sharesMemory(ResourceId a, ResourceId b) const;
+		bool isCulled(PassId pass) const { return passes[pass].culled; }
+		//index is the frame index for the graph's images and the swap chain image index for imported ones
+		VkImageView getImageView(ResourceId resource, uint32_t index) const;
+		//the layout the last render pass of the frame leaves an imported image in
+		VkImageLayout getFinalLayout(ResourceId resource) const;
+		uint32_t getFrameCount() const { return frameCount; }
+		size_t getRenderPassCount() const { return renderPasses.size(); }
+		//device memory of the images the graph owns, for one frame, and how much of it aliasing saved
+		VkDeviceSize getTransientMemorySize() const { return transientMemorySize; }
+		VkDeviceSize getAliasedMemorySize() const { return aliasedMemorySize; }
+
+		//state of the render pass execute() is currently in, for secondary command buffers that inherit it
+		VkRenderPass getActiveRenderPass() const { return activeRenderPass; }
+		VkFramebuffer getActiveFramebuffer() const { return activeFramebuffer; }
+		uint32_t getActiveSubpass() const { return activeSubpass; }
+
+	private:
+		enum class Usage {
+			ColorWrite,
+			DepthWrite,
+			DepthRead,
+			InputRead,
+			Sampled
+		};
+
+		struct ResourceUse {
+			ResourceId resource;
+			Usage usage;
+			bool clear;
+			VkClearValue clearValue;
+		};
+
+		struct Resource {
+			std::string name;
+			VkFormat format;
+			bool imported;
+			VkImageLayout importedFinalLayout;
+			std::vector<VkImageView> importedViews;
+
+			//filled in by compile()
+			bool used;
+			uint32_t firstRenderPass;
+			uint32_t lastRenderPass;
+			VkImageUsageFlags usage;
+			int aliasBlock;
+			std::vector<VkImage> images;
+			std::vector<VkDeviceMemory> imageMemorys; //only images that are not aliased own their memory
+			std::vector<VkImageView> imageViews;
+		};
+
+		struct Pass {
+			std::string name;
+			std::vector<ResourceUse> uses;
+			std::function<void(FrameInfo&)> execute;
+			bool culled;
+			uint32_t renderPass;
+			uint32_t subpass;
+		};
+
+		struct RenderPass {
+			std::string name;
+			std::vector<PassId> passes;
+			std::vector<ResourceId> attachments;
+			std::vector<VkClearValue> clearValues;
+			std::vector<VkSubpassDependency> dependencies;
+			VkRenderPass renderPass = VK_NULL_HANDLE;
+			//frameIndex * importedViewCount + imageIndex, importedViewCount is 1 without imported attachments
+			std::vector<VkFramebuffer> framebuffers;
+			uint32_t importedViewCount = 1;
+		};
+
+		//memory shared by images whose render passes do not overlap, one allocation per frame
+		struct AliasBlock {
+			VkDeviceSize size;
+			VkDeviceSize alignment;
+			uint32_t memoryTypeBits;
+			uint32_t lastRenderPass;
+			std::vector<VkDeviceMemory> memorys;
+		};
+
+		//one use of a resource in frame order
+		struct UseRef {
+			PassId pass;
+			const ResourceUse* use;
+		};
+
+		void addUse(PassId pass, ResourceId resource, Usage usage, const VkClearValue* clear);
+		void destroyCompiled();
+		//takes the images, memory and framebuffers out of the graph and returns a function that destroys them
+		std::function<void()> releaseSizedObjects();
+		void cullPasses();
+		void groupRenderPasses();
+		void createImages();
+		void createRenderPasses();
+		void createFramebuffers();
+
+		std::vector<UseRef> timeline(ResourceId resource) const;
+		static bool isDepthFormat(VkFormat format);
+		static void describeUse(Usage usage, VkFormat format, VkPipelineStageFlags& stages, VkAccessFlags& access, VkImageLayout& layout);
+
+		IkeDeviceEngine& ikeDeviceEngine;
+
+		std::vector<Resource> resources;
+		std::vector<Pass> passes;
+		std::vector<RenderPass> renderPasses;
+		std::vector<AliasBlock> aliasBlocks;
+
+		VkExtent2D extent{};
+		uint32_t frameCount{ 0 };
+		bool compiled{ false };
+		VkDeviceSize transientMemorySize{ 0 };
+		VkDeviceSize aliasedMemorySize{ 0 };
+		IkGpuProfiler* profiler{ nullptr };
+
+		VkRenderPass activeRenderPass{ VK_NULL_HANDLE };
+		VkFramebuffer activeFramebuffer{ VK_NULL_HANDLE };
+		uint32_t activeSubpass{ 0 };
+	};
+
+} //namepace
+#endif //header guard
@@ -1,47 +1,84 @@
 #include "ikRenderer.hpp"
+#include "ikCpuProfiler.hpp"
 
 
 
 
 //std
+#include <algorithm>
 #include <stdexcept>
 #include <cassert>
 #include <array>
+#include <thread>
 namespace ikE {
 
 
 
-	IkeRenderer::IkeRenderer(IkeWindow& window, IkeDeviceEngine& device) : ikeWindow(window), ikeDevice(device) {
-
-		recreateSwapChain(),
-		createCommandBuffers();
+	IkeRenderer::IkeRenderer(IkeWindow& window, IkeDeviceEngine& device, const FramePacing& pacing)
+		: ikeWindow(window), ikeDevice(device), framePacing(pacing) {
+
+		deletionQueue = std::make_unique<IkDeletionQueue>(ikeDevice);
+		descriptorPoolManager = std::make_unique<IkDescriptorPoolManager>(
+			ikeDevice,
+			*deletionQueue,
+			ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT);
+		bindlessTable = std::make_unique<IkBindlessTable>(ikeDevice, *deletionQueue);
+		samplerCache = std::make_unique<IkSamplerCache>(ikeDevice);
+		renderGraph = std::make_unique<IkRenderGraph>(ikeDevice);
+		recreateSwapChain();
+		//a headless frame is copied out of its image instead of being presented. it stays a color attachment, so the
+		//readback's own barrier is what orders the copy after the color writes
+		backbuffer = renderGraph->importImage(
+			"backbuffer",
+			ikSwapChain->getSwapChainImageFormat(),
+			ikSwapChain->isHeadless() ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+		frameCommandPools = std::make_unique<IkFrameCommandPools>(
+			ikeDevice,
+			ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT,
+			MAX_RECORDING_THREADS);
+		gpuProfiler = std::make_unique<IkGpuProfiler>(ikeDevice, ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT);
+		renderGraph->setProfiler(gpuProfiler.get());
 	}
 
-	IkeRenderer::~IkeRenderer() { freeCommandBuffers(); }
+	IkeRenderer::~IkeRenderer() {
+		//whatever was retired in the last frames may still be in use until now
+		vkDeviceWaitIdle(ikeDevice.device());
+		deletionQueue->flush();
+	}
 
 
 
 
 	void IkeRenderer::recreateSwapChain() {
+		IK_PROFILE_ZONE("IkeRenderer::recreateSwapChain");
 		auto extent = ikeWindow.getExtent();
 		while (extent.width == 0 || extent.height == 0) {
 			extent = ikeWindow.getExtent();
 			glfwWaitEvents();
 		}
-		vkDeviceWaitIdle(ikeDevice.device());
+		//no wait for the device to idle, frames in flight finish on the old swap chain and graph images, which are
+		//retired to the deletion queue instead of being destroyed here
 		if (ikSwapChain == nullptr) {
-			ikSwapChain = std::make_unique<ikEngineSwapChain>(ikeDevice, extent);
+			ikSwapChain = std::make_unique<ikEngineSwapChain>(ikeDevice, extent, framePacing);
 		}
 		else {
 			std::shared_ptr<ikEngineSwapChain> oldSwapChain = std::move(ikSwapChain);
-			ikSwapChain = std::make_unique<ikEngineSwapChain>(ikeDevice, extent, oldSwapChain);
+			ikSwapChain = std::make_unique<ikEngineSwapChain>(ikeDevice, extent, framePacing, oldSwapChain);
 			
 			if (!oldSwapChain->compareSwapFormats(*ikSwapChain.get())) {
 				throw std::runtime_error("Swap chain image(or depth) format has changed!");
 			}
 
-			
+			//its images may still be rendered to or presented by frames in flight
+			deletionQueue->retire([oldSwapChain]() mutable { oldSwapChain.reset(); });
+		}
+		//the graph's images and framebuffers follow the swap chain's extent and image count, with the same formats
+		//its render passes are kept
+		if (renderGraph->isCompiled()) {
+			renderGraph->setImportedViews(backbuffer, ikSwapChain->getImageViews());
+			renderGraph->resize(ikSwapChain->getSwapChainExtent(), *deletionQueue);
 		}
+		swapChainGeneration += 1;
 		//we will come back to this
 
 
@@ -49,37 +86,90 @@ namespace ikE {
 
 
 
-	void ikE::IkeRenderer::createCommandBuffers() {
-		commandBuffers.resize(ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT);
+	
 
-		VkCommandBufferAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		allocInfo.commandPool = ikeDevice.getCommandPool();
-		allocInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
 
-		if (vkAllocateCommandBuffers(ikeDevice.device(), &allocInfo, commandBuffers.data()) != VK_SUCCESS) {
-			throw std::runtime_error("failed to allocate command buffers");
-		}
-	}
+	void IkeRenderer::waitForNextFrame() {
+		assert(!isFrameStarted && "Can't wait for the next frame while a frame is in progress!");
+		if (isFrameWaited) return;
+		IK_PROFILE_ZONE("IkeRenderer::waitForNextFrame");
 
+		uint64_t finishedPresentId;
+		{
+			//a long zone here means the CPU is ahead of the GPU or the display
+			IK_PROFILE_ZONE("frame timeline wait + present wait");
+			finishedPresentId = ikSwapChain->waitForFrame();
+		}
+		deletionQueue->collect();
+		addLatencySample(finishedPresentId);
+		sleepUntilFrameStart();
 
-	void IkeRenderer::freeCommandBuffers() {
-		vkFreeCommandBuffers(ikeDevice.device(),
-			ikeDevice.getCommandPool(),
-			static_cast<uint32_t>(commandBuffers.size()),
-			commandBuffers.data());
-		commandBuffers.clear();
+		isFrameWaited = true;
+		markInputSampled();
 	}
 
+	void IkeRenderer::addLatencySample(uint64_t finishedPresentId) {
+		auto now = std::chrono::steady_clock::now();
+		while (!pendingInputTimes.empty() && pendingInputTimes.front().first <= finishedPresentId) {
+			if (pendingInputTimes.front().first == finishedPresentId) {
+				double latencyMs = std::chrono::duration<double, std::milli>(now - pendingInputTimes.front().second).count();
+				if (latencySamples.size() < LATENCY_HISTORY_SIZE) {
+					latencySamples.push_back(latencyMs);
+				}
+				else {
+					latencySamples[nextLatencySample] = latencyMs;
+				}
+				nextLatencySample = (nextLatencySample + 1) % LATENCY_HISTORY_SIZE;
+			}
+			pendingInputTimes.pop_front();
+		}
+	}
 
-	
+	void IkeRenderer::sleepUntilFrameStart() {
+		if (framePacing.targetFps <= 0) return;
+		IK_PROFILE_ZONE("frame limiter");
+
+		//the deadline is when the frame should be submitted, a frame that missed it starts the schedule over
+		auto now = std::chrono::steady_clock::now();
+		auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double>(1.0 / framePacing.targetFps));
+		nextFrameDeadline += period;
+		if (nextFrameDeadline < now) {
+			nextFrameDeadline = now + period;
+		}
+		//wake up just early enough to build the frame, so the input it samples is as late as possible
+		auto workEstimate = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double, std::milli>(frameWorkEstimateMs * 1.1));
+		std::this_thread::sleep_until(nextFrameDeadline - workEstimate);
+	}
 
+	IkeRenderer::LatencyStats IkeRenderer::getLatencyStats() const {
+		LatencyStats stats{};
+		stats.toPresent = ikSwapChain->isPresentWaitEnabled();
+		stats.sampleCount = latencySamples.size();
+		if (latencySamples.empty()) return stats;
+
+		std::vector<double> sorted = latencySamples;
+		std::sort(sorted.begin(), sorted.end());
+		for (double sample : sorted) stats.averageMs += sample;
+		stats.averageMs /= sorted.size();
+		stats.p95Ms = sorted[static_cast<size_t>(.95 * (sorted.size() - 1) + 0.5)];
+		stats.maxMs = sorted.back();
+		return stats;
+	}
 
 	VkCommandBuffer IkeRenderer::beginFrame() {
 		assert(!isFrameStarted && "Can't call beginFrame while already in progress!");
-	;
-		auto result = ikSwapChain->acquireNextImage(&currentImageIndex);
+		IK_PROFILE_ZONE("IkeRenderer::beginFrame");
+		waitForNextFrame();
+		isFrameWaited = false;
+
+		VkResult result;
+		{
+			//the frame timeline was already waited on by waitForNextFrame
+			IK_PROFILE_ZONE("acquire");
+			result = ikSwapChain->acquireNextImage(&currentImageIndex);
+		}
 		if (result == VK_ERROR_OUT_OF_DATE_KHR) {
 			recreateSwapChain();
 			return nullptr;
@@ -90,26 +180,42 @@ namespace ikE {
 
 		isFrameStarted = true;
 
+		//waitForNextFrame waited for the last frame with this index, so the primary and secondaries recorded for it last
+		//time are no longer in use and their pools are reset in one go
+		frameCommandPools->resetFrame(currentFrameIndex);
+		descriptorPoolManager->beginFrame(currentFrameIndex);
+
 		auto commandBuffer = getCurrentCommandBuffer();
 		VkCommandBufferBeginInfo beginInfo{};
 		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
 		if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
 			throw std::runtime_error("failed to begin recording command buffers !");
 
 		}
+		//same wait as above, the timestamps this frame index wrote last time are ready to be read
+		gpuProfiler->beginFrame(currentFrameIndex, commandBuffer);
 		return commandBuffer;
 	}
 
 
 	void IkeRenderer::endFrame() {
 		assert(isFrameStarted && "Can't call endFrame while frame is not in progress!");
+		IK_PROFILE_ZONE("IkeRenderer::endFrame");
 		auto commandBuffer = getCurrentCommandBuffer();
 		if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
 			throw std::runtime_error("failed to record command buffer!");
 		}
 
+		//a frame that never finishes (e.g. lost with its swap chain) must not keep its entry forever
+		pendingInputTimes.emplace_back(ikSwapChain->nextPresentId(), inputSampleTime);
+		if (pendingInputTimes.size() > 2 * ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT) {
+			pendingInputTimes.pop_front();
+		}
 		auto result = ikSwapChain->submitCommandBuffers(&commandBuffer, &currentImageIndex);
+		double workMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inputSampleTime).count();
+		frameWorkEstimateMs = frameWorkEstimateMs == 0.0 ? workMs : .9 * frameWorkEstimateMs + .1 * workMs;
 
 		if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || ikeWindow.wasWindowResized()) {
 			ikeWindow.resetWindowResizedFlag();
@@ -120,35 +226,90 @@ namespace ikE {
 		}
 
 		isFrameStarted = false;
-		currentFrameIndex = (currentFrameIndex + 1) % ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT;
+		currentFrameIndex = (currentFrameIndex + 1) % framePacing.framesInFlight;
+	}
+
+
+
+	void IkeRenderer::compileRenderGraph() {
+		//depth and the G-buffer are only in use by the frames in flight, not by every image the swap chain holds
+		renderGraph->setImportedViews(backbuffer, ikSwapChain->getImageViews());
+		renderGraph->compile(ikSwapChain->getSwapChainExtent(), static_cast<uint32_t>(framePacing.framesInFlight));
+	}
+
+	void IkeRenderer::executeRenderGraph(FrameInfo& frameInfo) {
+		assert(isFrameStarted && "Can't execute the render graph if frame is not in progress");
+		//the draws themselves live in secondary command buffers, so the primary only begins the render passes and
+		//executes them (viewport and scissor are set in beginSecondaryCommandBuffer instead)
+		renderGraph->execute(getCurrentCommandBuffer(), currentFrameIndex, currentImageIndex, frameInfo);
 	}
 
 
+	uint32_t IkeRenderer::beginGpuScope(const std::string& name) {
+		assert(isFrameStarted && "Can't begin a GPU scope when frame is not in progress");
+		if (!gpuProfiler->isSupported()) return IkGpuProfiler::INVALID_SCOPE;
+
+		uint32_t scope = IkGpuProfiler::INVALID_SCOPE;
+		recordOnCurrentSubpass([&](VkCommandBuffer commandBuffer) {
+			scope = gpuProfiler->beginScope(commandBuffer, name);
+		});
+		return scope;
+	}
+
+	void IkeRenderer::endGpuScope(uint32_t scope) {
+		assert(isFrameStarted && "Can't end a GPU scope when frame is not in progress");
+		if (scope == IkGpuProfiler::INVALID_SCOPE) return;
 
-	void IkeRenderer::beginSwapChainRenderPass(VkCommandBuffer commandBuffer) {
-		assert(isFrameStarted && " Can't call beginSwapChainRenderPass if frame is not in progress");
-		assert(
-			commandBuffer == getCurrentCommandBuffer() && " Can't beging render pass on command buffer from a different frame"
-		);
+		recordOnCurrentSubpass([&](VkCommandBuffer commandBuffer) {
+			gpuProfiler->endScope(commandBuffer, scope);
+		});
+	}
 
+	void IkeRenderer::recordOnCurrentSubpass(const std::function<void(VkCommandBuffer commandBuffer)>& recordFn) {
+		if (renderGraph->getActiveRenderPass() == VK_NULL_HANDLE) {
+			recordFn(getCurrentCommandBuffer());
+			return;
+		}
+		VkCommandBuffer commandBuffer = beginSecondaryCommandBuffer(0);
+		recordFn(commandBuffer);
+		endSecondaryCommandBuffer(commandBuffer);
+		executeSecondaryCommandBuffers({ commandBuffer });
+	}
 
-		//this Describe the render pass you want to begin
-		VkRenderPassBeginInfo renderPassInfo{};
-		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-		renderPassInfo.renderPass = ikSwapChain->getRenderPass();
-		renderPassInfo.framebuffer = ikSwapChain->getFrameBuffer(currentImageIndex);
+	VkCommandBuffer IkeRenderer::beginSecondaryCommandBuffer(uint32_t slot) {
+		assert(isFrameStarted && "Can't begin a secondary command buffer when frame is not in progress");
 
-		renderPassInfo.renderArea.offset = { 0,0 };
-		renderPassInfo.renderArea.extent = ikSwapChain->getSwapChainExtent();
+		VkCommandBuffer commandBuffer = frameCommandPools->acquire(currentFrameIndex, slot);
+		beginInheritingCommandBuffer(
+			commandBuffer,
+			renderGraph->getActiveFramebuffer(),
+			VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+		return commandBuffer;
+	}
 
-		std::array<VkClearValue, 2> clearValues{};
-		clearValues[0].color = { 0.01f,0.01f,0.01f,1.0f };
-		clearValues[1].depthStencil = { 1.0f, 0 }; // instead of 1.0f,0.0f
-		renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-		renderPassInfo.pClearValues = clearValues.data();
+	void IkeRenderer::beginCachedSecondaryCommandBuffer(VkCommandBuffer commandBuffer) {
+		//the framebuffer is left out on purpose, the image index changes every frame but the render pass does not
+		beginInheritingCommandBuffer(commandBuffer, VK_NULL_HANDLE, 0);
+	}
 
-		//we record to the command buffer to begin the renderPass
-		vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+	void IkeRenderer::beginInheritingCommandBuffer(VkCommandBuffer commandBuffer, VkFramebuffer framebuffer, VkCommandBufferUsageFlags flags) {
+		//the secondary continues the swap chain render pass, so it has to know which pass and subpass it runs in
+		//framebuffer is optional, naming it only lets the driver optimize for that specific target
+		VkCommandBufferInheritanceInfo inheritanceInfo{};
+		inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+		assert(renderGraph->getActiveRenderPass() != VK_NULL_HANDLE && "Secondary command buffers are only recorded inside a render graph pass");
+		inheritanceInfo.renderPass = renderGraph->getActiveRenderPass();
+		inheritanceInfo.subpass = renderGraph->getActiveSubpass();
+		inheritanceInfo.framebuffer = framebuffer;
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | flags;
+		beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+		if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+			throw std::runtime_error("failed to begin recording secondary command buffer!");
+		}
 
 		VkViewport viewport{};
 		viewport.x = 0.0f;
@@ -160,19 +321,44 @@ namespace ikE {
 		VkRect2D scissor{ {0,0}, ikSwapChain->getSwapChainExtent() };
 		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+	}
 
-
+	void IkeRenderer::endSecondaryCommandBuffer(VkCommandBuffer commandBuffer) {
+		if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("failed to record secondary command buffer!");
+		}
 	}
 
+	void IkeRenderer::executeSecondaryCommandBuffers(const std::vector<VkCommandBuffer>& secondaryCommandBuffers) {
+		assert(isFrameStarted && "Can't execute secondary command buffers when frame is not in progress");
+		if (secondaryCommandBuffers.empty()) return;
 
-	void IkeRenderer::endSwapChainRenderPass(VkCommandBuffer commandBuffer) {
-		assert(isFrameStarted && " Can't call endSwapChainRenderPass if frame is not in progress");
-		assert(
-			commandBuffer == getCurrentCommandBuffer() && " Can't end render pass on command buffer from a different frame"
-		);
-		// End the render pass and CommandBuffer
-		vkCmdEndRenderPass(commandBuffer);
+		vkCmdExecuteCommands(
+			getCurrentCommandBuffer(),
+			static_cast<uint32_t>(secondaryCommandBuffers.size()),
+			secondaryCommandBuffers.data());
+	}
 
+	void IkeRenderer::recordSecondaryCommandBuffers(
+		IkThreadPool& threadPool,
+		uint32_t drawCount,
+		uint32_t minDrawsPerChunk,
+		const std::function<void(VkCommandBuffer commandBuffer, uint32_t first, uint32_t last)>& recordFn) {
+		assert(threadPool.size() <= MAX_RECORDING_THREADS && "Thread pool is larger than the number of recording slots");
+
+		//chunk index doubles as recording slot, parallelFor never hands the same chunk to two workers
+		std::vector<VkCommandBuffer> secondaryCommandBuffers(threadPool.size());
+		uint32_t chunkCount = threadPool.parallelFor(drawCount, minDrawsPerChunk,
+			[&](uint32_t chunk, uint32_t first, uint32_t last) {
+				IK_PROFILE_ZONE("record secondary chunk");
+				VkCommandBuffer commandBuffer = beginSecondaryCommandBuffer(chunk);
+				recordFn(commandBuffer, first, last);
+				endSecondaryCommandBuffer(commandBuffer);
+				secondaryCommandBuffers[chunk] = commandBuffer;
+			});
+		secondaryCommandBuffers.resize(chunkCount);
+
+		executeSecondaryCommandBuffers(secondaryCommandBuffers);
 	}
 
 }//namespace
@@ -4,65 +4,178 @@
 
 #include "ikDeviceEngine.hpp"
 
+#include "ikBindlessTable.hpp"
+#include "ikCommandPools.hpp"
+#include "ikDeletionQueue.hpp"
+#include "ikDescriptors.hpp"
+#include "ikGpuProfiler.hpp"
+#include "ikRenderGraph.hpp"
+#include "ikSamplerCache.hpp"
 #include "ikSwapChain.hpp"
+#include "ikThreadPool.hpp"
 #include "ikWindow.hpp"
 
 
 //std
 #include <cassert>
+#include <chrono>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 namespace ikE {
 	class IkeRenderer {
 	public:
-		
+		//upper bound on the number of threads recording secondary command buffers in the same frame
+		static constexpr uint32_t MAX_RECORDING_THREADS = 8;
+
+		//how long input took to reach the screen, over the last LATENCY_HISTORY_SIZE frames
+		struct LatencyStats {
+			//measured until the frame was displayed (present wait), otherwise only until the GPU finished it
+			bool toPresent;
+			size_t sampleCount;
+			double averageMs;
+			double p95Ms;
+			double maxMs;
+		};
+		static constexpr size_t LATENCY_HISTORY_SIZE = 256;
 
 		//because we have the constructors here we should also remember to delete the copy constructors 
-		IkeRenderer(IkeWindow &window, IkeDeviceEngine &device);
+		IkeRenderer(IkeWindow &window, IkeDeviceEngine &device, const FramePacing& pacing = FramePacing{});
 		~IkeRenderer();
 
 		IkeRenderer(const IkeRenderer&) = delete;
 		IkeRenderer &operator =(const IkeRenderer&) = delete;
 
-		VkRenderPass getSwapChainRenderPass() const {
-			return ikSwapChain->getRenderPass();}
 		float getAspectRatio() const { return ikSwapChain->extentAspectRatio(); }
+		VkExtent2D getSwapChainExtent() const { return ikSwapChain->getSwapChainExtent(); }
+		size_t getSwapChainImageCount() const { return ikSwapChain->imageCount(); }
+		VkFormat getDepthFormat() const { return ikSwapChain->findDepthFormat(); }
+
+		/*passes are added to the render graph once, writing to getBackbuffer() what should end up on screen, then
+		  compileRenderGraph() builds it. from then on its images and framebuffers are resized with the swap chain, the
+		  render passes are kept so pipelines built against them remain valid*/
+		IkRenderGraph& getRenderGraph() { return *renderGraph; }
+		IkRenderGraph::ResourceId getBackbuffer() const { return backbuffer; }
+		void compileRenderGraph();
+		//runs every pass of the graph on the current command buffer with the graph images of the current frame
+		void executeRenderGraph(FrameInfo& frameInfo);
 
 		bool isFrameInProgress() const { return isFrameStarted; };
+		//frame indices cycle through [0, getFramesInFlight()), never more than ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT
+		int getFramesInFlight() const { return framePacing.framesInFlight; }
+
+		/*waits until the next frame may start, on the frame timeline, on the display with present wait and on the frame
+		  limiter with a target rate. calling it before input is sampled, instead of letting beginFrame wait after,
+		  means the frame is built from input that is as fresh as possible. beginFrame calls it if the app did not*/
+		void waitForNextFrame();
+		//the input the next frame renders was read now, by default that is when waitForNextFrame returned
+		void markInputSampled() { inputSampleTime = std::chrono::steady_clock::now(); }
+		LatencyStats getLatencyStats() const;
+
+		/*times a part of the current frame on the GPU, the render graph already times each of its render passes.
+		  inside a graph pass the timestamp can only be written from a secondary command buffer, so each call then
+		  records a small one of its own on slot 0, which makes both calls main thread only*/
+		uint32_t beginGpuScope(const std::string& name);
+		void endGpuScope(uint32_t scope);
+		const IkGpuProfiler& getGpuProfiler() const { return *gpuProfiler; }
+
+		//vulkan objects that frames in flight may still use are destroyed through it, once the GPU finished those frames
+		IkDeletionQueue& getDeletionQueue() { return *deletionQueue; }
+		//descriptor sets of any lifetime, the per frame pools are reset by beginFrame
+		IkDescriptorPoolManager& getDescriptorPoolManager() { return *descriptorPoolManager; }
+		//buffers and textures that shaders index by id, set IkBindlessTable::BINDLESS_SET of the layouts using it
+		IkBindlessTable& getBindlessTable() { return *bindlessTable; }
+		//one sampler per sampler description, shared by every texture sampled that way
+		IkSamplerCache& getSamplerCache() { return *samplerCache; }
+
+		//reads back the image the last endFrame rendered, only headless renderers have readable images
+		void readLastFrame(std::vector<uint8_t>& rgba) {
+			assert(!isFrameStarted && "Can not read back a frame while it is still being recorded");
+			ikSwapChain->readOffscreenImage(currentImageIndex, renderGraph->getFinalLayout(backbuffer), rgba);
+		}
 
 
 		VkCommandBuffer getCurrentCommandBuffer() const { 
 			assert(isFrameStarted && "Cannot get command buffer when frame not in progress!");
-			return commandBuffers[currentFrameIndex]; }
+			return frameCommandPools->primary(currentFrameIndex); }
+
+		//bumped every time the swap chain (and with it the render pass) is recreated
+		uint32_t getSwapChainGeneration() const { return swapChainGeneration; }
 
 		int getFrameIndex() const {
 			assert(isFrameStarted && "Can not get frame index when frame is not in progress");
 			return currentFrameIndex;
 		}
 
+		uint32_t getImageIndex() const {
+			assert(isFrameStarted && "Can not get image index when frame is not in progress");
+			return currentImageIndex;
+		}
+
 		VkCommandBuffer beginFrame();
 		void endFrame();
-		void beginSwapChainRenderPass(VkCommandBuffer commandBuffer);
-		void endSwapChainRenderPass(VkCommandBuffer commandBuffer);
+
+		/*the render graph begins its render passes with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS, so draws are recorded
+		  into secondary command buffers that inherit the subpass of the pass being executed. beginSecondaryCommandBuffer
+		  may be called from any thread as long as every thread uses its own slot, the returned buffer already has viewport
+		  and scissor set since dynamic state is not inherited*/
+		VkCommandBuffer beginSecondaryCommandBuffer(uint32_t slot);
+		//begins a caller owned secondary that can be replayed in later frames with any of the swap chain framebuffers
+		void beginCachedSecondaryCommandBuffer(VkCommandBuffer commandBuffer);
+		void endSecondaryCommandBuffer(VkCommandBuffer commandBuffer);
+		void executeSecondaryCommandBuffers(const std::vector<VkCommandBuffer>& secondaryCommandBuffers);
+
+		//splits drawCount draws over the thread pool, each chunk is recorded by recordFn(commandBuffer, first, last)
+		//into its own secondary buffer and the buffers are executed in chunk order on the current primary buffer
+		void recordSecondaryCommandBuffers(
+			IkThreadPool& threadPool,
+			uint32_t drawCount,
+			uint32_t minDrawsPerChunk,
+			const std::function<void(VkCommandBuffer commandBuffer, uint32_t first, uint32_t last)>& recordFn);
 
 	private:
 		//new functions which needs explanation
 		//void loadModels();
 	
-		void createCommandBuffers();
-		void freeCommandBuffers();
 		void recreateSwapChain();
+		void beginInheritingCommandBuffer(VkCommandBuffer commandBuffer, VkFramebuffer framebuffer, VkCommandBufferUsageFlags flags);
+		void recordOnCurrentSubpass(const std::function<void(VkCommandBuffer commandBuffer)>& recordFn);
+		void addLatencySample(uint64_t finishedPresentId);
+		void sleepUntilFrameStart();
 	
 
 		IkeWindow  &ikeWindow;
 		IkeDeviceEngine &ikeDevice;
+		FramePacing framePacing;
 	
+		std::unique_ptr<IkDeletionQueue> deletionQueue;
+		std::unique_ptr<IkDescriptorPoolManager> descriptorPoolManager;
+		std::unique_ptr<IkBindlessTable> bindlessTable;
+		std::unique_ptr<IkSamplerCache> samplerCache;
 		std::unique_ptr<ikEngineSwapChain> ikSwapChain;
-		std::vector<VkCommandBuffer> commandBuffers;
+		std::unique_ptr<IkRenderGraph> renderGraph;
+		IkRenderGraph::ResourceId backbuffer;
+		std::unique_ptr<IkFrameCommandPools> frameCommandPools;
+		std::unique_ptr<IkGpuProfiler> gpuProfiler;
 
 		uint32_t currentImageIndex;
+		uint32_t swapChainGeneration{ 0 };
 		int currentFrameIndex{ 0 };
 		bool isFrameStarted{ false };
+		bool isFrameWaited{ false };
+
+		//present id and input time of every submitted frame that is not known to be finished yet
+		std::deque<std::pair<uint64_t, std::chrono::steady_clock::time_point>> pendingInputTimes;
+		std::chrono::steady_clock::time_point inputSampleTime{};
+		std::vector<double> latencySamples;
+		size_t nextLatencySample{ 0 };
+
+		//the frame limiter wakes a frame up this long before it is due, the time from input to submit lately
+		std::chrono::steady_clock::time_point nextFrameDeadline{};
+		double frameWorkEstimateMs{ 0.0 };
 	
 	};
 
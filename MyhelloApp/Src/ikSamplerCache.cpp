@@ -0,0 +1,58 @@
+#include "ikSamplerCache.hpp"
+#include "ikUtils.hpp"
+
+//std
+#include <algorithm>
+#include <stdexcept>
+namespace ikE {
+
+	size_t IkSamplerCache::DescHash::operator()(const SamplerDesc& desc) const {
+		size_t seed = 0;
+		hashCombine(seed, desc.magFilter, desc.minFilter, desc.mipmapMode, desc.addressMode, desc.maxAnisotropy, desc.maxLod);
+		return seed;
+	}
+
+	IkSamplerCache::IkSamplerCache(IkeDeviceEngine& device) : ikeDevice{ device } {}
+
+	IkSamplerCache::~IkSamplerCache() {
+		for (auto& kv : samplers) {
+			vkDestroySampler(ikeDevice.device(), kv.second, nullptr);
+		}
+	}
+
+	VkSampler IkSamplerCache::get(const SamplerDesc& desc) {
+		auto existing = samplers.find(desc);
+		if (existing != samplers.end()) {
+			return existing->second;
+		}
+
+		//samplerAnisotropy is required by isDeviceSuitable, only the amount depends on the device
+		float maxAnisotropy = std::min(desc.maxAnisotropy, ikeDevice.properties.limits.maxSamplerAnisotropy);
+
+		VkSamplerCreateInfo samplerInfo{};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = desc.magFilter;
+		samplerInfo.minFilter = desc.minFilter;
+		samplerInfo.mipmapMode = desc.mipmapMode;
+		samplerInfo.addressModeU = desc.addressMode;
+		samplerInfo.addressModeV = desc.addressMode;
+		samplerInfo.addressModeW = desc.addressMode;
+		samplerInfo.mipLodBias = 0.f;
+		samplerInfo.anisotropyEnable = maxAnisotropy > 1.f ? VK_TRUE : VK_FALSE;
+		samplerInfo.maxAnisotropy = std::max(1.f, maxAnisotropy);
+		samplerInfo.compareEnable = VK_FALSE;
+		samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+		samplerInfo.minLod = 0.f;
+		samplerInfo.maxLod = desc.maxLod;
+		samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+		samplerInfo.unnormalizedCoordinates = VK_FALSE;
+
+		VkSampler sampler;
+		if (vkCreateSampler(ikeDevice.device(), &samplerInfo, nullptr, &sampler) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create sampler!");
+		}
+		samplers.emplace(desc, sampler);
+		return sampler;
+	}
+
+}//namespace ikE
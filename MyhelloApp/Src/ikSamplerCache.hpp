@@ -0,0 +1,51 @@
+#ifndef IKSAMPLERCACHE_HPP
+#define IKSAMPLERCACHE_HPP
+
+#include "ikDeviceEngine.hpp"
+
+//std
+#include <cstddef>
+#include <unordered_map>
+namespace ikE {
+	//what a sampler does, the defaults are trilinear, anisotropic and repeating over every mip level
+	struct SamplerDesc {
+		VkFilter magFilter = VK_FILTER_LINEAR;
+		VkFilter minFilter = VK_FILTER_LINEAR;
+		VkSamplerMipmapMode mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+		VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+		//1 turns anisotropic filtering off, larger values are clamped to the device limit
+		float maxAnisotropy = 16.f;
+		float maxLod = VK_LOD_CLAMP_NONE;
+
+		bool operator==(const SamplerDesc& other) const {
+			return magFilter == other.magFilter && minFilter == other.minFilter && mipmapMode == other.mipmapMode &&
+				addressMode == other.addressMode && maxAnisotropy == other.maxAnisotropy && maxLod == other.maxLod;
+		}
+	};
+
+	/*IkSamplerCache hands out one VkSampler per SamplerDesc, so every texture sampled the same way shares a sampler
+	  instead of each creating its own (devices only guarantee maxSamplerAllocationCount of them, 4000 on many).
+	  samplers live as long as the cache. main thread only*/
+	class IkSamplerCache {
+	public:
+		explicit IkSamplerCache(IkeDeviceEngine& device);
+		~IkSamplerCache();
+
+		IkSamplerCache(const IkSamplerCache&) = delete;
+		IkSamplerCache& operator =(const IkSamplerCache&) = delete;
+
+		VkSampler get(const SamplerDesc& desc = SamplerDesc{});
+
+		size_t size() const { return samplers.size(); }
+
+	private:
+		struct DescHash {
+			size_t operator()(const SamplerDesc& desc) const;
+		};
+
+		IkeDeviceEngine& ikeDevice;
+		std::unordered_map<SamplerDesc, VkSampler, DescHash> samplers;
+	};
+
+} //namepace
+#endif //header guard
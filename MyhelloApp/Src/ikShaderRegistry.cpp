@@ -0,0 +1,79 @@
+#include "ikShaderRegistry.hpp"
+#include "ikEmbeddedShaders.hpp"
+
+//std
+#include <cassert>
+#include <fstream>
+#include <stdexcept>
+namespace ikE {
+
+	IkShaderRegistry::IkShaderRegistry(IkeDeviceEngine& device) : ikeDeviceEngine{ device } {}
+
+	IkShaderRegistry::~IkShaderRegistry() {
+		for (auto& kv : modules) {
+			vkDestroyShaderModule(ikeDeviceEngine.device(), kv.second.module, nullptr);
+		}
+	}
+
+	VkShaderModule IkShaderRegistry::acquire(const std::string& filepath) {
+		std::lock_guard<std::mutex> lock{ mutex };
+		auto existing = modules.find(filepath);
+		if (existing == modules.end()) {
+			//the entry is only added once the module exists, a failed load leaves nothing behind to release or destroy
+			ShaderModule entry{};
+			if (const EmbeddedShader* embedded = findEmbeddedShader(filepath)) {
+				entry.module = createShaderModule(embedded->code, embedded->wordCount * sizeof(uint32_t));
+			}
+			else {
+				std::vector<uint32_t> code = readFile(filepath);
+				entry.module = createShaderModule(code.data(), code.size() * sizeof(uint32_t));
+			}
+			existing = modules.emplace(filepath, entry).first;
+		}
+		existing->second.users += 1;
+		return existing->second.module;
+	}
+
+	void IkShaderRegistry::release(const std::string& filepath) {
+		std::lock_guard<std::mutex> lock{ mutex };
+		auto entry = modules.find(filepath);
+		assert(entry != modules.end() && entry->second.users > 0 && "Releasing a shader module that was not acquired");
+
+		entry->second.users -= 1;
+		if (entry->second.users == 0) {
+			vkDestroyShaderModule(ikeDeviceEngine.device(), entry->second.module, nullptr);
+			modules.erase(entry);
+		}
+	}
+
+	//SPIR-V is a stream of 32 bit words, reading into uint32_t keeps pCode aligned
+	std::vector<uint32_t> IkShaderRegistry::readFile(const std::string& filepath) {
+		std::ifstream file(filepath, std::ios::ate | std::ios::binary);
+		if (!file.is_open()) {
+			throw std::runtime_error("failed to open file" + filepath);
+		}
+		size_t fileSize = static_cast<size_t>(file.tellg());
+		if (fileSize % sizeof(uint32_t) != 0) {
+			throw std::runtime_error("invalid SPIR-V file " + filepath);
+		}
+
+		std::vector<uint32_t> buffer(fileSize / sizeof(uint32_t));
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(buffer.data()), fileSize);
+		return buffer;
+	}
+
+	VkShaderModule IkShaderRegistry::createShaderModule(const uint32_t* code, size_t codeSize) {
+		VkShaderModuleCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		createInfo.codeSize = codeSize;
+		createInfo.pCode = code;
+
+		VkShaderModule shaderModule;
+		if (vkCreateShaderModule(ikeDeviceEngine.device(), &createInfo, nullptr, &shaderModule) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create shader module");
+		}
+		return shaderModule;
+	}
+
+}//namespace ikE
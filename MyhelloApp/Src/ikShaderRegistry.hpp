@@ -0,0 +1,43 @@
+#ifndef IKSHADERREGISTRY_HPP
+#define IKSHADERREGISTRY_HPP
+
+#include "ikDeviceEngine.hpp"
+
+//std
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+namespace ikE {
+	/*IkShaderRegistry creates one VkShaderModule per shader no matter how many pipelines or variants use it.
+	  the SPIR-V comes from the executable (see ikEmbeddedShaders.hpp) and only falls back to the .spv file on disk.
+	  every acquire() is paired with a release() once the pipeline using the module has been created, the module is
+	  destroyed when its last user releases it because a linked pipeline no longer needs it.
+	  acquire and release may be called from the pipeline compiler workers*/
+	class IkShaderRegistry {
+	public:
+		IkShaderRegistry(IkeDeviceEngine& device);
+		~IkShaderRegistry();
+
+		IkShaderRegistry(const IkShaderRegistry&) = delete;
+		IkShaderRegistry& operator =(const IkShaderRegistry&) = delete;
+
+		VkShaderModule acquire(const std::string& filepath);
+		void release(const std::string& filepath);
+
+	private:
+		struct ShaderModule {
+			VkShaderModule module = VK_NULL_HANDLE;
+			uint32_t users = 0;
+		};
+
+		static std::vector<uint32_t> readFile(const std::string& filepath);
+		VkShaderModule createShaderModule(const uint32_t* code, size_t codeSize);
+
+		IkeDeviceEngine& ikeDeviceEngine;
+		std::unordered_map<std::string, ShaderModule> modules;
+		std::mutex mutex;
+	};
+
+} //namepace
+#endif //header guard
@@ -1,6 +1,8 @@
 #include "ikSwapChain.hpp"
 
+#include <algorithm>
 #include <array>
+#include <cassert>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
@@ -9,28 +11,32 @@
 #include <stdexcept>
 
 namespace ikE {
-	ikEngineSwapChain::ikEngineSwapChain(IkeDeviceEngine& deviceref, VkExtent2D extent) 
-		                                  : device{ deviceref }, windowExtent{ extent } {
+	ikEngineSwapChain::ikEngineSwapChain(IkeDeviceEngine& deviceref, VkExtent2D extent, const FramePacing& pacing) 
+		                                  : device{ deviceref }, windowExtent{ extent }, pacing{ pacing }, headless{ deviceref.isHeadless() },
+		                                    presentWaitEnabled{ pacing.presentWait && !headless && deviceref.supportsPresentWait() } {
 		init();
 	
 	}
-	ikEngineSwapChain::ikEngineSwapChain(IkeDeviceEngine& deviceref, VkExtent2D extent, std::shared_ptr<ikEngineSwapChain> previous)
-		: device{ deviceref }, windowExtent{ extent }, oldSwapChain{ previous } {
+	ikEngineSwapChain::ikEngineSwapChain(IkeDeviceEngine& deviceref, VkExtent2D extent, const FramePacing& pacing, std::shared_ptr<ikEngineSwapChain> previous)
+		: device{ deviceref }, windowExtent{ extent }, pacing{ pacing }, headless{ previous->headless },
+		  presentWaitEnabled{ pacing.presentWait && !headless && deviceref.supportsPresentWait() }, oldSwapChain{ previous } {
+		presentIdCounter = previous->presentIdCounter;
+		firstPresentId = presentIdCounter + 1;
 		init();
 
-		// clean up old swap chain since it's no longer needed
+		//only drops this reference, the renderer retires the old swap chain once its frames have finished
 		oldSwapChain = nullptr;
 
 	}
 
 
 	void ikEngineSwapChain::init() {
+		assert(pacing.framesInFlight >= 1 && pacing.framesInFlight <= MAX_FRAMES_IN_FLIGHT && "Frames in flight out of range");
 
 		createSwapChain();
 		createImageViews();
-		createRenderPass();
-		createDepthResources();
-		createFramebuffers();
+		//render passes, depth and framebuffers belong to the renderer's render graph
+		swapChainDepthFormat = findDepthFormat();
 		createSyncObjects();
         }
 
@@ -47,36 +53,45 @@ namespace ikE {
 			swapChain = nullptr;
 		}
 
-		for (int i = 0; i < depthImages.size(); i++) {
-			vkDestroyImageView(device.device(), depthImageViews[i], nullptr);
-			vkDestroyImage(device.device(), depthImages[i], nullptr);
-			vkFreeMemory(device.device(), depthImageMemorys[i], nullptr);
+		for (int i = 0; i < offscreenImageMemorys.size(); i++) {
+			vkDestroyImage(device.device(), swapChainImages[i], nullptr);
+			vkFreeMemory(device.device(), offscreenImageMemorys[i], nullptr);
 		}
 
-		for (auto framebuffer : swapChainFramebuffers) {
-			vkDestroyFramebuffer(device.device(), framebuffer, nullptr);
+		// cleanup synchronization objects, frame completion is tracked by the device's timeline semaphore
+		for (VkSemaphore semaphore : imageAvailableSemaphores) {
+			vkDestroySemaphore(device.device(), semaphore, nullptr);
+		}
+		for (VkSemaphore semaphore : renderFinishedSemaphores) {
+			vkDestroySemaphore(device.device(), semaphore, nullptr);
+		}
+	}
+
+	uint64_t ikEngineSwapChain::waitForFrame() {
+		device.waitForFrame(frameNumbers[currentFrame]);
+		if (!presentWaitEnabled) {
+			return framePresentIds[currentFrame];
 		}
-		
-		vkDestroyRenderPass(device.device(), renderPass, nullptr);
 
-		// cleanup synchronization objects
-		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-			vkDestroySemaphore(device.device(), renderFinishedSemaphores[i], nullptr);
-			vkDestroySemaphore(device.device(), imageAvailableSemaphores[i], nullptr);
-			vkDestroyFence(device.device(), inFlightFences[i], nullptr);
+		//with one frame in flight this is the frame just presented, with more some of them may stay queued
+		uint64_t queuedFrames = static_cast<uint64_t>(pacing.framesInFlight - 1);
+		if (presentIdCounter < firstPresentId + queuedFrames) {
+			return 0;
 		}
+		uint64_t presentId = presentIdCounter - queuedFrames;
+		//a minimized or covered window may never show the frame, pacing is skipped rather than stalling forever
+		constexpr uint64_t PRESENT_WAIT_TIMEOUT_NS = 100000000;
+		if (device.waitForPresent(swapChain, presentId, PRESENT_WAIT_TIMEOUT_NS) != VK_SUCCESS) {
+			return 0;
+		}
+		return presentId;
 	}
 
 	//when CPU ask Vulkan which swapchain image is available for rendering
 	// it does that through acquireNextImage() so we call it with a uint32_t type as an argument
-	// inside the function we call vkWaitForFences which helps to track when the GPU has finished work
-	// submitted earlier if its not it blocks the CPU thread until one or more GPU fences are signaled
+	// it does not wait itself, waitForFrame already blocked the CPU thread on the device's frame timeline semaphore
+	// until the GPU finished the frame that used this frame slot last
 	// which prevents the CPU for overwritting resources still in use by the GPU
-	// inside the vkWaitForFences we have the device.device() which is vulkan logical device
-	// 1 which is the number of fences to wait on
-	// &inFlightFences[currentFrame] pointer to the fence for the current frame
-	// Vk_TRUE means wait for all fences in this case 1
-	// std::numberic_limits<uint64_t>::max() is the time in nanoseconds because uint_64 can hold multiple digits
 	// vkAcquireNextImageKHR is the function the CPU uses to get the next image from the swap chain
 	// it simply ask vulkan for the next index of the next available swap chain image to render to
 	// device.device() is the logical device handle
@@ -84,14 +99,16 @@ namespace ikE {
 	// std::numberic_limits<uint64_t>::max() time out in nanosecond
 	// imageAvailableSemaphores[currentFrame] semaphore that will be signaled when the image is 
 	// ready for rendering and imageAvailableSempahore is an instance of std::vector<VkSemaphore>
-	// VK_NULL_HANDLE because we called the vkWaitForFences() earlier the parameter is not used
+	// VK_NULL_HANDLE for the fence because frames are tracked by the timeline semaphore
 	// and the imageIndex which is the argument of our acquireNextImage()
 	// the we return the result
-	
-	// Note that this code needs to be refactored because the validation layer is warning us
-	// about the acquireswapchain per frame instead of per image
 	VkResult ikEngineSwapChain::acquireNextImage(uint32_t* imageIndex) {
-		vkWaitForFences(device.device(), 1, &inFlightFences[currentFrame], VK_TRUE, std::numeric_limits<uint64_t>::max());
+		//there is no presentation engine holding images back, offscreen images are simply used in turn
+		if (headless) {
+			*imageIndex = nextOffscreenImage;
+			nextOffscreenImage = (nextOffscreenImage + 1) % static_cast<uint32_t>(swapChainImages.size());
+			return VK_SUCCESS;
+		}
 	
 		VkResult result = vkAcquireNextImageKHR(device.device(),
 			swapChain, std::numeric_limits<uint64_t>::max(),
@@ -112,17 +129,12 @@ namespace ikE {
 
 	// submitCommandBuffers() with three parameter list is responsible for 
 	// submitting a recorded command buffer to the GPU for rendering
-	// Handling sychronization through fences and semaphores
+	// Handling sychronization through semaphores
 	// presenting the rendered image to the swap chain
 	// Managing frames in fight for pipeline rendering
-	// inside the function we start with an if statement
-	// the imagesInFlight[] is an array which is an object of std::vector<VkFence> handle
-	//  has imageIndex pointer as an integer index of the array and it is compared to VK_NULL_HANDLE if true
-	//  it tracks which Fence is currently using this swap chain image
-	// inside the if statement we call vkWaitForFences() if the image is still being
-	// used by the GPU (fence not signaled), CPU waits indefinitely until the GPU finishes(UINT64_MAX)
-	// then the image is assigned the current frame's fence so we know it's in use
-	// by assigning inFlightFences array to imageInFlight notice that both are VKFence object
+	// inside the function we start by taking the next frame number from the device with advanceFrame()
+	// the frame timeline semaphore gets this value once the GPU has finished the submission
+	// and frameNumbers[] remembers it for the frame slot so waitForFrame knows what to wait on
 	// we then create a struct to submint the commands called VkSubmitInfo
 	// .sType it required for vulkan to know which type of struct it is dealing with
 	//  waitSemaphores[] is an array of type VkSemaphore which is a sync between 
@@ -143,18 +155,16 @@ namespace ikE {
 	//  .commandBufferCount = 1 Number of command buffers to submit
 	//  .pCommandBuffers array of command buffers the buffers contain the recorded GPU commands
 	//   like draw calls,dispatch,barriers e.t.c in this case it is the rendering command
-	//  signalSemaphore{] then we have to signal the GPU with renderFinishedSemaphores with the currentFrame as index
+	//  signalSemaphore{] then we have to signal the GPU with renderFinishedSemaphores with the image index as index
 	//  that the command buffer has finished execution so that the CPU can present it safely
-	//  notice that because the commandBufferCount is 1 the signalSemaphore count is also 1
+	//  one per swap chain image, the image is only acquired again once its last present has waited on it
+	//  the second signal semaphore is the frame timeline, its value comes from the VkTimelineSemaphoreSubmitInfo
+	//  chained to the submit, the binary semaphore ignores its value
 	//  .pSignalSemaphores which is also ov type VkSemaphore handle is assigned the signalSemaphores array
-	//  vkResetFences takes one more fences and resets them from signaled to unsignaled so it can be reused
-	//  here it takes in the logical device(), the fenceCount which is 1 and VkFence handle
 	//  then we submit the commands to the graphics pipeline via vkQueueSubmit
 	//  vkQueueSubmit takes the device(), the number of batches of work we are submitting
-	//  and the inFlightFences[currentFrame] which tells vulkan to associate fence with commands
-	//  we just submitted.When the GPU finishes this submission, signal the fence to continue
-	//  processing the next submission 
-	//  remember that fence is CPU and semaphores is GPU synchronization
+	//  and no fence, the CPU waits on the timeline semaphore reaching the frame number instead
+	//  remember that the timeline semaphore is what the CPU waits on and the binary semaphores are GPU synchronization
 	//  to present the image into swapchain for rendering we need to create a VkpresentKHR struct
 	//  we create the zero initialized struct
 	//  .sType which is a must in vulkan before filling up any struct so vulkan know which type of struct it is
@@ -170,10 +180,34 @@ namespace ikE {
 	//  then we update the frame index for the next iteration of the render loop via
 	//  MAX_FRAMES_IN_FLIGHT by shifting it 1 place and wrap in it around via modulo because it is a circular buffer
 	VkResult ikEngineSwapChain::submitCommandBuffers(const VkCommandBuffer* buffers, uint32_t* imageIndex) {
-		if (imagesInFlight[*imageIndex] != VK_NULL_HANDLE) {
-			vkWaitForFences(device.device(), 1, &imagesInFlight[*imageIndex], VK_TRUE, UINT64_MAX);
+		uint64_t frame = device.advanceFrame();
+		frameNumbers[currentFrame] = frame;
+		presentIdCounter += 1;
+		framePresentIds[currentFrame] = presentIdCounter;
+
+		//headless frames neither wait on an acquire nor signal a present, the timeline alone paces them
+		if (headless) {
+			VkSemaphore timeline = device.frameTimeline();
+			VkTimelineSemaphoreSubmitInfo timelineInfo{};
+			timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+			timelineInfo.signalSemaphoreValueCount = 1;
+			timelineInfo.pSignalSemaphoreValues = &frame;
+
+			VkSubmitInfo submitInfo = {};
+			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.pNext = &timelineInfo;
+			submitInfo.commandBufferCount = 1;
+			submitInfo.pCommandBuffers = buffers;
+			submitInfo.signalSemaphoreCount = 1;
+			submitInfo.pSignalSemaphores = &timeline;
+
+			if (vkQueueSubmit(device.graphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+				throw std::runtime_error("failed to submit draw command buffers!");
+			}
+			currentFrame = (currentFrame + 1) % pacing.framesInFlight;
+			return VK_SUCCESS;
 		}
-		imagesInFlight[*imageIndex] = inFlightFences[currentFrame];
+
 		//prepare the semaphores
 		VkSubmitInfo submitInfo = {};
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -188,12 +222,18 @@ namespace ikE {
 		submitInfo.commandBufferCount = 1;
 		submitInfo.pCommandBuffers = buffers;
 		//signalSemaphores
-		VkSemaphore signalSemaphores[] = { renderFinishedSemaphores[currentFrame] };
-		submitInfo.signalSemaphoreCount = 1;
+		VkSemaphore signalSemaphores[] = { renderFinishedSemaphores[*imageIndex], device.frameTimeline() };
+		uint64_t signalValues[] = { 0, frame };
+		submitInfo.signalSemaphoreCount = 2;
 		submitInfo.pSignalSemaphores = signalSemaphores;
 
-		vkResetFences(device.device(), 1, &inFlightFences[currentFrame]);
-		if (vkQueueSubmit(device.graphicsQueue(), 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS) {
+		VkTimelineSemaphoreSubmitInfo timelineInfo{};
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.signalSemaphoreValueCount = 2;
+		timelineInfo.pSignalSemaphoreValues = signalValues;
+		submitInfo.pNext = &timelineInfo;
+
+		if (vkQueueSubmit(device.graphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
 			throw std::runtime_error("failed to submit draw command buffers!");
 
 		}
@@ -202,7 +242,7 @@ namespace ikE {
 		VkPresentInfoKHR presentInfo = {};
 		presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 		presentInfo.waitSemaphoreCount = 1;
-		presentInfo.pWaitSemaphores = signalSemaphores;
+		presentInfo.pWaitSemaphores = &renderFinishedSemaphores[*imageIndex];
 
 		VkSwapchainKHR swapChains[] = { swapChain };
 		presentInfo.swapchainCount = 1;
@@ -210,8 +250,17 @@ namespace ikE {
 
 		presentInfo.pImageIndices = imageIndex;
 
+		//the id is what waitForFrame waits on
+		VkPresentIdKHR presentId{};
+		presentId.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+		presentId.swapchainCount = 1;
+		presentId.pPresentIds = &presentIdCounter;
+		if (presentWaitEnabled) {
+			presentInfo.pNext = &presentId;
+		}
+
 		auto result = vkQueuePresentKHR(device.presentQueue(), &presentInfo);
-		currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+		currentFrame = (currentFrame + 1) % pacing.framesInFlight;
 		return result;
 
 	}
@@ -254,6 +303,10 @@ namespace ikE {
 	// then we will call vkCreateSwapchain() and give it the getter device(), the createInfo struct,
 	// the allocationcallbacks pointer which we will make nullptr and vkswapchainKhr handle that is instanced by swapchain
 	void ikEngineSwapChain::createSwapChain() {
+		if (headless) {
+			createOffscreenImages();
+			return;
+		}
 		SwapChainSupportDetails swapChainSupport = device.getSwapChainSupport();
 
 		VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
@@ -344,269 +397,16 @@ namespace ikE {
 	//  a pointer to VKImageViewCreateInfo, pallocator which is null and VkImageView pointer which
 	//  we referenced with swapChainImageView at index i which is the handle we will bind in framebuffer,
 	//  descriptors e.t.c
-	void ikEngineSwapChain::createImageViews() {
-		swapChainImageViews.resize(swapChainImages.size());
-		for (size_t i = 0; i < swapChainImages.size(); i++) {
-			VkImageViewCreateInfo viewInfo{};
-			viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-			viewInfo.image = swapChainImages[i];
-			viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-			viewInfo.format = swapChainImageFormat;
-			viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			viewInfo.subresourceRange.baseMipLevel = 0;
-			viewInfo.subresourceRange.levelCount = 1;
-			viewInfo.subresourceRange.baseArrayLayer = 0;
-			viewInfo.subresourceRange.layerCount = 1;
-
-			if (vkCreateImageView(device.device(), &viewInfo, nullptr, &swapChainImageViews[i]) != VK_SUCCESS) {
-				throw std::runtime_error("failed to create texture image view!");
-			}
-		}
-
-	}
-	// A renderPass is like a blueprint for how rendering into framebuffers will happen
-	// so The createRenderPass() describes the attachments(color/depth images) how they are used(loads/store operations)
-	// the subpasses(sections of the rendering pipeline), synchronization between subpasses
-	// we first start by calling a zero initialzed struct notice that we did not use the 
-	// sType in VkAttachmentDescription because there is no word as Create in it name
-	// the VkAttachmentDescription is for the depth Attachment setup
-	// .format has findDepthFormat() assigned to it which is responsible in picking a supported format
-	// .sample has Vk_sample_count_1_bit meaning we are not using multisample anti aliasing(MSAA)
-	// instead we using single-sample per pixel
-	// .loadOp this defines what happens to the color/depth contents
-	//  of the attachment at the start of the render pass the depth buffer is cleared at the start of the render pass
-	// .storeOp defines what happens to the color/depth contents of the attachment at the end of the render pass
-	//  the VK_ATTACHMENT_STORE_OP_DONT_CARE means we do not save the dpeth after the render pass(only needed
-	//  for depth testing, not post-processing)
-	// .stencilLoadOp same as loadOp,but specifically for the stencil aspect(if using a depth stencil attachment)
-	// .stencilStoreOp sam as storeOp, but for stencil aspect
-	// .initialLayout layout of the image before the render pass begins it tells vulkan what state the image
-	//  is in when the pass starts
-	// .finalLayout lyout of the image after the render pass ends VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
-	//	Tells vulkan that if the contiuing as depth
-	// then we create another zero initalized struct VkAttachmentReference struct which is used to tell vulkan
-	// which image attachments are used in which subpasses and how they should be accessed
-	// .attachment this specifies the index of the attachment in the VkRenderPassCreateInfo::pAttachment array
-	//  which is 1 in our case meaning the second attachment
-	// .layout this specifies the layout the attachment must be in during the subpass which is
-	// VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL which is an imput attchment in a shader
-	// then we call another zero initialized struct VkAttachmentDescription for the colorAttachment setup
-	// .format will be assign getSwapChainImageFormat() which is of type VkFormat
-	// .samples number of samples per pixel in our case it means no MSAA
-	// .loadOp defines what happens to the attachment contents at the start of the render pass
-	// .storeOp defines what happens to the attachment contents at the end of the render pass
-	// .stencilLoadOp same as loadOp but applies only to the stencil aspect
-	// .stencilStoreOp same as the storeOp but applies only to the stncil aspect
-	// .initialLayout the layout the image will be in before the reder pass starts
-	// .finalLayout meaning it end in VK_IMAGE_LAYOUT_PRESENT_SRC_KHR so the swapchain can present it
-	// we then initailize another zero struct VkAttachmentReference
-	// .attachment refers to the first attachment in the array at index 0
-	// .layout will be used as the color target in the subpass
-	
-	// we then initialize another zero initialize struct for the subpass Description
-	// subpass is a phase of rendering that can read/write attachments(like color, depth, or input attachments)
-	// .pipelineBindPoint it indicates the type of pipeline that will be used in this subpass
-	//  VK_PIPELINE_BIND_GRAPHICS is for standard graphics pipeline(not compute)
-	// .colorAttachmentCount is the number of input attachments used in this subpass in this case is 1
-	// .pcolorattachment a pointer to an array of VkAttachmentReference for color attachments
-	//  each reference tells Vulkan which attachment ot write to and in which layout
-	// .pDepthStencilAttachment a pointer to a single VkAttachmentReference for the depth/stencil buffer
-	//  this is used for depth test, stencil test, and depth writes
-	// we now create another zero initialized struct VkSubpassDependency
-	// VkSupbassDependency this struct defines dependencies between subpasses, ensuring proper ordering
-	// and memory visibility.it controls when one subpass can start using resources written by another
-	// .srcSubpass index of the source subpass the VK_SUBPASS_EXTERNAL refers to operations outside the
-	//  render pass, like before the first subpass or after the last
-	//  this is the subpass that produces data or has side effects that the destination subpass depends on
-	// .srcAccessMask pipeline stage in the destination subpass that must wait for the source it
-	//  tells vulkan where to block execution until the source is done in the zeroth index
-	// .srcStageMask pipeline stages in the source subpass that must complete before the dependency
-	//  it defines which stage of the pipeline produces the data we care about
-	// .dstStageMask is the pipeline stages in the destination subpass that must wait for the source
-	//  it tell vulkan where to block execution until the source is done
-	// .dstAccessMaskt tells vulkan what type of memory access the destination subpass needs to wait
-	//  for before starting
-	//  we will now create an array via std::array with 2 index that will be passed to the VKRenderPassCreateInfo struct
-	//  we will now create a zero initialized struct of VkRenderPassCreateInfo struct
-	// .sType sets the type of struct required by vulkan
-	// .attachmentCount sets the number of attachments in the render pass via attachment.size() which is 2
-	//  then we ensure the type matches Vulkan uint32_t by casting it notice that size() is not a primitive type but a
-	//  a numeric value of uint64_t and we are casting it to uint32_t which is safe via static_cast
-	// .Attachments passes a pointer to the array attachments. Vulkan will use this to know which images
-	//  exist in the render pass and how they behave
-	// .subpassCount the render pass has one subpass most simple pipelines have a single subpass for drawing
-	// .pSubpasses it is assigned &subpass which is a VkSubpassDescription struct and tells vulkan how this
-	//  subpass uses the attachments(color,depth,input attachments, e.t.c)
-	// then we call vkCreateRenderPass() which has the logical device,VkRenderPasCreateInfo struct,
-	// pallocator which we made a nullptr and VkRenderPass handle with a if statement
-	void ikEngineSwapChain::createRenderPass() {
-		VkAttachmentDescription depthAttachment{};
-		depthAttachment.format = findDepthFormat();
-		depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-		depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-		depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-		depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-		depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-		depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-		VkAttachmentReference depthAttachmentRef{};
-		depthAttachmentRef.attachment = 1;
-		depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-		VkAttachmentDescription colorAttachment = {};
-		colorAttachment.format = getSwapChainImageFormat();
-		colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-		colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-		colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-		colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-		colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-		VkAttachmentReference colorAttachmentRef = {};
-		colorAttachmentRef.attachment = 0;
-		colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-
-		VkSubpassDescription subpass = {};
-		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-		subpass.colorAttachmentCount = 1;
-		subpass.pColorAttachments = &colorAttachmentRef;
-		subpass.pDepthStencilAttachment = &depthAttachmentRef;
-
-		VkSubpassDependency dependency = {};
-
-		dependency.dstSubpass = 0;
-	    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-		dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-		dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-		dependency.srcAccessMask = 0;
-		dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-
-
-	
+	// headless mode stands in for the swap chain with its own color images, one more than the frames in flight
+	// like a triple buffered swap chain. they are color attachments with TRANSFER_SRC usage so a frame can be read back
+	void ikEngineSwapChain::createOffscreenImages() {
+		swapChainImageFormat = VK_FORMAT_R8G8B8A8_SRGB;
+		swapChainExtent = windowExtent;
 
-		std::array<VkAttachmentDescription, 2> attachments = { colorAttachment, depthAttachment };
-		VkRenderPassCreateInfo renderPassInfo = {};
-		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-		renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-		renderPassInfo.pAttachments = attachments.data();
-		renderPassInfo.subpassCount = 1;
-		renderPassInfo.pSubpasses = &subpass;
-		renderPassInfo.dependencyCount = 1;
-		renderPassInfo.pDependencies = &dependency;
-
-		if (vkCreateRenderPass(device.device(), &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS) {
-			throw std::runtime_error("failed to create render pass!");
-
-		}
-
-	}
-
-	// a framebuffer is a collection of attachments(color,depth,etc) that a render pass will render into
-	// so createFramebufffers() is a functon that helps create framebuffers for every image in the swapchain
-	// swapChainFramebuffers is an std::vector<VkFramebuffers> and imageCount() returns the number of images
-	// in the swapchain because each swapchain image will have corresponding framebuffer, so we resize the
-	// vector to hold all of them
-	// we iterate over each swapchain image because each image needs a framebuffer to attach its color and depth views
-	// inside the for loop the vkImageView has 2 attachments which is
-	// swapChainImageView[i] which is the color attachment (the swapchain image that will be presented)
-	// depthImageViews[i] which is the depth attachment(used for depth testing)
-	// with swapChainExtent which is of type VkExtent2D and assigned getSwapChainExtent() which
-	// is also of type VkExtent2D we will be able to return the width and height of the swapchain images
-	// we will then create VkFramebufferCreateInfo which is a zero initialized struct
-	// .sType identifies the struct type
-	// .renderPass will be assign renderPass which is of type VkRenderPass handle
-	// .attachmentCount is the number of attachment which is 2 in this case (color and depth)
-	//  std::array<VkImageView,2> is a vector and the attachment.size() returns a size_t type
-	//  which is 64 bits on 64 bit systems , attachmentCount is a uint32_t type meaning a 32bit unsigned
-	//  we will need a static cast it meaning a wider range to a narrower range else the compiler will
-	//  throw an error
-	//  .width we assign the width which is of type VkExtent2D
-	//  .height we assign the height which is of type VkExtent2D
-	//  .layers is the number of layers which is 1 fo a standard 2D images
-	//  
-	void ikEngineSwapChain::createFramebuffers() {
-		swapChainFramebuffers.resize(imageCount());
-		for (size_t i = 0; i < imageCount(); i++) {
-			std::array<VkImageView, 2>attachments = { swapChainImageViews[i], depthImageViews[i] };
-
-			VkExtent2D swapChainExtent = getSwapChainExtent();
-			VkFramebufferCreateInfo framebufferInfo = {};
-			framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-			framebufferInfo.renderPass = renderPass;
-			framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-			framebufferInfo.pAttachments = attachments.data();
-			framebufferInfo.width = swapChainExtent.width;
-			framebufferInfo.height = swapChainExtent.height;
-			framebufferInfo.layers = 1;
-
-			if (vkCreateFramebuffer(device.device(), &framebufferInfo, nullptr, &swapChainFramebuffers[i]) != VK_SUCCESS) {
-				throw std::runtime_error("failed to create framebuffer!");
-			}
-		}
-	}
-	// the swapchain images only provide color attachments(the image shown on screen)
-	// To render correctly in 3D,we will need a depth buffer to store per-pixel depth values,
-	// so the GPU can descide which fragments are in front or behind
-	// the createDepthResources() creates one depth image + memory+image view for each swapchain image
-	// we start by assigning findDepthFormat() of type VkFormat which is an enum and it picks a supported GPU format
-	// (commonly VK_FORMAT_D32_FLOAT or VK_FORMAT_D24_UNORM_S8_UINT) its job is to find suitable depth buffer format
-	// for the swap chain/framebuffer
-	// getSwapChainExtent wich is of type VkExtent2D matches the swapchain resolution, so the depth buffer is the same
-	// size as the color image
-	// depthImages of type VkImage handle allocates array to hold a depth image
-	// depthImageMemory of type VkDeviceMemory handle is also an array that holds memory
-	// depthImageView of type VkImageViews handle is also an array that holds image view per swapchain image
-	// Each swapchain image need its own depth attachment, because multiple frames can be in flight
-	// we now create the Depth Image by creating a zero initialized struct of VkImageCreateInfo
-	// .sType is an enum required by vulkan to know which struct we are dealing with
-	// .imageType is the Dimensionality of the image
-	// .extent.width is the width of the image
-	// .extent.height is the height of the image
-	// .extent.depth in this case is 1 because it is a 2D image
-	// .mipLevels is the number of mipmap levels in the case because it is depth it is 1 
-	//  if it was for textures we might use multiple mipmaps    
-	// .arrayLayers is the number of layers in the image array for depth buffer is usually 1
-	// .format specifies how pixel data is stored
-	// .tiling which is memory layout preference here we are using optimal layout for GPU
-	// .usage Bitmask of how the image will be used
-	// .samples here we use VK_SAMPLE_COUNT_1_BIT for non-MSAA which is multisampling
-	// .Controls ownership across queue families SHARING_MODE_EXCLUSIVE means owned by one queue family at a time
-	// .bitmask of VkImageCreateFlagBits which is 0 for depth images
-	// then we call createImageWithInfo which stores handle in depthImage[i] which is of type VkDeviceMemory handle
-	// and its memory in depthImageMemorys[i] which is of type VkImageView handle
-	// it creates the VkImage and allocates GPU memory via VkDeviceMemory , Device-local memory is fast GPU memory
-	// which is not visible to CPU and perfect for depth
-	// the next zero initialized struct is VkImageViewCreateInfo which describes how to create a view into an image
-	// because images in Vulkan are raw memory witn no inherent interpretation An Image view tells vulkan how to 
-	// access that image, its format,mipmap levels, array layers and component mapping
-	// .sType is an enum that is required by vulkan to let it know which type of struct it is dealing with
-	// .image is the handle to the image you're creating the view for in this case depthImage array of type
-	//  VkImage handle at index i 
-	// .viewType is how we want to view the image in this case it is VK_IMAGE_VIEW_TYPE_2D
-	// .format which tell vulkan the pixel format for the view and it is of type Vkformat
-	// the subresourceRange describes which part of the image the view will access
-	// .subresourceRange.aspectMask tells vulkan which aspect of image of an image you want to work  with
-	// in this case VK_IMAGE_ASPECT_DEPTH_BIT this selects the depth aspect of an image
-	// .subresourceRange.baseMipLevel tells vulkan the first mipmap level to use in this case it is 0
-	// .subresourceRange.levelCount is the number of mip levels in the case 1
-	// .subresourceRange.baseArrayLayer First array layer to use in this case 0
-	// .layerCount is the number of array layers in this case is 1
-	// then we call vkCreateImageView with an if statement with arguments device.device() which is the logical device,
-	// address to Viewinfo which is of type vkCreateImageView struct, pAllocator which is a pointer and we leave it
-	// as a nullptr,depthImageViews of type VkImageView handle and check if it is succesfull else throw std error
-	void ikEngineSwapChain::createDepthResources() {
-		VkFormat depthFormat = findDepthFormat();
-		swapChainDepthFormat = depthFormat;
-		VkExtent2D swapChainExtent = getSwapChainExtent();
-
-		depthImages.resize(imageCount());
-		depthImageMemorys.resize(imageCount());
-		depthImageViews.resize(imageCount());
-
-		for(int i = 0; i < depthImages.size(); i++){ 
+		uint32_t imageCount = pacing.framesInFlight + 1;
+		swapChainImages.resize(imageCount);
+		offscreenImageMemorys.resize(imageCount);
+		for (uint32_t i = 0; i < imageCount; i++) {
 			VkImageCreateInfo imageInfo{};
 			imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 			imageInfo.imageType = VK_IMAGE_TYPE_2D;
@@ -615,60 +415,100 @@ namespace ikE {
 			imageInfo.extent.depth = 1;
 			imageInfo.mipLevels = 1;
 			imageInfo.arrayLayers = 1;
-			imageInfo.format = depthFormat;
+			imageInfo.format = swapChainImageFormat;
 			imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
 			imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-			imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+			imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
 			imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
 			imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 			imageInfo.flags = 0;
 
-			device.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, depthImages[i], depthImageMemorys[i]);
+			device.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, swapChainImages[i], offscreenImageMemorys[i]);
+		}
+	}
 
+	void ikEngineSwapChain::readOffscreenImage(uint32_t imageIndex, VkImageLayout layout, std::vector<uint8_t>& rgba) {
+		assert(headless && "Only offscreen images can be read back");
+		VkDeviceSize size = static_cast<VkDeviceSize>(swapChainExtent.width) * swapChainExtent.height * 4;
+
+		VkBuffer stagingBuffer;
+		VkDeviceMemory stagingBufferMemory;
+		device.createBuffer(
+			size,
+			VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			stagingBuffer,
+			stagingBufferMemory);
+
+		//waits for the copy to finish, so it has landed when it returns
+		device.copyImageToBuffer(swapChainImages[imageIndex], layout, stagingBuffer, swapChainExtent.width, swapChainExtent.height);
+
+		void* data;
+		vkMapMemory(device.device(), stagingBufferMemory, 0, size, 0, &data);
+		rgba.resize(static_cast<size_t>(size));
+		std::memcpy(rgba.data(), data, static_cast<size_t>(size));
+		vkUnmapMemory(device.device(), stagingBufferMemory);
+
+		vkDestroyBuffer(device.device(), stagingBuffer, nullptr);
+		vkFreeMemory(device.device(), stagingBufferMemory, nullptr);
+	}
+
+	void ikEngineSwapChain::createImageViews() {
+		swapChainImageViews.resize(swapChainImages.size());
+		for (size_t i = 0; i < swapChainImages.size(); i++) {
 			VkImageViewCreateInfo viewInfo{};
 			viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-			viewInfo.image = depthImages[i];
+			viewInfo.image = swapChainImages[i];
 			viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-			viewInfo.format = depthFormat;
-			viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+			viewInfo.format = swapChainImageFormat;
+			viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 			viewInfo.subresourceRange.baseMipLevel = 0;
 			viewInfo.subresourceRange.levelCount = 1;
 			viewInfo.subresourceRange.baseArrayLayer = 0;
 			viewInfo.subresourceRange.layerCount = 1;
 
-			if (vkCreateImageView(device.device(), &viewInfo, nullptr, &depthImageViews[i]) != VK_SUCCESS) {
-				throw std::runtime_error("failed to create texture image view! ");
+			if (vkCreateImageView(device.device(), &viewInfo, nullptr, &swapChainImageViews[i]) != VK_SUCCESS) {
+				throw std::runtime_error("failed to create texture image view!");
 			}
-		
 		}
+
 	}
 	// because vukan rendering is highly parallel and asynchrounous we need a sycnhronization primitives to coordinate
 	// i.e semaphores which is GPU to GPU operations(wait uintil the image is ready before rendering, wait until rendering
-	// is done before presenting it) fences which is GPU to CPU operation(CPU waits until GPU has finished a frame before 
-	// reusing resources)
+	// is done before presenting it) and the device's frame timeline semaphore which is GPU to CPU operation(CPU waits
+	// until GPU has finished a frame before reusing resources)
 	// in createSyncObjects() we use binary semaphores which is default in vulkan is responsible for
-	// creating all the primitives the renderer will need for managing frames in flight because in vulkan
-	// we must explicitly create semaphores and fences before we can use them
+	// creating the primitives the swap chain will need for managing frames in flight because in vulkan
+	// we must explicitly create semaphores before we can use them
 	// the createSyncObjects() crates 1 semaphore which is imageAvailableSemaphore per frame
-	// 1 semaphore which is renderFinishedSemaphores per frame and 1 fence which is inFlighFence per frame
+	// and 1 semaphore which is renderFinishedSemaphores per swap chain image
 	// imageAvailableSemaphores which is of type VkSemaphore handle is resized and its argument is 
 	void ikEngineSwapChain::createSyncObjects() {
-		imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-		renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-		inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
-		imagesInFlight.resize(imageCount(), VK_NULL_HANDLE);
+		imageAvailableSemaphores.resize(pacing.framesInFlight);
+		renderFinishedSemaphores.resize(imageCount());
+
+		//a recreated swap chain continues the frame slots of the previous one, the frames still in flight on it are
+		//waited on by their frame number and currentFrame keeps matching the renderer's frame index
+		if (oldSwapChain != nullptr && oldSwapChain->frameNumbers.size() == static_cast<size_t>(pacing.framesInFlight)) {
+			frameNumbers = oldSwapChain->frameNumbers;
+			currentFrame = oldSwapChain->currentFrame;
+			framePresentIds = oldSwapChain->framePresentIds;
+		}
+		else {
+			frameNumbers.resize(pacing.framesInFlight, 0);
+			framePresentIds.resize(pacing.framesInFlight, 0);
+		}
 
 		VkSemaphoreCreateInfo semaphoreInfo = {};
 		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-		
-		VkFenceCreateInfo fenceInfo = {};
-		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-		fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-			if (vkCreateSemaphore(device.device(), &semaphoreInfo, nullptr, &imageAvailableSemaphores[i]) != VK_SUCCESS ||
-				vkCreateSemaphore(device.device(), &semaphoreInfo, nullptr, &renderFinishedSemaphores[i]) != VK_SUCCESS ||
-				vkCreateFence(device.device(), &fenceInfo, nullptr, &inFlightFences[i]) != VK_SUCCESS) {
+
+		for (auto& semaphore : imageAvailableSemaphores) {
+			if (vkCreateSemaphore(device.device(), &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+				throw std::runtime_error("failed to create synchronization objects for a frame !");
+			}
+		}
+		for (auto& semaphore : renderFinishedSemaphores) {
+			if (vkCreateSemaphore(device.device(), &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
 				throw std::runtime_error("failed to create synchronization objects for a frame !");
 			}
 		}
@@ -683,22 +523,19 @@ namespace ikE {
 	}
 
 	VkPresentModeKHR ikEngineSwapChain::chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes) {
-		//MailBox(low letency,no tearing)
-		for (const auto& availablePresentMode : availablePresentModes) {
-			if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) {
-				std::cout << "Present mode: Mailbox" << std::endl;
-				return availablePresentMode;
-			}
-		}
-		// Then try IMMEDIATE (low latency, may tear)
-		for (const auto& mode : availablePresentModes) {
-			if (mode == VK_PRESENT_MODE_IMMEDIATE_KHR) {
-				std::cout << "Present mode: Immediate (may tear)" << std::endl;
-				return mode;
-			}
+		std::vector<VkPresentModeKHR> preferred;
+		switch (pacing.presentPolicy) {
+		case PresentPolicy::Mailbox: preferred = { VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR }; break;
+		case PresentPolicy::LowLatency: preferred = { VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR }; break;
+		case PresentPolicy::VSync: break;
 		}
 
-
+		for (VkPresentModeKHR mode : preferred) {
+			if (std::find(availablePresentModes.begin(), availablePresentModes.end(), mode) == availablePresentModes.end()) continue;
+			//MailBox(low letency,no tearing), IMMEDIATE (low latency, may tear)
+			std::cout << (mode == VK_PRESENT_MODE_MAILBOX_KHR ? "Present mode: Mailbox" : "Present mode: Immediate (may tear)") << std::endl;
+			return mode;
+		}
 
 		std::cout << "Present mode: V-Sync" << std::endl;
 		return VK_PRESENT_MODE_FIFO_KHR;
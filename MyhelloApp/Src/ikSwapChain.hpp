@@ -11,35 +11,66 @@
 #include <vector>
 
 namespace ikE {
+	//which present mode the swap chain asks for, each falls back to FIFO, the only mode every driver has
+	enum class PresentPolicy {
+		Mailbox, //no tearing and no waiting on vblank, then IMMEDIATE
+		LowLatency, //IMMEDIATE, tears but shows a frame as soon as it is done, then MAILBOX
+		VSync //FIFO, the presentation engine paces the frames at the display's refresh rate
+	};
+
+	//how frames are paced, chosen at startup, see IkeRenderer::waitForNextFrame
+	struct FramePacing {
+		//frames the CPU may record ahead of the GPU, 1 has the lowest latency and 3 the most throughput
+		int framesInFlight = 2;
+		PresentPolicy presentPolicy = PresentPolicy::Mailbox;
+		//waits until the previous frame is on screen before the next one samples input, needs VK_KHR_present_wait
+		bool presentWait = false;
+		//sleeps so a frame starts as late as still makes this rate, 0 renders as fast as the swap chain allows
+		int targetFps = 0;
+	};
 
 	class ikEngineSwapChain {
 	public:
-		static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
+		//upper bound of FramePacing::framesInFlight, per frame resources elsewhere are sized by it
+		static constexpr int MAX_FRAMES_IN_FLIGHT = 3;
 
-		ikEngineSwapChain(IkeDeviceEngine& deviceref, VkExtent2D windowExtent);
-		ikEngineSwapChain(IkeDeviceEngine& deviceref, VkExtent2D windowExtent,std::shared_ptr<ikEngineSwapChain> previous);
+		ikEngineSwapChain(IkeDeviceEngine& deviceref, VkExtent2D windowExtent, const FramePacing& pacing);
+		ikEngineSwapChain(IkeDeviceEngine& deviceref, VkExtent2D windowExtent, const FramePacing& pacing, std::shared_ptr<ikEngineSwapChain> previous);
 		~ikEngineSwapChain();
 
 		ikEngineSwapChain(const ikEngineSwapChain&) = delete;
 		ikEngineSwapChain& operator=(const ikEngineSwapChain&) = delete;
 
-		VkFramebuffer getFrameBuffer(int index) { return swapChainFramebuffers[index]; }
-		VkRenderPass getRenderPass() { return renderPass; }
 		VkImageView getImageView(int index) { return swapChainImageViews[index]; }
+		const std::vector<VkImageView>& getImageViews() const { return swapChainImageViews; }
 		size_t imageCount() { return swapChainImages.size(); }
 		VkFormat getSwapChainImageFormat() { return swapChainImageFormat; }
 		VkExtent2D getSwapChainExtent() { return swapChainExtent; }
 		uint32_t width() { return swapChainExtent.width; }
 		uint32_t height() { return swapChainExtent.height; }
+		bool isHeadless() const { return headless; }
 
 		float extentAspectRatio() {
 			return static_cast<float>(swapChainExtent.width) / static_cast<float>(swapChainExtent.height);
 		}
 		VkFormat findDepthFormat();
-
+		int framesInFlight() const { return pacing.framesInFlight; }
+		//true when presents carry a present id that waitForFrame can wait on
+		bool isPresentWaitEnabled() const { return presentWaitEnabled; }
+
+		/*blocks until the next frame may be recorded, the GPU finished the frame its slot held last and with present wait
+		  the frame framesInFlight - 1 presents ago is on screen. returns the present id of the newest frame known to be
+		  finished, displayed with present wait and done on the GPU without it, 0 if there is none yet*/
+		uint64_t waitForFrame();
 		VkResult acquireNextImage(uint32_t* imageIndex);
+		//the present id the next submitCommandBuffers gives its frame, ids count up across swap chain recreation
+		uint64_t nextPresentId() const { return presentIdCounter + 1; }
 		VkResult submitCommandBuffers(const VkCommandBuffer* buffers, uint32_t* imageIndex);
 
+		//copies a rendered offscreen image into tightly packed RGBA8 rows, headless only. layout is the final layout of
+		//the render pass that wrote it, the image is back in it afterwards
+		void readOffscreenImage(uint32_t imageIndex, VkImageLayout layout, std::vector<uint8_t>& rgba);
+
 		bool compareSwapFormats(const ikEngineSwapChain& swapChain) const {
 			return swapChain.swapChainDepthFormat == swapChainDepthFormat && swapChain.swapChainImageFormat == swapChainImageFormat;
 		}
@@ -47,10 +78,8 @@ namespace ikE {
 	private:
 		void init();
 		void createSwapChain();
+		void createOffscreenImages();
 		void createImageViews();
-		void createRenderPass();
-		void createDepthResources();
-		void createFramebuffers();
 		void createSyncObjects();
 
 		//helper functions
@@ -63,26 +92,30 @@ namespace ikE {
 		VkFormat  swapChainDepthFormat;
 		VkExtent2D swapChainExtent;
 
-		std::vector<VkFramebuffer> swapChainFramebuffers;
-		VkRenderPass renderPass;
-
-		std::vector<VkImage> depthImages;
-		std::vector<VkDeviceMemory> depthImageMemorys;
-		std::vector<VkImageView> depthImageViews;
 		std::vector<VkImage>   swapChainImages;
 		std::vector<VkImageView>  swapChainImageViews;
+		//only headless mode owns the color images, a real swap chain owns its own
+		std::vector<VkDeviceMemory> offscreenImageMemorys;
 
 		IkeDeviceEngine& device;
 		VkExtent2D windowExtent;    
+		FramePacing pacing;
+		bool headless;
+		bool presentWaitEnabled;
+		uint32_t nextOffscreenImage = 0;
 
-		VkSwapchainKHR swapChain;
+		VkSwapchainKHR swapChain = VK_NULL_HANDLE;
 		std::shared_ptr<ikEngineSwapChain> oldSwapChain;
 
 		std::vector<VkSemaphore> imageAvailableSemaphores;
 		std::vector<VkSemaphore> renderFinishedSemaphores;
-		std::vector<VkFence>     inFlightFences;
-		std::vector<VkFence>     imagesInFlight;
+		//device frame number last submitted from each frame slot, see IkeDeviceEngine::frameTimeline
+		std::vector<uint64_t> frameNumbers;
 		size_t currentFrame = 0;
+		//present id of the frame last submitted from each frame slot, 0 for none
+		std::vector<uint64_t> framePresentIds;
+		uint64_t presentIdCounter = 0;
+		uint64_t firstPresentId = 1; //ids below it were presented by an older swap chain and can not be waited on
 
 
 
@@ -0,0 +1,139 @@
+#include "ikTextureContainer.hpp"
+
+//std
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+namespace ikE {
+
+	namespace {
+		constexpr char MAGIC[4]{ 'I', 'K', 'T', 'X' };
+		constexpr size_t HEADER_SIZE = 32;
+		constexpr size_t DATA_ALIGNMENT = 16;
+
+		size_t chainTableSize(uint32_t mipLevels) {
+			return 8 + static_cast<size_t>(mipLevels) * 16;
+		}
+
+		void appendLittleEndian(std::vector<uint8_t>& out, uint64_t value, int bytes) {
+			for (int i = 0; i < bytes; i++) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+		}
+
+		uint64_t readLittleEndian(const uint8_t* data, int bytes) {
+			uint64_t value = 0;
+			for (int i = bytes - 1; i >= 0; i--) value = (value << 8) | data[i];
+			return value;
+		}
+
+		size_t alignUp(size_t value) {
+			return (value + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+		}
+
+		//floor(log2(max(width, height))) + 1, vulkan allows no more levels for an image of that size
+		uint32_t fullMipLevels(uint32_t width, uint32_t height) {
+			uint32_t levels = 1;
+			for (uint32_t size = std::max(width, height); size > 1; size /= 2) {
+				levels++;
+			}
+			return levels;
+		}
+	}
+
+	void writeTextureContainer(
+		const std::string& filepath,
+		uint32_t width,
+		uint32_t height,
+		bool srgb,
+		const std::vector<TextureChain>& chains) {
+		if (chains.empty() || chains[0].mips.empty()) {
+			throw std::runtime_error("a texture container needs at least one mip chain!");
+		}
+		uint32_t mipLevels = static_cast<uint32_t>(chains[0].mips.size());
+
+		std::vector<uint8_t> tables;
+		tables.insert(tables.end(), MAGIC, MAGIC + 4);
+		appendLittleEndian(tables, IkTextureContainer::VERSION, 4);
+		appendLittleEndian(tables, width, 4);
+		appendLittleEndian(tables, height, 4);
+		appendLittleEndian(tables, mipLevels, 4);
+		appendLittleEndian(tables, srgb ? IkTextureContainer::FLAG_SRGB : 0, 4);
+		appendLittleEndian(tables, chains.size(), 4);
+		appendLittleEndian(tables, 0, 4);
+
+		size_t offset = alignUp(HEADER_SIZE + chains.size() * chainTableSize(mipLevels));
+		for (const auto& chain : chains) {
+			if (chain.mips.size() != mipLevels) {
+				throw std::runtime_error("every chain of a texture container needs the same mip levels!");
+			}
+			appendLittleEndian(tables, static_cast<uint32_t>(chain.format), 4);
+			appendLittleEndian(tables, 0, 4);
+			for (const auto& mip : chain.mips) {
+				appendLittleEndian(tables, offset, 8);
+				appendLittleEndian(tables, mip.size(), 8);
+				offset = alignUp(offset + mip.size());
+			}
+		}
+
+		std::ofstream file{ filepath, std::ios::binary | std::ios::trunc };
+		if (!file.is_open()) {
+			throw std::runtime_error("failed to open file: " + filepath);
+		}
+		const char padding[DATA_ALIGNMENT]{};
+		file.write(reinterpret_cast<const char*>(tables.data()), tables.size());
+		file.write(padding, alignUp(tables.size()) - tables.size());
+		for (const auto& chain : chains) {
+			for (const auto& mip : chain.mips) {
+				file.write(reinterpret_cast<const char*>(mip.data()), mip.size());
+				file.write(padding, alignUp(mip.size()) - mip.size());
+			}
+		}
+		if (!file) {
+			throw std::runtime_error("failed to write file: " + filepath);
+		}
+	}
+
+	IkTextureContainer::IkTextureContainer(const std::string& filepath) : file{ filepath } {
+		const uint8_t* data = file.data();
+		if (file.size() < HEADER_SIZE || std::memcmp(data, MAGIC, 4) != 0) {
+			throw std::runtime_error("not a texture container: " + filepath);
+		}
+		if (readLittleEndian(data + 4, 4) != VERSION) {
+			throw std::runtime_error("unsupported texture container version: " + filepath);
+		}
+		width = static_cast<uint32_t>(readLittleEndian(data + 8, 4));
+		height = static_cast<uint32_t>(readLittleEndian(data + 12, 4));
+		mipLevels = static_cast<uint32_t>(readLittleEndian(data + 16, 4));
+		flags = static_cast<uint32_t>(readLittleEndian(data + 20, 4));
+		uint32_t chainCount = static_cast<uint32_t>(readLittleEndian(data + 24, 4));
+		if (width == 0 || height == 0 || mipLevels == 0 || mipLevels > fullMipLevels(width, height) || chainCount == 0 ||
+			file.size() < HEADER_SIZE + chainCount * chainTableSize(mipLevels)) {
+			throw std::runtime_error("texture container header is corrupt: " + filepath);
+		}
+
+		//every table entry is checked against the file and the size its format needs, so readers can trust them
+		const uint8_t* table = data + HEADER_SIZE;
+		chains.resize(chainCount);
+		for (auto& chain : chains) {
+			uint32_t format = static_cast<uint32_t>(readLittleEndian(table, 4));
+			if (format > static_cast<uint32_t>(BlockFormat::EAC_RG11)) {
+				throw std::runtime_error("texture container has an unknown format: " + filepath);
+			}
+			chain.format = static_cast<BlockFormat>(format);
+			table += 8;
+
+			chain.mips.resize(mipLevels);
+			for (uint32_t mip = 0; mip < mipLevels; mip++) {
+				chain.mips[mip].offset = readLittleEndian(table, 8);
+				chain.mips[mip].size = readLittleEndian(table + 8, 8);
+				table += 16;
+				if (chain.mips[mip].offset % DATA_ALIGNMENT != 0 ||
+					chain.mips[mip].size != mipDataSize(chain.format, getMipWidth(mip), getMipHeight(mip)) ||
+					chain.mips[mip].offset > file.size() || chain.mips[mip].size > file.size() - chain.mips[mip].offset) {
+					throw std::runtime_error("texture container mip table is corrupt: " + filepath);
+				}
+			}
+		}
+	}
+
+}//namespace ikE
@@ -0,0 +1,74 @@
+#ifndef IKTEXTURECONTAINER_HPP
+#define IKTEXTURECONTAINER_HPP
+
+#include "ikBlockCompression.hpp"
+#include "ikMappedFile.hpp"
+
+//std
+#include <cstdint>
+#include <string>
+#include <vector>
+namespace ikE {
+	//one complete mip chain in one format, largest mip first
+	struct TextureChain {
+		BlockFormat format = BlockFormat::RGBA8;
+		std::vector<std::vector<uint8_t>> mips;
+	};
+
+	/*.iktx files hold a texture as one or more pre-baked mip chains of the same image, e.g. BC7 for desktop GPUs and
+	  ETC2 for the rest, written offline by ikTextureBaker. all little endian:
+	    header  "IKTX", version, width, height, mip levels, flags (bit 0 sRGB), chain count, reserved (8 x uint32)
+	    chains  per chain its format and a reserved uint32, then per mip level the offset and size (uint64 each)
+	    data    every mip at a 16 byte aligned offset from the start of the file, in the layout vkCmdCopyBufferToImage
+	            expects, so a loader copies it as it is*/
+	void writeTextureContainer(
+		const std::string& filepath,
+		uint32_t width,
+		uint32_t height,
+		bool srgb,
+		const std::vector<TextureChain>& chains);
+
+	/*IkTextureContainer maps a .iktx file and checks its header and tables, the mip data is read straight from the
+	  mapping and never copied. throws on a file that is not a valid container*/
+	class IkTextureContainer {
+	public:
+		static constexpr uint32_t VERSION = 1;
+		static constexpr uint32_t FLAG_SRGB = 1;
+
+		explicit IkTextureContainer(const std::string& filepath);
+
+		IkTextureContainer(const IkTextureContainer&) = delete;
+		IkTextureContainer& operator =(const IkTextureContainer&) = delete;
+
+		uint32_t getWidth() const { return width; }
+		uint32_t getHeight() const { return height; }
+		uint32_t getMipLevels() const { return mipLevels; }
+		bool isSrgb() const { return (flags & FLAG_SRGB) != 0; }
+		uint32_t getMipWidth(uint32_t mip) const { return width >> mip > 0 ? width >> mip : 1; }
+		uint32_t getMipHeight(uint32_t mip) const { return height >> mip > 0 ? height >> mip : 1; }
+
+		uint32_t getChainCount() const { return static_cast<uint32_t>(chains.size()); }
+		BlockFormat getChainFormat(uint32_t chain) const { return chains[chain].format; }
+		const uint8_t* getMipData(uint32_t chain, uint32_t mip) const { return file.data() + chains[chain].mips[mip].offset; }
+		size_t getMipSize(uint32_t chain, uint32_t mip) const { return static_cast<size_t>(chains[chain].mips[mip].size); }
+
+	private:
+		struct Mip {
+			uint64_t offset;
+			uint64_t size;
+		};
+		struct Chain {
+			BlockFormat format;
+			std::vector<Mip> mips;
+		};
+
+		IkMappedFile file;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		uint32_t mipLevels = 0;
+		uint32_t flags = 0;
+		std::vector<Chain> chains;
+	};
+
+} //namepace
+#endif //header guard
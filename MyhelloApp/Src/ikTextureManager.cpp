@@ -0,0 +1,486 @@
+#include "ikTextureManager.hpp"
+#include "ikCpuProfiler.hpp"
+#include "ikImageReader.hpp"
+#include "ikTextureContainer.hpp"
+
+//std
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+namespace ikE {
+
+	namespace {
+		//decoded images are base color textures, so the shaders read linear values and the blits average in linear space
+		constexpr VkFormat TEXTURE_FORMAT = VK_FORMAT_R8G8B8A8_SRGB;
+		//staging offsets of compressed mips have to be a multiple of the 8 or 16 byte block size
+		constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+		//the bindless table is visible to every stage
+		constexpr VkPipelineStageFlags SHADER_STAGES =
+			VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+		VkFormat toVkFormat(BlockFormat format, bool srgb) {
+			switch (format) {
+			case BlockFormat::RGBA8: return srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+			case BlockFormat::BC1: return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+			case BlockFormat::BC3: return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+			case BlockFormat::BC5: return VK_FORMAT_BC5_UNORM_BLOCK;
+			case BlockFormat::BC7: return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+			case BlockFormat::ETC2_RGB8: return srgb ? VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK : VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+			case BlockFormat::ETC2_RGBA8: return srgb ? VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK : VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK;
+			case BlockFormat::EAC_RG11: return VK_FORMAT_EAC_R11G11_UNORM_BLOCK;
+			}
+			return VK_FORMAT_UNDEFINED;
+		}
+
+		bool isContainer(const std::string& filepath) {
+			return filepath.size() >= 5 && filepath.compare(filepath.size() - 5, 5, ".iktx") == 0;
+		}
+
+		uint32_t fullMipLevels(uint32_t width, uint32_t height) {
+			uint32_t levels = 1;
+			for (uint32_t size = std::max(width, height); size > 1; size /= 2) {
+				levels++;
+			}
+			return levels;
+		}
+
+		void transitionMips(
+			VkCommandBuffer commandBuffer,
+			VkImage image,
+			uint32_t baseMip,
+			uint32_t mipCount,
+			VkImageLayout oldLayout,
+			VkImageLayout newLayout,
+			VkAccessFlags srcAccess,
+			VkAccessFlags dstAccess,
+			VkPipelineStageFlags srcStage,
+			VkPipelineStageFlags dstStage) {
+			VkImageMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcAccessMask = srcAccess;
+			barrier.dstAccessMask = dstAccess;
+			barrier.oldLayout = oldLayout;
+			barrier.newLayout = newLayout;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = image;
+			barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, baseMip, mipCount, 0, 1 };
+			vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+		}
+	}
+
+	IkTexture::IkTexture(IkeDeviceEngine& device, IkDeletionQueue& deletionQueue, IkBindlessTable& bindlessTable, std::string filepath)
+		: ikeDevice{ device }, deletionQueue{ deletionQueue }, bindlessTable{ bindlessTable }, filepath{ std::move(filepath) } {}
+
+	IkTexture::~IkTexture() {
+		if (bindlessIndex != IkBindlessTable::INVALID_INDEX) {
+			bindlessTable.releaseTexture(bindlessIndex);
+		}
+		if (image == VK_NULL_HANDLE) return;
+
+		VkDevice device = ikeDevice.device();
+		VkImage retiredImage = image;
+		VkImageView retiredView = imageView;
+		VkDeviceMemory retiredMemory = imageMemory;
+		deletionQueue.retire([device, retiredImage, retiredView, retiredMemory]() {
+			if (retiredView != VK_NULL_HANDLE) vkDestroyImageView(device, retiredView, nullptr);
+			vkDestroyImage(device, retiredImage, nullptr);
+			vkFreeMemory(device, retiredMemory, nullptr);
+		});
+	}
+
+	IkTextureManager::IkTextureManager(
+		IkeDeviceEngine& device,
+		IkDeletionQueue& deletionQueue,
+		IkBindlessTable& bindlessTable,
+		IkSamplerCache& samplerCache,
+		const SamplerDesc& samplerDesc)
+		: ikeDevice{ device }, deletionQueue{ deletionQueue }, bindlessTable{ bindlessTable },
+		samplerCache{ samplerCache }, samplerDesc{ samplerDesc } {
+		generateMips = ikeDevice.supportsFormatFeatures(
+			TEXTURE_FORMAT,
+			VK_IMAGE_TILING_OPTIMAL,
+			VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT);
+
+		//every upload has a command buffer of its own that is freed once its fence signaled
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.queueFamilyIndex = ikeDevice.findPhysicalQueueFamilies().graphicsFamily;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		if (vkCreateCommandPool(ikeDevice.device(), &poolInfo, nullptr, &commandPool) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create texture upload command pool!");
+		}
+	}
+
+	IkTextureManager::~IkTextureManager() {
+		//decode errors no longer matter, only the staging buffers of the decodes that worked
+		for (auto& decode : decodes) {
+			try {
+				destroyStaging(decode.staged.get());
+			}
+			catch (...) {
+			}
+		}
+		for (auto& upload : uploads) {
+			vkWaitForFences(ikeDevice.device(), 1, &upload.fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+			finishUpload(upload, false);
+		}
+		vkDestroyCommandPool(ikeDevice.device(), commandPool, nullptr);
+	}
+
+	std::shared_ptr<IkTexture> IkTextureManager::load(const std::string& filepath) {
+		auto existing = textures.find(filepath);
+		if (existing != textures.end()) {
+			if (std::shared_ptr<IkTexture> texture = existing->second.lock()) {
+				return texture;
+			}
+		}
+
+		std::shared_ptr<IkTexture> texture{ new IkTexture(ikeDevice, deletionQueue, bindlessTable, filepath) };
+		textures[filepath] = texture;
+
+		//std::function needs a copyable task, so the promise is shared with it
+		auto promise = std::make_shared<std::promise<StagedImage>>();
+		decodes.push_back(Decode{ texture, promise->get_future() });
+
+		IkeDeviceEngine& device = ikeDevice;
+		decodePool.submit([&device, promise, filepath] {
+			try {
+				IK_PROFILE_ZONE("decode texture");
+				promise->set_value(isContainer(filepath) ? stageContainer(device, filepath) : stageImage(device, filepath));
+			}
+			catch (...) {
+				//the error goes to update(), not to an unrelated decodePool.wait()
+				promise->set_exception(std::current_exception());
+			}
+		});
+		return texture;
+	}
+
+	void IkTextureManager::update() {
+		IK_PROFILE_ZONE("IkTextureManager::update");
+
+		//finished uploads first, so their textures are usable in the frame about to be recorded
+		for (size_t i = 0; i < uploads.size();) {
+			if (vkGetFenceStatus(ikeDevice.device(), uploads[i].fence) != VK_SUCCESS) {
+				i++;
+				continue;
+			}
+			finishUpload(uploads[i], true);
+			if (i + 1 != uploads.size()) uploads[i] = std::move(uploads.back());
+			uploads.pop_back();
+		}
+
+		uint32_t started = 0;
+		for (size_t i = 0; i < decodes.size() && started < MAX_UPLOADS_PER_UPDATE;) {
+			if (decodes[i].staged.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				i++;
+				continue;
+			}
+			Decode decode = std::move(decodes[i]);
+			if (i + 1 != decodes.size()) decodes[i] = std::move(decodes.back());
+			decodes.pop_back();
+
+			StagedImage staged;
+			try {
+				staged = decode.staged.get();
+			}
+			catch (const std::exception& e) {
+				if (decodeErrorsFatal) throw;
+				//the texture keeps INVALID_INDEX, the next load() of its path starts a new decode
+				std::cerr << "failed to load texture " << decode.texture->getFilepath() << ": " << e.what() << std::endl;
+				textures.erase(decode.texture->getFilepath());
+				continue;
+			}
+			//everyone else let go of the texture while it was decoding
+			if (decode.texture.use_count() == 1) {
+				destroyStaging(staged);
+				continue;
+			}
+			startUpload(decode.texture, staged);
+			started++;
+		}
+	}
+
+	void IkTextureManager::waitAll() {
+		while (!decodes.empty() || !uploads.empty()) {
+			for (auto& decode : decodes) {
+				decode.staged.wait();
+			}
+			for (auto& upload : uploads) {
+				vkWaitForFences(ikeDevice.device(), 1, &upload.fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+			}
+			update();
+		}
+	}
+
+	//creating and filling a buffer needs no synchronization with the main thread. returns the mapped memory, the
+	//caller unmaps it once it is filled
+	void* IkTextureManager::createStaging(IkeDeviceEngine& device, VkDeviceSize size, StagedImage& staged) {
+		device.createBuffer(
+			size,
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			staged.buffer,
+			staged.memory);
+		void* data;
+		if (vkMapMemory(device.device(), staged.memory, 0, size, 0, &data) != VK_SUCCESS) {
+			vkDestroyBuffer(device.device(), staged.buffer, nullptr);
+			vkFreeMemory(device.device(), staged.memory, nullptr);
+			throw std::runtime_error("failed to map texture staging memory!");
+		}
+		return data;
+	}
+
+	IkTextureManager::StagedImage IkTextureManager::stageImage(IkeDeviceEngine& device, const std::string& filepath) {
+		DecodedImage image = readImage(filepath);
+
+		StagedImage staged{};
+		staged.width = image.width;
+		staged.height = image.height;
+		staged.format = TEXTURE_FORMAT;
+		void* data = createStaging(device, image.rgba.size(), staged);
+		std::memcpy(data, image.rgba.data(), image.rgba.size());
+		vkUnmapMemory(device.device(), staged.memory);
+
+		VkBufferImageCopy region{};
+		region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		region.imageExtent = { image.width, image.height, 1 };
+		staged.regions.push_back(region);
+		return staged;
+	}
+
+	IkTextureManager::StagedImage IkTextureManager::stageContainer(IkeDeviceEngine& device, const std::string& filepath) {
+		IkTextureContainer container{ filepath };
+
+		//the chains in the order the baker wrote them, then RGBA8, which every device samples, to transcode into
+		std::vector<VkFormat> candidates;
+		for (uint32_t chain = 0; chain < container.getChainCount(); chain++) {
+			candidates.push_back(toVkFormat(container.getChainFormat(chain), container.isSrgb()));
+		}
+		candidates.push_back(container.isSrgb() ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM);
+
+		StagedImage staged{};
+		staged.width = container.getWidth();
+		staged.height = container.getHeight();
+		staged.format = device.findSupportedFormat(
+			candidates,
+			VK_IMAGE_TILING_OPTIMAL,
+			VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT);
+		uint32_t chain = 0;
+		bool transcode = true;
+		for (uint32_t c = 0; c < container.getChainCount(); c++) {
+			if (candidates[c] == staged.format) {
+				chain = c;
+				transcode = false;
+				break;
+			}
+		}
+
+		VkDeviceSize size = 0;
+		for (uint32_t mip = 0; mip < container.getMipLevels(); mip++) {
+			VkBufferImageCopy region{};
+			region.bufferOffset = size;
+			region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, mip, 0, 1 };
+			region.imageExtent = { container.getMipWidth(mip), container.getMipHeight(mip), 1 };
+			staged.regions.push_back(region);
+
+			VkDeviceSize mipSize = transcode
+				? mipDataSize(BlockFormat::RGBA8, container.getMipWidth(mip), container.getMipHeight(mip))
+				: container.getMipSize(chain, mip);
+			size = (size + mipSize + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+		}
+
+		uint8_t* data = static_cast<uint8_t*>(createStaging(device, size, staged));
+		try {
+			for (uint32_t mip = 0; mip < container.getMipLevels(); mip++) {
+				uint8_t* target = data + staged.regions[mip].bufferOffset;
+				if (!transcode) {
+					//straight from the mapped file into the staging memory
+					std::memcpy(target, container.getMipData(chain, mip), container.getMipSize(chain, mip));
+					continue;
+				}
+				std::vector<uint8_t> rgba = decodeBlocks(
+					container.getChainFormat(0), container.getMipWidth(mip), container.getMipHeight(mip), container.getMipData(0, mip));
+				std::memcpy(target, rgba.data(), rgba.size());
+			}
+		}
+		catch (...) {
+			vkUnmapMemory(device.device(), staged.memory);
+			vkDestroyBuffer(device.device(), staged.buffer, nullptr);
+			vkFreeMemory(device.device(), staged.memory, nullptr);
+			throw;
+		}
+		vkUnmapMemory(device.device(), staged.memory);
+		return staged;
+	}
+
+	void IkTextureManager::startUpload(const std::shared_ptr<IkTexture>& texture, const StagedImage& staged) {
+		IkTexture& target = *texture;
+		target.width = staged.width;
+		target.height = staged.height;
+		target.format = staged.format;
+		//a single RGBA8 level gets the rest of its chain blitted, containers bring every level
+		uint32_t stagedLevels = static_cast<uint32_t>(staged.regions.size());
+		bool blitMips = stagedLevels == 1 && staged.format == TEXTURE_FORMAT && generateMips;
+		target.mipLevels = blitMips ? fullMipLevels(staged.width, staged.height) : stagedLevels;
+
+		VkImageCreateInfo imageInfo{};
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.extent.width = target.width;
+		imageInfo.extent.height = target.height;
+		imageInfo.extent.depth = 1;
+		imageInfo.mipLevels = target.mipLevels;
+		imageInfo.arrayLayers = 1;
+		imageInfo.format = target.format;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		//each mip is blitted from the one above it, so the image is a transfer source as well
+		imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageInfo.flags = 0;
+		ikeDevice.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, target.image, target.imageMemory);
+
+		Upload upload{};
+		upload.texture = texture;
+		upload.staged = staged;
+
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandPool = commandPool;
+		allocInfo.commandBufferCount = 1;
+		if (vkAllocateCommandBuffers(ikeDevice.device(), &allocInfo, &upload.commandBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("failed to allocate texture upload command buffer!");
+		}
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		vkBeginCommandBuffer(upload.commandBuffer, &beginInfo);
+
+		transitionMips(upload.commandBuffer, target.image, 0, target.mipLevels,
+			VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			0, VK_ACCESS_TRANSFER_WRITE_BIT,
+			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+		vkCmdCopyBufferToImage(
+			upload.commandBuffer,
+			staged.buffer,
+			target.image,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			stagedLevels,
+			staged.regions.data());
+
+		if (blitMips) {
+			recordMipChain(upload.commandBuffer, target);
+		}
+		else {
+			transitionMips(upload.commandBuffer, target.image, 0, target.mipLevels,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+				VK_PIPELINE_STAGE_TRANSFER_BIT, SHADER_STAGES);
+		}
+
+		if (vkEndCommandBuffer(upload.commandBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("failed to record texture upload command buffer!");
+		}
+
+		VkFenceCreateInfo fenceInfo{};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		if (vkCreateFence(ikeDevice.device(), &fenceInfo, nullptr, &upload.fence) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create texture upload fence!");
+		}
+
+		//the frames recorded meanwhile never read the texture, it has no bindless index until the fence signaled
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &upload.commandBuffer;
+		if (vkQueueSubmit(ikeDevice.graphicsQueue(), 1, &submitInfo, upload.fence) != VK_SUCCESS) {
+			throw std::runtime_error("failed to submit texture upload command buffer!");
+		}
+		uploads.push_back(std::move(upload));
+	}
+
+	//every mip starts in TRANSFER_DST with mip 0 written. mip i - 1 becomes a transfer source, is blitted into mip i
+	//at half the size and is then done, so it moves to SHADER_READ_ONLY. the last mip is only ever a destination
+	void IkTextureManager::recordMipChain(VkCommandBuffer commandBuffer, const IkTexture& texture) {
+		int32_t mipWidth = static_cast<int32_t>(texture.width);
+		int32_t mipHeight = static_cast<int32_t>(texture.height);
+		for (uint32_t i = 1; i < texture.mipLevels; i++) {
+			transitionMips(commandBuffer, texture.image, i - 1, 1,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+				VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+			int32_t nextWidth = std::max(mipWidth / 2, 1);
+			int32_t nextHeight = std::max(mipHeight / 2, 1);
+			VkImageBlit blit{};
+			blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, i - 1, 0, 1 };
+			blit.srcOffsets[0] = { 0, 0, 0 };
+			blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
+			blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, i, 0, 1 };
+			blit.dstOffsets[0] = { 0, 0, 0 };
+			blit.dstOffsets[1] = { nextWidth, nextHeight, 1 };
+			vkCmdBlitImage(commandBuffer,
+				texture.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+				texture.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				1, &blit, VK_FILTER_LINEAR);
+
+			transitionMips(commandBuffer, texture.image, i - 1, 1,
+				VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT,
+				VK_PIPELINE_STAGE_TRANSFER_BIT, SHADER_STAGES);
+
+			mipWidth = nextWidth;
+			mipHeight = nextHeight;
+		}
+
+		transitionMips(commandBuffer, texture.image, texture.mipLevels - 1, 1,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, SHADER_STAGES);
+	}
+
+	void IkTextureManager::finishUpload(Upload& upload, bool makeReady) {
+		destroyStaging(upload.staged);
+		vkFreeCommandBuffers(ikeDevice.device(), commandPool, 1, &upload.commandBuffer);
+		vkDestroyFence(ikeDevice.device(), upload.fence, nullptr);
+		if (!makeReady) return;
+
+		IkTexture& texture = *upload.texture;
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = texture.image;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = texture.format;
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewInfo.subresourceRange.baseMipLevel = 0;
+		viewInfo.subresourceRange.levelCount = texture.mipLevels;
+		viewInfo.subresourceRange.baseArrayLayer = 0;
+		viewInfo.subresourceRange.layerCount = 1;
+		if (vkCreateImageView(ikeDevice.device(), &viewInfo, nullptr, &texture.imageView) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create texture image view!");
+		}
+
+		VkDescriptorImageInfo imageInfo{};
+		imageInfo.sampler = samplerCache.get(samplerDesc);
+		imageInfo.imageView = texture.imageView;
+		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		texture.bindlessIndex = bindlessTable.addTexture(imageInfo);
+	}
+
+	void IkTextureManager::destroyStaging(const StagedImage& staged) {
+		vkDestroyBuffer(ikeDevice.device(), staged.buffer, nullptr);
+		vkFreeMemory(ikeDevice.device(), staged.memory, nullptr);
+	}
+
+}//namespace ikE
@@ -0,0 +1,144 @@
+#ifndef IKTEXTUREMANAGER_HPP
+#define IKTEXTUREMANAGER_HPP
+
+#include "ikDeviceEngine.hpp"
+#include "ikBindlessTable.hpp"
+#include "ikDeletionQueue.hpp"
+#include "ikSamplerCache.hpp"
+#include "ikThreadPool.hpp"
+
+//std
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+namespace ikE {
+	/*IkTexture is a sampled image with a full mip chain, created by IkTextureManager::load.
+	  it is not ready until the manager finished its upload, until then getBindlessIndex() is
+	  IkBindlessTable::INVALID_INDEX and shaders fall back to the untextured material.
+	  the last owner going away retires the image through the deletion queue and releases its bindless index*/
+	class IkTexture {
+	public:
+		~IkTexture();
+
+		IkTexture(const IkTexture&) = delete;
+		IkTexture& operator =(const IkTexture&) = delete;
+
+		const std::string& getFilepath() const { return filepath; }
+		bool isReady() const { return bindlessIndex != IkBindlessTable::INVALID_INDEX; }
+		uint32_t getBindlessIndex() const { return bindlessIndex; }
+		VkImageView getImageView() const { return imageView; }
+		uint32_t getWidth() const { return width; }
+		uint32_t getHeight() const { return height; }
+		uint32_t getMipLevels() const { return mipLevels; }
+		VkFormat getFormat() const { return format; }
+
+	private:
+		friend class IkTextureManager;
+		IkTexture(IkeDeviceEngine& device, IkDeletionQueue& deletionQueue, IkBindlessTable& bindlessTable, std::string filepath);
+
+		IkeDeviceEngine& ikeDevice;
+		IkDeletionQueue& deletionQueue;
+		IkBindlessTable& bindlessTable;
+		std::string filepath;
+
+		VkImage image = VK_NULL_HANDLE;
+		VkDeviceMemory imageMemory = VK_NULL_HANDLE;
+		VkImageView imageView = VK_NULL_HANDLE;
+		VkFormat format = VK_FORMAT_UNDEFINED;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		uint32_t mipLevels = 1;
+		uint32_t bindlessIndex = IkBindlessTable::INVALID_INDEX;
+	};
+
+	/*IkTextureManager loads textures without stalling the frame. load() returns at once, the file is decoded and copied
+	  into a staging buffer on the manager's own worker threads (not the recording pool, whose wait() would then block
+	  on decodes). update(), called once per frame on the main thread, records the copy of every finished decode into
+	  mip 0 followed by a vkCmdBlitImage chain that halves it down to 1x1, and submits it on the graphics queue with a
+	  fence of its own. a later update() that finds the fence signaled adds the texture to the bindless table.
+	  a .iktx container (see ikTextureContainer.hpp) is mapped instead of decoded, its mips are copied as they are into
+	  the staging buffer and from there into every level. the first of its chains the device can sample is used, when
+	  it can sample none the first chain is transcoded to RGBA8 on the worker.
+	  textures are refcounted by path, loading a path that is still alive returns the same texture.
+	  a texture whose decode threw is logged by update() and never becomes ready, so its materials stay untextured, and
+	  its path is released so a later load() tries again. with setDecodeErrorsFatal(true) update() rethrows instead.
+	  main thread only*/
+	class IkTextureManager {
+	public:
+		static constexpr uint32_t DECODE_THREADS = 2;
+		//uploads started by one update(), so a burst of finished decodes is spread over a few frames
+		static constexpr uint32_t MAX_UPLOADS_PER_UPDATE = 4;
+
+		IkTextureManager(
+			IkeDeviceEngine& device,
+			IkDeletionQueue& deletionQueue,
+			IkBindlessTable& bindlessTable,
+			IkSamplerCache& samplerCache,
+			const SamplerDesc& samplerDesc = SamplerDesc{});
+		//waits for the decodes and uploads still running
+		~IkTextureManager();
+
+		IkTextureManager(const IkTextureManager&) = delete;
+		IkTextureManager& operator =(const IkTextureManager&) = delete;
+
+		std::shared_ptr<IkTexture> load(const std::string& filepath);
+		void update();
+		//blocks until every texture loaded so far is ready, e.g. before a headless capture
+		void waitAll();
+		//for headless runs and benchmarks, where a missing texture makes the result meaningless
+		void setDecodeErrorsFatal(bool fatal) { decodeErrorsFatal = fatal; }
+
+		size_t getPendingCount() const { return decodes.size() + uploads.size(); }
+
+	private:
+		//a decoded image already copied into host visible memory by the worker, one region per mip it holds
+		struct StagedImage {
+			uint32_t width = 0;
+			uint32_t height = 0;
+			VkFormat format = VK_FORMAT_UNDEFINED;
+			VkBuffer buffer = VK_NULL_HANDLE;
+			VkDeviceMemory memory = VK_NULL_HANDLE;
+			std::vector<VkBufferImageCopy> regions;
+		};
+		struct Decode {
+			std::shared_ptr<IkTexture> texture;
+			std::future<StagedImage> staged;
+		};
+		struct Upload {
+			std::shared_ptr<IkTexture> texture;
+			StagedImage staged;
+			VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+			VkFence fence = VK_NULL_HANDLE;
+		};
+
+		//run on the decode workers
+		static StagedImage stageImage(IkeDeviceEngine& device, const std::string& filepath);
+		static StagedImage stageContainer(IkeDeviceEngine& device, const std::string& filepath);
+		static void* createStaging(IkeDeviceEngine& device, VkDeviceSize size, StagedImage& staged);
+
+		void startUpload(const std::shared_ptr<IkTexture>& texture, const StagedImage& staged);
+		void recordMipChain(VkCommandBuffer commandBuffer, const IkTexture& texture);
+		void finishUpload(Upload& upload, bool makeReady);
+		void destroyStaging(const StagedImage& staged);
+
+		IkeDeviceEngine& ikeDevice;
+		IkDeletionQueue& deletionQueue;
+		IkBindlessTable& bindlessTable;
+		IkSamplerCache& samplerCache;
+		SamplerDesc samplerDesc;
+		//without linear filtered blits of RGBA8 images without mips of their own get a single level
+		bool generateMips = false;
+		bool decodeErrorsFatal = false;
+
+		VkCommandPool commandPool = VK_NULL_HANDLE;
+		std::unordered_map<std::string, std::weak_ptr<IkTexture>> textures;
+		std::vector<Decode> decodes;
+		std::vector<Upload> uploads;
+		IkThreadPool decodePool{ DECODE_THREADS };
+	};
+
+} //namepace
+#endif //header guard
@@ -0,0 +1,103 @@
+#include "ikThreadPool.hpp"
+#include "ikCpuProfiler.hpp"
+
+//std
+#include <algorithm>
+#include <cassert>
+
+namespace ikE {
+
+	IkThreadPool::IkThreadPool(uint32_t threadCount) {
+		assert(threadCount > 0 && "Thread pool needs at least one worker");
+		workers.reserve(threadCount);
+		for (uint32_t i = 0; i < threadCount; i++) {
+			workers.emplace_back(&IkThreadPool::workerLoop, this);
+		}
+	}
+
+	IkThreadPool::~IkThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock{ queueMutex };
+			stopping = true;
+		}
+		taskAvailable.notify_all();
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+
+	uint32_t IkThreadPool::defaultThreadCount() {
+		//hardware_concurrency may return 0 when it cannot be determined
+		return std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	void IkThreadPool::submit(std::function<void()> task) {
+		{
+			std::lock_guard<std::mutex> lock{ queueMutex };
+			tasks.push(std::move(task));
+			pendingTasks += 1;
+		}
+		taskAvailable.notify_one();
+	}
+
+	void IkThreadPool::wait() {
+		std::unique_lock<std::mutex> lock{ queueMutex };
+		allTasksDone.wait(lock, [this] { return pendingTasks == 0; });
+
+		if (firstError) {
+			auto error = firstError;
+			firstError = nullptr;
+			std::rethrow_exception(error);
+		}
+	}
+
+	uint32_t IkThreadPool::parallelFor(
+		uint32_t count,
+		uint32_t minPerChunk,
+		const std::function<void(uint32_t chunkIndex, uint32_t first, uint32_t last)>& fn) {
+		if (count == 0) return 0;
+
+		uint32_t chunkCount = std::min(size(), (count + minPerChunk - 1) / std::max(1u, minPerChunk));
+		chunkCount = std::max(1u, chunkCount);
+		uint32_t perChunk = (count + chunkCount - 1) / chunkCount;
+
+		for (uint32_t chunk = 0; chunk < chunkCount; chunk++) {
+			uint32_t first = chunk * perChunk;
+			uint32_t last = std::min(count, first + perChunk);
+			submit([&fn, chunk, first, last] { fn(chunk, first, last); });
+		}
+		wait();
+		return chunkCount;
+	}
+
+	void IkThreadPool::workerLoop() {
+		IK_PROFILE_THREAD("worker");
+		while (true) {
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock{ queueMutex };
+				taskAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+				if (stopping && tasks.empty()) return;
+
+				task = std::move(tasks.front());
+				tasks.pop();
+			}
+
+			try {
+				IK_PROFILE_ZONE("IkThreadPool task");
+				task();
+			}
+			catch (...) {
+				std::lock_guard<std::mutex> lock{ queueMutex };
+				if (!firstError) firstError = std::current_exception();
+			}
+
+			{
+				std::lock_guard<std::mutex> lock{ queueMutex };
+				pendingTasks -= 1;
+				if (pendingTasks == 0) allTasksDone.notify_all();
+			}
+		}
+	}
+
+}//namespace
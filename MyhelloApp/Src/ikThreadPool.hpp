@@ -0,0 +1,56 @@
+#ifndef IKTHREADPOOL_HPP
+#define IKTHREADPOOL_HPP
+
+//std
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace ikE {
+	/*IkThreadPool owns a fixed set of worker threads that pull tasks from a shared queue.
+	  it is used by the render systems to record secondary command buffers in parallel,
+	  submit() pushes work and wait() blocks the calling thread until every submitted task has finished.
+	  an exception thrown inside a task is kept and rethrown from wait() on the calling thread*/
+	class IkThreadPool {
+	public:
+		explicit IkThreadPool(uint32_t threadCount = defaultThreadCount());
+		~IkThreadPool();
+
+		IkThreadPool(const IkThreadPool&) = delete;
+		IkThreadPool& operator =(const IkThreadPool&) = delete;
+
+		uint32_t size() const { return static_cast<uint32_t>(workers.size()); }
+
+		void submit(std::function<void()> task);
+		void wait();
+
+		//splits [0, count) into at most size() contiguous ranges and runs fn(chunkIndex, first, last) on the workers
+		//chunkIndex is dense and smaller than the returned chunk count, so callers can use it to pick per-chunk resources
+		uint32_t parallelFor(
+			uint32_t count,
+			uint32_t minPerChunk,
+			const std::function<void(uint32_t chunkIndex, uint32_t first, uint32_t last)>& fn);
+
+		static uint32_t defaultThreadCount();
+
+	private:
+		void workerLoop();
+
+		std::vector<std::thread> workers;
+		std::queue<std::function<void()>> tasks;
+
+		std::mutex queueMutex;
+		std::condition_variable taskAvailable;
+		std::condition_variable allTasksDone;
+		uint32_t pendingTasks{ 0 };
+		bool stopping{ false };
+		std::exception_ptr firstError{};
+	};
+
+}//namespace
+#endif //header guard
@@ -1,13 +1,18 @@
 #include "ikWindow.hpp"
 
+#include <cassert>
 #include <stdexcept>
 namespace ikE {
-	IkeWindow::IkeWindow(int w, int h, std::string name) : width(w), height(h), windowName{ name } {
-		initWindow();
+	IkeWindow::IkeWindow(int w, int h, std::string name, bool headless) : width(w), height(h), headless{ headless }, windowName{ name } {
+		if (!headless) {
+			initWindow();
+		}
 	}
 	IkeWindow::~IkeWindow() {
-		glfwDestroyWindow(window);
-		glfwTerminate();
+		if (window != nullptr) {
+			glfwDestroyWindow(window);
+			glfwTerminate();
+		}
 	}
 	void IkeWindow::initWindow(){
 		glfwInit(); 
@@ -20,6 +25,7 @@ namespace ikE {
 	}
 	//Note explaination
 	void IkeWindow::createWindowSurface(VkInstance instance, VkSurfaceKHR* surface) {
+		assert(!headless && "A headless window has no surface");
 		if (glfwCreateWindowSurface(instance, window, nullptr, surface) != VK_SUCCESS) {
 			throw std::runtime_error("failed to create window surface");
 		}
@@ -8,13 +8,15 @@
 namespace ikE {
 	class IkeWindow {
 	public:
-		IkeWindow(int w, int h, std::string name);
+		//a headless window never initializes glfw, it only carries the extent the offscreen images are created with
+		IkeWindow(int w, int h, std::string name, bool headless = false);
 		~IkeWindow();
 
 		IkeWindow(const IkeWindow&) = delete;
 		IkeWindow& operator = (const IkeWindow) = delete;
 
-		bool shouldClose() { return glfwWindowShouldClose(window); }
+		bool shouldClose() { return !headless && glfwWindowShouldClose(window); }
+		bool isHeadless() const { return headless; }
 		//Note explanation
 		VkExtent2D getExtent() { return { static_cast<uint32_t>(width),static_cast<uint32_t>(height) }; }
 		//Note explanation
@@ -33,9 +35,10 @@ namespace ikE {
 		 int width;
 		 int height;
 		 bool framebufferResized = false;
+		 bool headless = false;
 
 		std::string windowName;
-		GLFWwindow* window;
+		GLFWwindow* window = nullptr;
 	};
 
 
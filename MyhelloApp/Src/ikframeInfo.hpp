@@ -3,7 +3,9 @@
 #define IKFRAMEINFO_HPP
 
 #include "ikCamera.hpp"
-#include "ikgameObject.hpp"
+#include "ikEntityRegistry.hpp"
+#include "ikRenderer.hpp"
+#include "ikThreadPool.hpp"
 
 //lib
 #include <vulkan/vulkan.h>
@@ -11,30 +13,46 @@
 
 namespace ikE {
 
-#define MAX_LIGHTS 10
-
+	//same layout as PointLight in the shaders, stored in the light storage buffer
 	struct PointLight {
-		glm::vec4 position{}; //ignore w
+		glm::vec4 position{}; // w is the billboard radius
 		glm::vec4 color{}; // w is intensity
 	};
 
+	//same layout as Material in the shaders, stored in the material buffer of the bindless table
+	struct Material {
+		glm::vec4 baseColor{ 1.f }; // multiplies the vertex color
+		glm::uvec4 textures{ IkBindlessTable::INVALID_INDEX, 0, 0, 0 }; // x base color texture in the bindless table
+	};
+
 	struct GlobalUbo {
 		glm::mat4 projection{ 1.f };
 		glm::mat4 view{ 1.f };
 		glm::vec4 ambientLightColor{ 1.f, 1.f, 1.f, .02f };
-		PointLight pointLights[MAX_LIGHTS];
-		int numLights;
+		//lights are read from storage buffers, these describe how the fragment shader finds its light cluster
+		glm::vec4 clusterDepth{}; // x near, y far, z slice scale, w slice bias
+		glm::uvec4 clusterGrid{}; // xyz clusters per axis, w unused
+		glm::vec2 screenSize{};
+		//indices into the bindless table, x is the material buffer. std140 starts a uvec4 on 16 bytes
+		alignas(16) glm::uvec4 resourceIndices{ IkBindlessTable::INVALID_INDEX };
 	};
 
 
 
+	//LIGHT_LOOP_LIMIT (constant_id 0) of shader.frag and deferred.frag for a variant that shades every binned light
+	static constexpr uint32_t LIGHT_LOOP_UNBOUNDED = 0xffffffff;
+
 	struct FrameInfo {
 		int frameIndex;
 		float frameTime;
 		VkCommandBuffer commandBuffer;
 		IkCamera& camera;
 		VkDescriptorSet globalDescriptorSet;
-		IkgameObject::Map& gameObjects;
+		IkEntityRegistry& entities;
+		IkeRenderer& renderer;
+		IkThreadPool& threadPool; //workers used to record the systems' secondary command buffers
+		//smallest lighting variant that still covers the fullest light cluster, set after IkLightClusterSystem::update
+		uint32_t lightLoopLimit{ LIGHT_LOOP_UNBOUNDED };
 	};
 
 
@@ -3,7 +3,7 @@
 namespace ikE {
 	//Matrix corresponds to translate * Ry * Rx * Rz * scale tranformatio
 	//Rotation convention uses tait-bryan angles with axis order Y(1), x(2), Z(3)
-	glm::mat4 TransformComponent::mat4() {
+	glm::mat4 TransformComponent::mat4() const {
 		const float c3 = glm::cos(rotation.z);
 		const float s3 = glm::sin(rotation.z);
 		const float c2 = glm::cos(rotation.x);
@@ -33,7 +33,7 @@ namespace ikE {
 	}
 
 
-	glm::mat3 TransformComponent::normalMatrix() {
+	glm::mat3 TransformComponent::normalMatrix() const {
 		const float c3 = glm::cos(rotation.z);
 		const float s3 = glm::sin(rotation.z);
 		const float c2 = glm::cos(rotation.x);
@@ -64,14 +64,4 @@ namespace ikE {
 
 	}
 
-	IkgameObject IkgameObject::makePointLight(float intensity ,float radius ,glm::vec3 color ) {
-		IkgameObject gameObj = IkgameObject::createGameObject();
-		gameObj.color = color;
-		gameObj.transform.scale.x = radius;
-		gameObj.pointLight = std::make_unique<PointLightComponent>();
-		gameObj.pointLight->lightIntensity = intensity;
-		return gameObj;
-
-	}
-
 }//namespace
\ No newline at end of file
@@ -6,8 +6,8 @@
 //libs
 #include "glm/gtc/matrix_transform.hpp"
 //std
+#include <cstdint>
 #include <memory>
-#include <unordered_map>
 
 namespace ikE{
 	//this is used to move objects up and down
@@ -18,49 +18,28 @@ namespace ikE{
 
 	//Matrix corresponds to translate * Ry * Rx * Rz * scale tranformatio
 	//Rotation convention uses tait-bryan angles with axis order Y(1), x(2), Z(3)
-		glm::mat4 mat4();
-		glm::mat3 normalMatrix();
+		glm::mat4 mat4() const;
+		glm::mat3 normalMatrix() const;
 		
 		};
 	struct PointLightComponent {
 		float lightIntensity = 1.0f;
 	};
 
-	class IkgameObject {
-	public:
-		using id_t = unsigned int;
-		using Map = std::unordered_map<id_t, IkgameObject>;
-
-		static IkgameObject createGameObject() {
-			static id_t currentId = 0;
-			return IkgameObject(currentId++);
-
-		}
-
-		static IkgameObject makePointLight(
-			float intensity = 10.f, 
-			float radius = 0.1f, 
-			glm::vec3 color = glm::vec3(1.f)
-		);
-
-		IkgameObject(const IkgameObject&) = delete;
-		IkgameObject& operator=(const IkgameObject&) = delete;
-		IkgameObject(IkgameObject&&) = default;
-		IkgameObject& operator=(IkgameObject&&) = default;
-
-
-		//getId should be marked as const
-		id_t getId() { return id; }
-		
+	//the light color of a point light
+	struct ColorComponent {
 		glm::vec3 color{};
-		TransformComponent transform{};
+	};
 
-		//Optional Pointer components
+	struct ModelComponent {
 		std::shared_ptr<ikEngineModel> model{};
-		std::unique_ptr< PointLightComponent> pointLight = nullptr;
-	private:
-		IkgameObject(id_t objId) : id(objId){}
-		id_t id;
+
+		//index into the materials of the app, the shaders read it from the bindless table's material buffer
+		uint32_t materialId = 0;
+
+		//static objects are recorded once and replayed every frame, their transform and material must not change after they are added
+		//(swapping the model or adding/removing a static object through IkEntityRegistry is picked up automatically)
+		bool isStatic = false;
 	};
 
 
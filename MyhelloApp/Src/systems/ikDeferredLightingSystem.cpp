@@ -0,0 +1,119 @@
+#include "ikDeferredLightingSystem.hpp"
+
+//std
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <stdexcept>
+namespace ikE {
+
+	IkDeferredLightingSystem::IkDeferredLightingSystem(
+		IkeDeviceEngine& device,
+		IkPipelineCompiler& pipelineCompiler,
+		IkeRenderer& renderer,
+		VkDescriptorSetLayout globalSetLayout,
+		IkRenderGraph::PassId lightingPass,
+		GBufferResources gBuffer)
+		: ikeDeviceEngine{ device }, ikeRenderer{ renderer }, gBuffer{ gBuffer } {
+		IkRenderGraph& renderGraph = ikeRenderer.getRenderGraph();
+		assert(renderGraph.isCompiled() && !renderGraph.isCulled(lightingPass) && "Deferred lighting needs a compiled lighting pass");
+
+		gBufferSetLayout = IkDescriptorSetLayout::Builder(ikeDeviceEngine)
+			.addBinding(0, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, VK_SHADER_STAGE_FRAGMENT_BIT)
+			.addBinding(1, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, VK_SHADER_STAGE_FRAGMENT_BIT)
+			.addBinding(2, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, VK_SHADER_STAGE_FRAGMENT_BIT)
+			.build();
+
+		createPipelinelayout(globalSetLayout);
+		createPipeline(pipelineCompiler, renderGraph.getRenderPass(lightingPass), renderGraph.getSubpass(lightingPass));
+	}
+
+	IkDeferredLightingSystem::~IkDeferredLightingSystem() {
+		for (auto& pipeline : lightingPipelines) {
+			pipeline.wait();
+		}
+		vkDestroyPipelineLayout(ikeDeviceEngine.device(), pipelineLayout, nullptr);
+	}
+
+	void IkDeferredLightingSystem::createPipelinelayout(VkDescriptorSetLayout globalSetLayout) {
+		std::vector<VkDescriptorSetLayout> descriptorSetLayouts{ globalSetLayout, gBufferSetLayout->getDescriptorSetLayout() };
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
+		pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
+		pipelineLayoutInfo.pushConstantRangeCount = 0;
+		pipelineLayoutInfo.pPushConstantRanges = nullptr;
+
+		if (vkCreatePipelineLayout(ikeDeviceEngine.device(), &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create pipeline layout!");
+		}
+	}
+
+	void IkDeferredLightingSystem::createPipeline(IkPipelineCompiler& pipelineCompiler, VkRenderPass renderPass, uint32_t subpass) {
+		assert(pipelineLayout != nullptr && "Cannot create pipeline before pipeline layout");
+
+		for (size_t i = 0; i < lightingPipelines.size(); i++) {
+			auto pipelineConfig = std::make_unique<PipelineConfigInfo>();
+			ikePipeline::defaultPipelineConfigInfo(*pipelineConfig);
+			//the full screen triangle is generated from gl_VertexIndex
+			pipelineConfig->attributeDescriptions.clear();
+			pipelineConfig->bindingDescriptions.clear();
+			pipelineConfig->rasterizationInfo.cullMode = VK_CULL_MODE_NONE;
+			pipelineConfig->depthStencilInfo.depthTestEnable = VK_FALSE;
+			pipelineConfig->depthStencilInfo.depthWriteEnable = VK_FALSE;
+			pipelineConfig->renderPass = renderPass;
+			pipelineConfig->pipelineLayout = pipelineLayout;
+			pipelineConfig->subpass = subpass;
+			pipelineConfig->specialization.set(0, IkLightClusterSystem::LIGHT_LOOP_LIMITS[i]);
+
+			lightingPipelines[i] = pipelineCompiler.compile("Shaders/deferred_vert.spv", "Shaders/deferred_frag.spv", std::move(pipelineConfig));
+		}
+	}
+
+	VkDescriptorSet IkDeferredLightingSystem::writeGBufferDescriptorSet(int frameIndex) {
+		IkRenderGraph& renderGraph = ikeRenderer.getRenderGraph();
+		std::array<VkDescriptorImageInfo, 3> imageInfos{};
+		imageInfos[0] = { VK_NULL_HANDLE, renderGraph.getImageView(gBuffer.albedo, frameIndex), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+		imageInfos[1] = { VK_NULL_HANDLE, renderGraph.getImageView(gBuffer.normal, frameIndex), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+		imageInfos[2] = { VK_NULL_HANDLE, renderGraph.getImageView(gBuffer.depth, frameIndex), VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL };
+
+		//the frame pools are reset once this frame index comes around again, the set is never freed on its own
+		VkDescriptorSet set;
+		IkDescriptorWriter(*gBufferSetLayout, ikeRenderer.getDescriptorPoolManager())
+			.writeImage(0, &imageInfos[0])
+			.writeImage(1, &imageInfos[1])
+			.writeImage(2, &imageInfos[2])
+			.buildForFrame(set);
+		return set;
+	}
+
+	void IkDeferredLightingSystem::render(FrameInfo& frameInfo) {
+		uint32_t gpuScope = frameInfo.renderer.beginGpuScope("IkDeferredLightingSystem::render");
+		VkCommandBuffer commandBuffer = frameInfo.renderer.beginSecondaryCommandBuffer(0);
+
+		const auto& limits = IkLightClusterSystem::LIGHT_LOOP_LIMITS;
+		size_t variant = std::find(limits.begin(), limits.end(), frameInfo.lightLoopLimit) - limits.begin();
+		assert(variant < lightingPipelines.size() && "Light loop limit has no pipeline variant");
+		lightingPipelines[variant]->bind(commandBuffer);
+
+		std::array<VkDescriptorSet, 2> descriptorSets{
+			frameInfo.globalDescriptorSet,
+			writeGBufferDescriptorSet(frameInfo.frameIndex) };
+		vkCmdBindDescriptorSets(commandBuffer,
+			VK_PIPELINE_BIND_POINT_GRAPHICS,
+			pipelineLayout,
+			0,
+			static_cast<uint32_t>(descriptorSets.size()),
+			descriptorSets.data(),
+			0,
+			nullptr);
+
+		vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+
+		frameInfo.renderer.endSecondaryCommandBuffer(commandBuffer);
+		frameInfo.renderer.executeSecondaryCommandBuffers({ commandBuffer });
+		frameInfo.renderer.endGpuScope(gpuScope);
+	}
+
+}//namespace ikE
@@ -0,0 +1,64 @@
+#ifndef IKDEFERREDLIGHTINGSYSTEM_HPP
+#define IKDEFERREDLIGHTINGSYSTEM_HPP
+
+#include "../ikDescriptors.hpp"
+#include "../ikDeviceEngine.hpp"
+#include "../ikPipeline.hpp"
+#include "../ikPipelineCompiler.hpp"
+#include "../ikRenderer.hpp"
+#include "../ikframeInfo.hpp"
+#include "ikLightClusterSystem.hpp"
+
+//std
+#include <array>
+#include <memory>
+#include <vector>
+namespace ikE {
+	//the G-buffer images of the render graph, written by the geometry pass and read by the lighting pass
+	struct GBufferResources {
+		IkRenderGraph::ResourceId albedo;
+		IkRenderGraph::ResourceId normal;
+		IkRenderGraph::ResourceId depth;
+	};
+
+	/*IkDeferredLightingSystem draws one full screen triangle in the lighting pass of the render graph.
+	  the fragment shader reads albedo, normal and depth of its own pixel as input attachments and shades the lights of
+	  the pixel's light cluster, so every pixel is lit exactly once no matter how much geometry overlaps it.
+	  the input attachment set points at images of the render graph. it is allocated from the frame pools of the
+	  renderer's IkDescriptorPoolManager every frame, so it always matches the current images, also after a resize*/
+	class IkDeferredLightingSystem {
+	public:
+		//lightingPass must read the three G-buffer images with readInput, in the order albedo, normal, depth
+		IkDeferredLightingSystem(
+			IkeDeviceEngine& device,
+			IkPipelineCompiler& pipelineCompiler,
+			IkeRenderer& renderer,
+			VkDescriptorSetLayout globalSetLayout,
+			IkRenderGraph::PassId lightingPass,
+			GBufferResources gBuffer);
+		~IkDeferredLightingSystem();
+
+		IkDeferredLightingSystem(const IkDeferredLightingSystem&) = delete;
+		IkDeferredLightingSystem& operator =(const IkDeferredLightingSystem&) = delete;
+
+		//must be called while the render graph executes lightingPass
+		void render(FrameInfo& frameInfo);
+
+	private:
+		void createPipelinelayout(VkDescriptorSetLayout globalSetLayout);
+		void createPipeline(IkPipelineCompiler& pipelineCompiler, VkRenderPass renderPass, uint32_t subpass);
+		VkDescriptorSet writeGBufferDescriptorSet(int frameIndex);
+
+		IkeDeviceEngine& ikeDeviceEngine;
+		IkeRenderer& ikeRenderer;
+		GBufferResources gBuffer;
+
+		std::unique_ptr<IkDescriptorSetLayout> gBufferSetLayout;
+
+		//one pipeline per IkLightClusterSystem::LIGHT_LOOP_LIMITS entry, in the same order
+		std::array<IkPipelineHandle, IkLightClusterSystem::LIGHT_LOOP_LIMITS.size()> lightingPipelines;
+		VkPipelineLayout pipelineLayout;
+	};
+
+} //namepace
+#endif //header guard
@@ -0,0 +1,179 @@
+#include "ikLightClusterSystem.hpp"
+//libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+
+
+//std
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+namespace ikE {
+
+	//each worker bins all lights into its own range of depth slices, so no two workers touch the same cluster list
+	static constexpr uint32_t MIN_SLICES_PER_THREAD = 2;
+	static constexpr uint32_t MIN_LIGHTS_PER_THREAD = 256;
+
+	IkLightClusterSystem::IkLightClusterSystem(IkeDeviceEngine& device) : ikeDeviceEngine{ device } {
+		clusterBuffers.resize(ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT);
+		lightIndexBuffers.resize(ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT);
+		for (int i = 0; i < ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+			clusterBuffers[i] = std::make_unique<IkBuffer>(
+				ikeDeviceEngine,
+				sizeof(LightCluster),
+				CLUSTER_COUNT,
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+			clusterBuffers[i]->map();
+
+			//the per cluster cap bounds the index list, so it is allocated once at its largest size
+			lightIndexBuffers[i] = std::make_unique<IkBuffer>(
+				ikeDeviceEngine,
+				sizeof(uint32_t),
+				CLUSTER_COUNT * MAX_LIGHTS_PER_CLUSTER,
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+			lightIndexBuffers[i]->map();
+		}
+		clusterLights.resize(CLUSTER_COUNT);
+	}
+
+	IkLightClusterSystem::~IkLightClusterSystem() {}
+
+	uint32_t IkLightClusterSystem::depthSlice(float viewDepth) const {
+		//slices grow exponentially with distance, the same formula as shader.frag
+		float slice = std::floor(std::log(viewDepth) * sliceScale + sliceBias);
+		return static_cast<uint32_t>(std::clamp(slice, 0.f, static_cast<float>(CLUSTER_Z - 1)));
+	}
+
+	IkLightClusterSystem::LightBounds IkLightClusterSystem::computeBounds(
+		const PointLight& light, const glm::mat4& view, const glm::mat4& projection, float near, float far) const {
+		LightBounds bounds{};
+		bounds.visible = false;
+
+		float range = std::sqrt(light.color.w / LIGHT_CUTOFF);
+		glm::vec3 center = glm::vec3(view * glm::vec4(glm::vec3(light.position), 1.f));
+
+		//the camera looks down +z in view space
+		if (center.z + range < near || center.z - range > far) return bounds;
+		bounds.minZ = depthSlice(std::max(center.z - range, near));
+		bounds.maxZ = depthSlice(std::min(center.z + range, far));
+
+		bounds.minX = 0;
+		bounds.maxX = CLUSTER_X - 1;
+		bounds.minY = 0;
+		bounds.maxY = CLUSTER_Y - 1;
+
+		//a sphere reaching behind the near plane can cover any part of the screen
+		if (center.z - range > near) {
+			//every corner of the view space box around the sphere is in front of the camera,
+			//so the rectangle around their projections contains the projected sphere
+			float minNdcX = 1.f, maxNdcX = -1.f;
+			float minNdcY = 1.f, maxNdcY = -1.f;
+			for (int corner = 0; corner < 8; corner++) {
+				glm::vec4 viewCorner{
+					center.x + ((corner & 1) ? range : -range),
+					center.y + ((corner & 2) ? range : -range),
+					center.z + ((corner & 4) ? range : -range),
+					1.f };
+				glm::vec4 clip = projection * viewCorner;
+				float ndcX = clip.x / clip.w;
+				float ndcY = clip.y / clip.w;
+				minNdcX = std::min(minNdcX, ndcX);
+				maxNdcX = std::max(maxNdcX, ndcX);
+				minNdcY = std::min(minNdcY, ndcY);
+				maxNdcY = std::max(maxNdcY, ndcY);
+			}
+			if (maxNdcX < -1.f || minNdcX > 1.f || maxNdcY < -1.f || minNdcY > 1.f) return bounds;
+
+			auto toTile = [](float ndc, uint32_t tileCount) {
+				float tile = std::floor((ndc * .5f + .5f) * tileCount);
+				return static_cast<uint32_t>(std::clamp(tile, 0.f, static_cast<float>(tileCount - 1)));
+			};
+			bounds.minX = toTile(minNdcX, CLUSTER_X);
+			bounds.maxX = toTile(maxNdcX, CLUSTER_X);
+			bounds.minY = toTile(minNdcY, CLUSTER_Y);
+			bounds.maxY = toTile(maxNdcY, CLUSTER_Y);
+		}
+
+		bounds.visible = true;
+		return bounds;
+	}
+
+	void IkLightClusterSystem::update(FrameInfo& frameInfo, GlobalUbo& ubo, const std::vector<PointLight>& lights, VkExtent2D extent) {
+		float near = frameInfo.camera.getNear();
+		float far = frameInfo.camera.getFar();
+		assert(near > 0.f && far > near && "Light clusters need a perspective projection");
+
+		float logDepthRange = std::log(far / near);
+		sliceScale = CLUSTER_Z / logDepthRange;
+		sliceBias = -(CLUSTER_Z * std::log(near)) / logDepthRange;
+
+		ubo.clusterDepth = glm::vec4(near, far, sliceScale, sliceBias);
+		ubo.clusterGrid = glm::uvec4{ CLUSTER_X, CLUSTER_Y, CLUSTER_Z, 0 };
+		ubo.screenSize = glm::vec2(static_cast<float>(extent.width), static_cast<float>(extent.height));
+
+		const glm::mat4& view = frameInfo.camera.getView();
+		const glm::mat4& projection = frameInfo.camera.getProjection();
+		uint32_t lightCount = static_cast<uint32_t>(lights.size());
+
+		lightBounds.resize(lightCount);
+		frameInfo.threadPool.parallelFor(lightCount, MIN_LIGHTS_PER_THREAD,
+			[&](uint32_t, uint32_t first, uint32_t last) {
+				for (uint32_t i = first; i < last; i++) {
+					lightBounds[i] = computeBounds(lights[i], view, projection, near, far);
+				}
+			});
+
+		frameInfo.threadPool.parallelFor(CLUSTER_Z, MIN_SLICES_PER_THREAD,
+			[&](uint32_t, uint32_t firstSlice, uint32_t lastSlice) {
+				for (uint32_t z = firstSlice; z < lastSlice; z++) {
+					for (uint32_t cluster = z * CLUSTER_X * CLUSTER_Y; cluster < (z + 1) * CLUSTER_X * CLUSTER_Y; cluster++) {
+						clusterLights[cluster].clear();
+					}
+				}
+
+				for (uint32_t lightIndex = 0; lightIndex < lightCount; lightIndex++) {
+					const LightBounds& bounds = lightBounds[lightIndex];
+					if (!bounds.visible || bounds.maxZ < firstSlice || bounds.minZ >= lastSlice) continue;
+
+					uint32_t minZ = std::max(bounds.minZ, firstSlice);
+					uint32_t maxZ = std::min(bounds.maxZ, lastSlice - 1);
+					for (uint32_t z = minZ; z <= maxZ; z++) {
+						for (uint32_t y = bounds.minY; y <= bounds.maxY; y++) {
+							for (uint32_t x = bounds.minX; x <= bounds.maxX; x++) {
+								auto& list = clusterLights[x + CLUSTER_X * (y + CLUSTER_Y * z)];
+								if (list.size() < MAX_LIGHTS_PER_CLUSTER) list.push_back(lightIndex);
+							}
+						}
+					}
+				}
+			});
+
+		//compact the lists into the mapped buffers of this frame, its previous use has finished on the GPU
+		auto* clusters = static_cast<LightCluster*>(clusterBuffers[frameInfo.frameIndex]->getMappedMemory());
+		auto* indices = static_cast<uint32_t*>(lightIndexBuffers[frameInfo.frameIndex]->getMappedMemory());
+		uint32_t offset = 0;
+		uint32_t fullestCluster = 0;
+		for (uint32_t cluster = 0; cluster < CLUSTER_COUNT; cluster++) {
+			const auto& list = clusterLights[cluster];
+			fullestCluster = std::max(fullestCluster, static_cast<uint32_t>(list.size()));
+			clusters[cluster].offset = offset;
+			clusters[cluster].count = static_cast<uint32_t>(list.size());
+			if (!list.empty()) {
+				std::memcpy(indices + offset, list.data(), list.size() * sizeof(uint32_t));
+			}
+			offset += static_cast<uint32_t>(list.size());
+		}
+
+		clusterBuffers[frameInfo.frameIndex]->flush();
+		lightIndexBuffers[frameInfo.frameIndex]->flush();
+
+		lightLoopLimit = *std::find_if(LIGHT_LOOP_LIMITS.begin(), LIGHT_LOOP_LIMITS.end(),
+			[fullestCluster](uint32_t limit) { return limit >= fullestCluster; });
+	}
+
+}//namespace ikE
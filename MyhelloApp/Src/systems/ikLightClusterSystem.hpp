@@ -0,0 +1,81 @@
+#ifndef IKLIGHTCLUSTERSYSTEM_HPP
+#define IKLIGHTCLUSTERSYSTEM_HPP
+
+#include "../ikbuffer.hpp"
+#include "../ikDeviceEngine.hpp"
+#include "../ikframeInfo.hpp"
+
+//std
+#include <array>
+#include <memory>
+#include <vector>
+namespace ikE {
+	/*IkLightClusterSystem splits the view frustum into a CLUSTER_X * CLUSTER_Y * CLUSTER_Z grid, screen space tiles
+	  in x and y and logarithmic depth slices in z. every frame it bins the point lights into the clusters their range
+	  touches on the thread pool workers, and writes one (offset, count) pair per cluster plus a compact light index list.
+	  shader.frag finds the cluster of its fragment and only shades the lights listed there*/
+	class IkLightClusterSystem {
+	public:
+		static constexpr uint32_t CLUSTER_X = 16;
+		static constexpr uint32_t CLUSTER_Y = 9;
+		static constexpr uint32_t CLUSTER_Z = 24;
+		static constexpr uint32_t CLUSTER_COUNT = CLUSTER_X * CLUSTER_Y * CLUSTER_Z;
+
+		//caps the per fragment cost, a cluster touched by more lights drops the ones binned last
+		static constexpr uint32_t MAX_LIGHTS_PER_CLUSTER = 256;
+
+		//a light is ignored where intensity / distance^2 falls below this, shader.frag uses the same value
+		static constexpr float LIGHT_CUTOFF = 0.001f;
+
+		//LIGHT_LOOP_LIMIT values the lit pipelines are specialized for: no point lights, a short unrolled loop, any count
+		static constexpr std::array<uint32_t, 3> LIGHT_LOOP_LIMITS{ 0, 4, LIGHT_LOOP_UNBOUNDED };
+
+		IkLightClusterSystem(IkeDeviceEngine& device);
+		~IkLightClusterSystem();
+
+		IkLightClusterSystem(const IkLightClusterSystem&) = delete;
+		IkLightClusterSystem& operator =(const IkLightClusterSystem&) = delete;
+
+		//lights must be the same array, in the same order, as the light storage buffer of this frame
+		void update(FrameInfo& frameInfo, GlobalUbo& ubo, const std::vector<PointLight>& lights, VkExtent2D extent);
+
+		//bound at set 0 binding 2 and 3, the buffers are sized for the worst case so they never change
+		VkDescriptorBufferInfo getClusterBufferInfo(int frameIndex) { return clusterBuffers[frameIndex]->descriptorInfo(); }
+		VkDescriptorBufferInfo getLightIndexBufferInfo(int frameIndex) { return lightIndexBuffers[frameIndex]->descriptorInfo(); }
+		//first of LIGHT_LOOP_LIMITS that is at least the light count of the fullest cluster of the last update()
+		uint32_t getLightLoopLimit() const { return lightLoopLimit; }
+
+	private:
+		//same layout as LightCluster in shader.frag
+		struct LightCluster {
+			uint32_t offset;
+			uint32_t count;
+		};
+
+		//inclusive cluster range a light touches, empty when it is outside the frustum
+		struct LightBounds {
+			uint32_t minX, maxX;
+			uint32_t minY, maxY;
+			uint32_t minZ, maxZ;
+			bool visible;
+		};
+
+		LightBounds computeBounds(const PointLight& light, const glm::mat4& view, const glm::mat4& projection, float near, float far) const;
+		uint32_t depthSlice(float viewDepth) const;
+
+		IkeDeviceEngine& ikeDeviceEngine;
+
+		std::vector<std::unique_ptr<IkBuffer>> clusterBuffers;
+		std::vector<std::unique_ptr<IkBuffer>> lightIndexBuffers;
+
+		//scratch reused every frame so binning does not allocate once the lists have grown
+		std::vector<LightBounds> lightBounds;
+		std::vector<std::vector<uint32_t>> clusterLights;
+
+		float sliceScale{ 0.f };
+		float sliceBias{ 0.f };
+		uint32_t lightLoopLimit{ LIGHT_LOOP_UNBOUNDED };
+	};
+
+} //namepace
+#endif //header guard
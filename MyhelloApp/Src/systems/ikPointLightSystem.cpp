@@ -13,36 +13,42 @@
 #include <array>
 namespace ikE {
 
-	struct PointLightPushConstants {
-		glm::vec4 position{};
-		glm::vec4 color{};
-		float radius;
-	};
+	IkPointLightSystem::IkPointLightSystem(IkeDeviceEngine& device, IkPipelineCompiler& pipelineCompiler, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout, uint32_t subpass) : ikeDeviceEngine(device){
+		 createPipelinelayout(globalSetLayout),
+		 createPipeline(pipelineCompiler, renderPass, subpass);
 
-	
+		 lightBuffers.resize(ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT);
+		 lightCounts.resize(ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT, 0);
+		 for (int i = 0; i < ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+			 createLightBuffer(i, INITIAL_LIGHT_CAPACITY);
+		 }
+	}
 
-	IkPointLightSystem::IkPointLightSystem(IkeDeviceEngine& device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout) : ikeDeviceEngine(device){
-		 createPipelinelayout(globalSetLayout),
-		 createPipeline(renderPass);
+	IkPointLightSystem::~IkPointLightSystem() {
+		Pipeline.wait();
+		vkDestroyPipelineLayout(ikeDeviceEngine.device(), pipelineLayout, nullptr);
 	}
 
-	IkPointLightSystem::~IkPointLightSystem() { vkDestroyPipelineLayout(ikeDeviceEngine.device(), pipelineLayout, nullptr); }
+	void IkPointLightSystem::createLightBuffer(int frameIndex, uint32_t capacity) {
+		lightBuffers[frameIndex] = std::make_unique<IkBuffer>(
+			ikeDeviceEngine,
+			sizeof(PointLight),
+			capacity,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+		lightBuffers[frameIndex]->map();
+	}
 
 	void IkPointLightSystem::createPipelinelayout(VkDescriptorSetLayout globalSetLayout) {
-		
-		VkPushConstantRange pushConstantRange{};
-		pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-		pushConstantRange.offset = 0;
-		pushConstantRange.size = sizeof(PointLightPushConstants);
-
+		//everything the billboards need comes from the light storage buffer, so there are no push constants
 		std::vector<VkDescriptorSetLayout> descriptorSetLayouts{ globalSetLayout };
 
 		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
 		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
 		pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
 		pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
-		pipelineLayoutInfo.pushConstantRangeCount = 1;
-		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+		pipelineLayoutInfo.pushConstantRangeCount = 0;
+		pipelineLayoutInfo.pPushConstantRanges = nullptr;
 
 		if (vkCreatePipelineLayout(ikeDeviceEngine.device(), &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
 			throw std::runtime_error("failed to create pipeline layout!");
@@ -53,75 +59,87 @@ namespace ikE {
 	   we able to do this because in firstApp.hpp we have them as an include file
 
 	*/
-	void IkPointLightSystem::createPipeline(VkRenderPass renderPass) {
+	void IkPointLightSystem::createPipeline(IkPipelineCompiler& pipelineCompiler, VkRenderPass renderPass, uint32_t subpass) {
 
 		assert(pipelineLayout != nullptr && "Cannot create pipeline before pipeline layout");
 
 
-		PipelineConfigInfo pipelineConfig{};
-		ikePipeline::defaultPipelineConfigInfo(pipelineConfig);
-		pipelineConfig.attributeDescriptions.clear();
-		pipelineConfig.bindingDescriptions.clear();
-		pipelineConfig.renderPass = renderPass;
-		pipelineConfig.pipelineLayout = pipelineLayout;
+		auto pipelineConfig = std::make_unique<PipelineConfigInfo>();
+		ikePipeline::defaultPipelineConfigInfo(*pipelineConfig);
+		pipelineConfig->attributeDescriptions.clear();
+		pipelineConfig->bindingDescriptions.clear();
+		pipelineConfig->renderPass = renderPass;
+		pipelineConfig->pipelineLayout = pipelineLayout;
+		pipelineConfig->subpass = subpass;
+		if (subpass != 0) {
+			//billboards drawn after the geometry subpass still test against its depth but must not write it
+			pipelineConfig->depthStencilInfo.depthWriteEnable = VK_FALSE;
+		}
 		//Pipeline = std::make_unique<ikePipeline>(ikeDeviceEngine, "frag.spv", "vert.spv", pipelineConfig);
 
-		Pipeline = std::make_unique<ikePipeline>(ikeDeviceEngine, "Shaders/pointlight_vert.spv", "Shaders/pointlight_frag.spv", pipelineConfig);
+		Pipeline = pipelineCompiler.compile("Shaders/pointlight_vert.spv", "Shaders/pointlight_frag.spv", std::move(pipelineConfig));
 	}
 
-	void IkPointLightSystem::update(FrameInfo& frameInfo,GlobalUbo &ubo) { 
+	void IkPointLightSystem::update(FrameInfo& frameInfo) { 
 		auto rotateLight = glm::rotate(glm::mat4(1.f), frameInfo.frameTime, { 0.f, -1.f,0.f });
 
-		int lightIndex = 0;
-		for (auto& kv : frameInfo.gameObjects) {
-			auto& obj = kv.second;
-			if (obj.pointLight == nullptr) continue;
+		lights.clear();
+		//only the entities that are lights, in the order of the point light pool
+		IkEntityRegistry& entities = frameInfo.entities;
+		const std::vector<IkEntity>& lightEntities = entities.pointLights.entities();
+		const std::vector<PointLightComponent>& pointLights = entities.pointLights.components();
+		lights.reserve(lightEntities.size());
+		for (size_t i = 0; i < lightEntities.size(); i++) {
+			TransformComponent& transform = entities.transforms.get(lightEntities[i]);
 
-			assert(lightIndex < MAX_LIGHTS && "Point light exceed maximum specified");
 			// update light position
-			obj.transform.translation = glm::vec3(rotateLight * glm::vec4(obj.transform.translation, 1.f));
+			transform.translation = glm::vec3(rotateLight * glm::vec4(transform.translation, 1.f));
 
-			//copy light to ubo
-			ubo.pointLights[lightIndex].position = glm::vec4(obj.transform.translation, 1.f);
-			ubo.pointLights[lightIndex].color = glm::vec4(obj.color, obj.pointLight->lightIntensity);
+			PointLight light{};
+			light.position = glm::vec4(transform.translation, transform.scale.x);
+			light.color = glm::vec4(entities.colors.get(lightEntities[i]).color, pointLights[i].lightIntensity);
+			lights.push_back(light);
+		}
 
-			lightIndex += 1;
+		//the frame that last used this index has finished on the GPU, so its old buffer is no longer read and can be replaced
+		uint32_t lightCount = static_cast<uint32_t>(lights.size());
+		if (lightCount > lightBuffers[frameInfo.frameIndex]->getInstanceCount()) {
+			uint32_t capacity = lightBuffers[frameInfo.frameIndex]->getInstanceCount();
+			while (capacity < lightCount) capacity *= 2;
+			createLightBuffer(frameInfo.frameIndex, capacity);
 		}
-		ubo.numLights = lightIndex;
+		if (lightCount > 0) {
+			lightBuffers[frameInfo.frameIndex]->writeToBuffer(lights.data(), sizeof(PointLight) * lightCount);
+			lightBuffers[frameInfo.frameIndex]->flush();
+		}
+		lightCounts[frameInfo.frameIndex] = lightCount;
 	}
 
-	//needs explanation
+	//every billboard is one instance of the same 6 vertex quad, pointlight.vert fetches its light with gl_InstanceIndex
 	void IkPointLightSystem::render(FrameInfo &frameInfo) {
-		Pipeline->bind(frameInfo.commandBuffer);
+		uint32_t lightCount = lightCounts[frameInfo.frameIndex];
+		if (lightCount == 0) return;
+
+		uint32_t gpuScope = frameInfo.renderer.beginGpuScope("IkPointLightSystem::render");
+		//a single draw is not worth a trip through the thread pool, record it here on slot 0
+		VkCommandBuffer commandBuffer = frameInfo.renderer.beginSecondaryCommandBuffer(0);
+
+		Pipeline->bind(commandBuffer);
 
-		vkCmdBindDescriptorSets(frameInfo.commandBuffer,
+		vkCmdBindDescriptorSets(commandBuffer,
 			VK_PIPELINE_BIND_POINT_GRAPHICS,
 			pipelineLayout,
 			0,
 			1,
 			&frameInfo.globalDescriptorSet,
 			0,
-			nullptr );
-		for (auto& kv : frameInfo.gameObjects) {
-			auto& obj = kv.second;
-			if (obj.pointLight == nullptr) continue;
-
-			PointLightPushConstants push{};
-			push.position = glm::vec4(obj.transform.translation, 1.f);
-			push.color = glm::vec4(obj.color, obj.pointLight->lightIntensity);
-			push.radius = obj.transform.scale.x;
-
-			vkCmdPushConstants(
-				frameInfo.commandBuffer,
-				pipelineLayout,
-				VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-				0,
-				sizeof(PointLightPushConstants),
-				&push
-			   );
-           vkCmdDraw(frameInfo.commandBuffer, 6, 1, 0, 0);
-		}
-		
+			nullptr);
+
+		vkCmdDraw(commandBuffer, 6, lightCount, 0, 0);
+
+		frameInfo.renderer.endSecondaryCommandBuffer(commandBuffer);
+		frameInfo.renderer.executeSecondaryCommandBuffers({ commandBuffer });
+		frameInfo.renderer.endGpuScope(gpuScope);
 	}
 
 }//namespace ikE
\ No newline at end of file
@@ -1,10 +1,12 @@
 #ifndef IKPOINTLIGHTSYSTEM_HPP
 #define IKPOINTLIGHTSYSTEM_HPP
 
+#include "../ikbuffer.hpp"
 #include "../ikCamera.hpp"
 #include "../ikDeviceEngine.hpp"
-#include "../ikgameObject.hpp"
+#include "../ikEntityRegistry.hpp"
 #include "../ikPipeline.hpp"
+#include "../ikPipelineCompiler.hpp"
 #include "../ikframeInfo.hpp"
 
 //std
@@ -16,30 +18,43 @@ namespace ikE {
 		
 
 		//because we have the constructors here we should also remember to delete the copy constructors 
-		IkPointLightSystem(IkeDeviceEngine &device, VkRenderPass renderPass,VkDescriptorSetLayout globalSetLayout);
+		//a subpass other than 0 is the deferred lighting pass, there depth is read only
+		IkPointLightSystem(IkeDeviceEngine &device, IkPipelineCompiler &pipelineCompiler, VkRenderPass renderPass,VkDescriptorSetLayout globalSetLayout, uint32_t subpass = 0);
 		~IkPointLightSystem();
 
 		IkPointLightSystem(const IkPointLightSystem&) = delete;
 		IkPointLightSystem& operator =(const IkPointLightSystem&) = delete;
 
-		void update(FrameInfo& frameInfo, GlobalUbo& ubo);
+		void update(FrameInfo& frameInfo);
         void render(FrameInfo &frameInfo);
 
+		//this frame's light storage buffer, bound at set 0 binding 1
+		//update() may replace the buffer when the light count outgrows it, so the descriptor has to be refreshed after it
+		VkDescriptorBufferInfo getLightBufferInfo(int frameIndex) { return lightBuffers[frameIndex]->descriptorInfo(); }
+		//the lights written by the last update(), in storage buffer order
+		const std::vector<PointLight>& getLights() const { return lights; }
+
 	private:
 		
 	
 		void createPipelinelayout(VkDescriptorSetLayout globalSetLayout);
-		void createPipeline(VkRenderPass renderPass);
+		void createPipeline(IkPipelineCompiler& pipelineCompiler, VkRenderPass renderPass, uint32_t subpass);
+		void createLightBuffer(int frameIndex, uint32_t capacity);
 		
 
 
 
 		IkeDeviceEngine &ikeDeviceEngine;
 		
+		static constexpr uint32_t INITIAL_LIGHT_CAPACITY = 64;
 
+		//one host visible buffer per frame in flight, so update() never writes lights the gpu is still reading
+		std::vector<std::unique_ptr<IkBuffer>> lightBuffers;
+		std::vector<uint32_t> lightCounts;
+		std::vector<PointLight> lights;
 
 
-		std::unique_ptr<ikePipeline> Pipeline;
+		IkPipelineHandle Pipeline;
 		VkPipelineLayout pipelineLayout;
 		
 	};
@@ -8,6 +8,7 @@
 
 
 //std
+#include <algorithm>
 #include <stdexcept>
 #include <cassert>
 #include <array>
@@ -19,12 +20,55 @@ namespace ikE {
 	};
 
 	//FirstApp::FirstApp() {loadGameObjects(),ikeDeviceEngine.createCommandPool(), createPipelinelayout(); }
-	IkRenderSystem::IkRenderSystem(IkeDeviceEngine& device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout) : ikeDeviceEngine(device){
+	IkRenderSystem::IkRenderSystem(IkeDeviceEngine& device, IkPipelineCompiler& pipelineCompiler, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout, IkBindlessTable& bindlessTable, bool depthPrepass, bool deferred)
+		: ikeDeviceEngine(device), bindlessTable(bindlessTable), depthPrepassEnabled(depthPrepass), deferredEnabled(deferred) {
 		 createPipelinelayout(globalSetLayout),
-		 createPipeline(renderPass);
+		 createPipeline(pipelineCompiler, renderPass);
+		 createStaticCommandBuffers();
 	}
 
-	IkRenderSystem::~IkRenderSystem() { vkDestroyPipelineLayout(ikeDeviceEngine.device(), pipelineLayout, nullptr); }
+	IkRenderSystem::~IkRenderSystem() {
+		//a build that was never used may still be reading the layout
+		for (auto& pipeline : lightingPipelines) {
+			pipeline.wait();
+		}
+		depthPrepassPipeline.wait();
+		//destroying the pool also frees the cached command buffers
+		vkDestroyCommandPool(ikeDeviceEngine.device(), staticCommandPool, nullptr);
+		vkDestroyPipelineLayout(ikeDeviceEngine.device(), pipelineLayout, nullptr);
+	}
+
+	void IkRenderSystem::createStaticCommandBuffers() {
+		QueueFamilyIndices queueFamilyIndices = ikeDeviceEngine.findPhysicalQueueFamilies();
+
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+		if (vkCreateCommandPool(ikeDeviceEngine.device(), &poolInfo, nullptr, &staticCommandPool) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create static command pool!");
+		}
+
+		//one main and one pre-pass buffer per frame in flight
+		std::vector<VkCommandBuffer> commandBuffers(2 * ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT);
+
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+		allocInfo.commandPool = staticCommandPool;
+		allocInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
+
+		if (vkAllocateCommandBuffers(ikeDeviceEngine.device(), &allocInfo, commandBuffers.data()) != VK_SUCCESS) {
+			throw std::runtime_error("failed to allocate static command buffers!");
+		}
+
+		staticDrawCaches.resize(ikEngineSwapChain::MAX_FRAMES_IN_FLIGHT);
+		for (size_t i = 0; i < staticDrawCaches.size(); i++) {
+			staticDrawCaches[i].commandBuffer = commandBuffers[2 * i];
+			staticDrawCaches[i].prepassCommandBuffer = commandBuffers[2 * i + 1];
+		}
+	}
 
 
 
@@ -39,7 +83,8 @@ namespace ikE {
 		pushConstantRange.offset = 0;
 		pushConstantRange.size = sizeof(SimplePushConstantData);
 
-		std::vector<VkDescriptorSetLayout> descriptorSetLayouts{ globalSetLayout };
+		std::vector<VkDescriptorSetLayout> descriptorSetLayouts{ globalSetLayout, bindlessTable.getDescriptorSetLayout() };
+		static_assert(IkBindlessTable::BINDLESS_SET == 1, "the bindless table follows the global set");
 
 		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
 		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -57,50 +102,186 @@ namespace ikE {
 	   we able to do this because in firstApp.hpp we have them as an include file
 
 	*/
-	void IkRenderSystem::createPipeline(VkRenderPass renderPass) {
+	void IkRenderSystem::createPipeline(IkPipelineCompiler& pipelineCompiler, VkRenderPass renderPass) {
 
 		assert(pipelineLayout != nullptr && "Cannot create pipeline before pipeline layout");
 
 
-		PipelineConfigInfo pipelineConfig{};
-		ikePipeline::defaultPipelineConfigInfo(pipelineConfig);
-		pipelineConfig.renderPass = renderPass;
-		pipelineConfig.pipelineLayout = pipelineLayout;
-		//Pipeline = std::make_unique<ikePipeline>(ikeDeviceEngine, "frag.spv", "vert.spv", pipelineConfig);
+		//the deferred geometry subpass has two color attachments, albedo and normal
+		uint32_t colorAttachmentCount = deferredEnabled ? 2 : 1;
+
+		if (depthPrepassEnabled) {
+			auto prepassConfig = std::make_unique<PipelineConfigInfo>();
+			ikePipeline::depthPrepassPipelineConfigInfo(*prepassConfig);
+			prepassConfig->renderPass = renderPass;
+			prepassConfig->pipelineLayout = pipelineLayout;
+			prepassConfig->colorAttachmentCount = colorAttachmentCount;
+			depthPrepassPipeline = pipelineCompiler.compile("Shaders/depth_vert.spv", "", std::move(prepassConfig));
+		}
+
+		//gbuffer.frag does no lighting, so all of its variants are the same pipeline and the compiler dedupes them
+		const char* fragFilepath = deferredEnabled ? "Shaders/gbuffer_frag.spv" : "Shaders/frag.spv";
+		for (size_t i = 0; i < lightingPipelines.size(); i++) {
+			auto pipelineConfig = std::make_unique<PipelineConfigInfo>();
+			ikePipeline::defaultPipelineConfigInfo(*pipelineConfig);
+			pipelineConfig->renderPass = renderPass;
+			pipelineConfig->pipelineLayout = pipelineLayout;
+			pipelineConfig->colorAttachmentCount = colorAttachmentCount;
+			if (depthPrepassEnabled) {
+				//depth is already final after the pre-pass, only the front most fragment passes and nothing is written
+				pipelineConfig->depthStencilInfo.depthCompareOp = VK_COMPARE_OP_EQUAL;
+				pipelineConfig->depthStencilInfo.depthWriteEnable = VK_FALSE;
+			}
+			if (!deferredEnabled) {
+				pipelineConfig->specialization.set(0, IkLightClusterSystem::LIGHT_LOOP_LIMITS[i]);
+			}
+			lightingPipelines[i] = pipelineCompiler.compile("Shaders/vert.spv", fragFilepath, std::move(pipelineConfig));
+		}
+	}
 
-		Pipeline = std::make_unique<ikePipeline>(ikeDeviceEngine, "Shaders/vert.spv", "Shaders/frag.spv", pipelineConfig);
+	ikePipeline& IkRenderSystem::selectPipeline(const FrameInfo& frameInfo) const {
+		const auto& limits = IkLightClusterSystem::LIGHT_LOOP_LIMITS;
+		size_t variant = std::find(limits.begin(), limits.end(), frameInfo.lightLoopLimit) - limits.begin();
+		assert(variant < lightingPipelines.size() && "Light loop limit has no pipeline variant");
+		return lightingPipelines[variant].get();
 	}
 
 	//needs explanation
 	void IkRenderSystem::renderGameObjects(FrameInfo &frameInfo) {
-		Pipeline->bind(frameInfo.commandBuffer);
+		const IkEntityRegistry& entities = frameInfo.entities;
+		ikePipeline& pipeline = selectPipeline(frameInfo);
 
-		vkCmdBindDescriptorSets(frameInfo.commandBuffer,
+		//the frame that last used this index has finished on the GPU, so its cached buffers are idle and can be re-recorded
+		auto& cache = staticDrawCaches[frameInfo.frameIndex];
+		bool recordStatic = !isStaticCacheValid(cache, frameInfo, pipeline);
+
+		//only the model pool is walked, split into dynamic draws and, when they are re-recorded, static draws by index into it
+		const std::vector<ModelComponent>& models = entities.getModels().components();
+		std::vector<uint32_t> staticDrawList;
+		std::vector<uint32_t> drawList;
+		drawList.reserve(models.size());
+		for (uint32_t i = 0; i < static_cast<uint32_t>(models.size()); i++) {
+			if (models[i].model == nullptr) continue;
+			if (!models[i].isStatic) {
+				drawList.push_back(i);
+			}
+			else if (recordStatic) {
+				staticDrawList.push_back(i);
+			}
+		}
+
+		//covers the pre-pass too, both draw the same objects
+		uint32_t gpuScope = frameInfo.renderer.beginGpuScope("IkRenderSystem::renderGameObjects");
+
+		uint32_t staticCount = static_cast<uint32_t>(staticDrawList.size());
+		if (recordStatic) {
+			if (vkResetCommandBuffer(cache.commandBuffer, 0) != VK_SUCCESS) {
+				throw std::runtime_error("failed to reset static command buffer!");
+			}
+			frameInfo.renderer.beginCachedSecondaryCommandBuffer(cache.commandBuffer);
+			recordDraws(cache.commandBuffer, pipeline, false, frameInfo.globalDescriptorSet, entities, staticDrawList, 0, staticCount);
+			frameInfo.renderer.endSecondaryCommandBuffer(cache.commandBuffer);
+
+			if (depthPrepassEnabled) {
+				if (vkResetCommandBuffer(cache.prepassCommandBuffer, 0) != VK_SUCCESS) {
+					throw std::runtime_error("failed to reset static command buffer!");
+				}
+				frameInfo.renderer.beginCachedSecondaryCommandBuffer(cache.prepassCommandBuffer);
+				recordDraws(cache.prepassCommandBuffer, *depthPrepassPipeline, true, frameInfo.globalDescriptorSet, entities, staticDrawList, 0, staticCount);
+				frameInfo.renderer.endSecondaryCommandBuffer(cache.prepassCommandBuffer);
+			}
+
+			cache.staticGeneration = entities.getStaticGeneration();
+			cache.drawCount = staticCount;
+			cache.globalDescriptorSet = frameInfo.globalDescriptorSet;
+			cache.pipeline = &pipeline;
+			cache.swapChainGeneration = frameInfo.renderer.getSwapChainGeneration();
+			cache.isRecorded = true;
+		}
+		bool hasStaticDraws = cache.drawCount > 0;
+
+		//every object has to be in the depth buffer before the first EQUAL tested draw, otherwise fragments
+		//that are covered later would still be shaded
+		if (depthPrepassEnabled) {
+			if (hasStaticDraws) {
+				frameInfo.renderer.executeSecondaryCommandBuffers({ cache.prepassCommandBuffer });
+			}
+			frameInfo.renderer.recordSecondaryCommandBuffers(
+				frameInfo.threadPool,
+				static_cast<uint32_t>(drawList.size()),
+				MIN_DRAWS_PER_THREAD,
+				[&](VkCommandBuffer commandBuffer, uint32_t first, uint32_t last) {
+					recordDraws(commandBuffer, *depthPrepassPipeline, true, frameInfo.globalDescriptorSet, entities, drawList, first, last);
+				});
+		}
+
+		if (hasStaticDraws) {
+			frameInfo.renderer.executeSecondaryCommandBuffers({ cache.commandBuffer });
+		}
+		frameInfo.renderer.recordSecondaryCommandBuffers(
+			frameInfo.threadPool,
+			static_cast<uint32_t>(drawList.size()),
+			MIN_DRAWS_PER_THREAD,
+			[&](VkCommandBuffer commandBuffer, uint32_t first, uint32_t last) {
+				recordDraws(commandBuffer, pipeline, false, frameInfo.globalDescriptorSet, entities, drawList, first, last);
+			});
+		frameInfo.renderer.endGpuScope(gpuScope);
+	}
+
+	bool IkRenderSystem::isStaticCacheValid(const StaticDrawCache& cache, const FrameInfo& frameInfo, const ikePipeline& pipeline) const {
+		return cache.isRecorded
+			&& cache.staticGeneration == frameInfo.entities.getStaticGeneration()
+			&& cache.swapChainGeneration == frameInfo.renderer.getSwapChainGeneration()
+			&& cache.globalDescriptorSet == frameInfo.globalDescriptorSet
+			&& cache.pipeline == &pipeline;
+	}
+
+	void IkRenderSystem::recordDraws(
+		VkCommandBuffer commandBuffer,
+		ikePipeline& pipeline,
+		bool positionsOnly,
+		VkDescriptorSet globalDescriptorSet,
+		const IkEntityRegistry& entities,
+		const std::vector<uint32_t>& drawList,
+		uint32_t first,
+		uint32_t last) {
+		//nothing is inherited by a secondary command buffer, every buffer binds its own pipeline and sets
+		pipeline.bind(commandBuffer);
+
+		vkCmdBindDescriptorSets(commandBuffer,
 			VK_PIPELINE_BIND_POINT_GRAPHICS,
 			pipelineLayout,
 			0,
 			1,
-			&frameInfo.globalDescriptorSet,
+			&globalDescriptorSet,
 			0,
-			nullptr );
-
+			nullptr);
+		//one set for every material of every draw below
+		bindlessTable.bind(commandBuffer, pipelineLayout);
 
-		for (auto& kv : frameInfo.gameObjects) {
-			auto& obj = kv.second;
-			if (obj.model == nullptr) continue;
+		const std::vector<IkEntity>& modelEntities = entities.getModels().entities();
+		const std::vector<ModelComponent>& models = entities.getModels().components();
+		for (uint32_t i = first; i < last; i++) {
+			const ModelComponent& obj = models[drawList[i]];
+			const TransformComponent& transform = entities.transforms.get(modelEntities[drawList[i]]);
 			SimplePushConstantData push{};
-			push.modelMatrix = obj.transform.mat4();
-			push.normalMatrix = obj.transform.normalMatrix();
+			push.modelMatrix = transform.mat4();
+			push.normalMatrix = transform.normalMatrix();
 
-			vkCmdPushConstants(frameInfo.commandBuffer,
+			vkCmdPushConstants(commandBuffer,
 				pipelineLayout,
 				VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
 				0,
 				sizeof(SimplePushConstantData),
 				&push
 			);
-			obj.model->bind(frameInfo.commandBuffer);
-			obj.model->draw(frameInfo.commandBuffer);
+			if (positionsOnly) {
+				obj.model->bindPositions(commandBuffer);
+			}
+			else {
+				obj.model->bind(commandBuffer);
+			}
+			obj.model->draw(commandBuffer, obj.materialId);
 		}
 	}
 
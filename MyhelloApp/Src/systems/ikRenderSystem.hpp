@@ -3,11 +3,14 @@
 
 #include "../ikCamera.hpp"
 #include "../ikDeviceEngine.hpp"
-#include "../ikgameObject.hpp"
+#include "../ikEntityRegistry.hpp"
 #include "../ikPipeline.hpp"
+#include "../ikPipelineCompiler.hpp"
 #include "../ikframeInfo.hpp"
+#include "ikLightClusterSystem.hpp"
 
 //std
+#include <array>
 #include <memory>
 #include <vector>
 namespace ikE {
@@ -16,7 +19,11 @@ namespace ikE {
 		
 
 		//because we have the constructors here we should also remember to delete the copy constructors 
-		IkRenderSystem(IkeDeviceEngine &device, VkRenderPass renderPass,VkDescriptorSetLayout globalSetLayout);
+		//with depthPrepass the opaque geometry is first drawn depth only, and the shaded pass then tests with EQUAL
+		//with deferred the objects are not lit here but written to the G-buffer of the deferred geometry subpass
+		//the pipelines are compiled in the background and first waited on by renderGameObjects
+		//objects find their material in the bindless table, bound as set IkBindlessTable::BINDLESS_SET
+		IkRenderSystem(IkeDeviceEngine &device, IkPipelineCompiler &pipelineCompiler, VkRenderPass renderPass,VkDescriptorSetLayout globalSetLayout, IkBindlessTable& bindlessTable, bool depthPrepass = false, bool deferred = false);
 		~IkRenderSystem();
 
 		IkRenderSystem(const IkRenderSystem&) = delete;
@@ -28,18 +35,55 @@ namespace ikE {
 		
 	
 		void createPipelinelayout(VkDescriptorSetLayout globalSetLayout);
-		void createPipeline(VkRenderPass renderPass);
+		void createPipeline(IkPipelineCompiler& pipelineCompiler, VkRenderPass renderPass);
+		void createStaticCommandBuffers();
+
+		void recordDraws(
+			VkCommandBuffer commandBuffer,
+			ikePipeline& pipeline,
+			bool positionsOnly,
+			VkDescriptorSet globalDescriptorSet,
+			const IkEntityRegistry& entities,
+			const std::vector<uint32_t>& drawList, //indices into the model pool of entities
+			uint32_t first,
+			uint32_t last);
+
+		/*static objects of one frame in flight, recorded into a single secondary that is replayed until the static
+		  generation of the registry (the set of static objects or one of their models) or the swap chain render pass changes*/
+		struct StaticDrawCache {
+			VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+			VkCommandBuffer prepassCommandBuffer = VK_NULL_HANDLE;
+			uint64_t staticGeneration = 0;
+			uint32_t drawCount = 0;
+			VkDescriptorSet globalDescriptorSet = VK_NULL_HANDLE;
+			const ikePipeline* pipeline = nullptr;
+			uint32_t swapChainGeneration = 0;
+			bool isRecorded = false;
+		};
+		bool isStaticCacheValid(const StaticDrawCache& cache, const FrameInfo& frameInfo, const ikePipeline& pipeline) const;
+		//the lit variant for frameInfo.lightLoopLimit, the G-buffer pipeline has only one
+		ikePipeline& selectPipeline(const FrameInfo& frameInfo) const;
 		
 
 
 
 		IkeDeviceEngine &ikeDeviceEngine;
+		IkBindlessTable &bindlessTable;
 		
+		//below this many draws per worker the cost of an extra secondary buffer outweighs the parallelism
+		static constexpr uint32_t MIN_DRAWS_PER_THREAD = 64;
 
 
-
-		std::unique_ptr<ikePipeline> Pipeline;
+		//one pipeline per IkLightClusterSystem::LIGHT_LOOP_LIMITS entry, in the same order
+		std::array<IkPipelineHandle, IkLightClusterSystem::LIGHT_LOOP_LIMITS.size()> lightingPipelines;
+		IkPipelineHandle depthPrepassPipeline;
 		VkPipelineLayout pipelineLayout;
+		bool depthPrepassEnabled;
+		bool deferredEnabled;
+
+		//long lived pool, the cached buffers are reset one by one when they need re-recording
+		VkCommandPool staticCommandPool;
+		std::vector<StaticDrawCache> staticDrawCaches;
 		
 	};
 
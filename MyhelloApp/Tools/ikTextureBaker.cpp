@@ -0,0 +1,140 @@
+//offline encoder for .iktx texture containers, see ikTextureContainer.hpp
+//usage: ikTextureBaker <input.tga> <output.iktx> [--format bc1|bc3|bc5|bc7|rgba8] [--linear] [--no-fallback]
+#include "../Src/ikBlockCompression.hpp"
+#include "../Src/ikImageReader.hpp"
+#include "../Src/ikTextureContainer.hpp"
+
+//std
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    float srgbToLinear(uint8_t value) {
+        float c = value / 255.f;
+        return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    uint8_t linearToSrgb(float value) {
+        float c = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+        return static_cast<uint8_t>(std::clamp(std::lround(c * 255.f), 0L, 255L));
+    }
+
+    //halves the image with a 2x2 box filter, a side of 1 stays 1. color is averaged in linear space for sRGB
+    //textures, alpha and linear textures as they are
+    ikE::DecodedImage downsample(const ikE::DecodedImage& image, bool srgb) {
+        static const std::array<float, 256> toLinear = [] {
+            std::array<float, 256> table{};
+            for (int i = 0; i < 256; i++) table[i] = srgbToLinear(static_cast<uint8_t>(i));
+            return table;
+        }();
+
+        ikE::DecodedImage half{};
+        half.width = std::max(image.width / 2, 1u);
+        half.height = std::max(image.height / 2, 1u);
+        half.rgba.resize(static_cast<size_t>(half.width) * half.height * 4);
+        for (uint32_t y = 0; y < half.height; y++) {
+            for (uint32_t x = 0; x < half.width; x++) {
+                float sum[4]{};
+                for (uint32_t dy = 0; dy < 2; dy++) {
+                    for (uint32_t dx = 0; dx < 2; dx++) {
+                        uint32_t sx = std::min(x * 2 + dx, image.width - 1);
+                        uint32_t sy = std::min(y * 2 + dy, image.height - 1);
+                        const uint8_t* pixel = &image.rgba[(static_cast<size_t>(sy) * image.width + sx) * 4];
+                        for (int c = 0; c < 4; c++) {
+                            sum[c] += srgb && c < 3 ? toLinear[pixel[c]] : pixel[c];
+                        }
+                    }
+                }
+                uint8_t* out = &half.rgba[(static_cast<size_t>(y) * half.width + x) * 4];
+                for (int c = 0; c < 4; c++) {
+                    out[c] = srgb && c < 3
+                        ? linearToSrgb(sum[c] / 4.f)
+                        : static_cast<uint8_t>(std::lround(sum[c] / 4.f));
+                }
+            }
+        }
+        return half;
+    }
+
+    ikE::TextureChain encodeChain(ikE::BlockFormat format, const std::vector<ikE::DecodedImage>& mips) {
+        ikE::TextureChain chain{};
+        chain.format = format;
+        for (const auto& mip : mips) {
+            chain.mips.push_back(ikE::encodeBlocks(format, mip.width, mip.height, mip.rgba.data()));
+        }
+        return chain;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: ikTextureBaker <input.tga> <output.iktx> [--format bc1|bc3|bc5|bc7|rgba8] [--linear] [--no-fallback]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::string inputPath = argv[1];
+    std::string outputPath = argv[2];
+    ikE::BlockFormat format = ikE::BlockFormat::BC7;
+    //color textures are sRGB, --linear is for data such as normal or roughness maps
+    bool srgb = true;
+    //an ETC2/EAC chain next to the BC one, for devices without BC support
+    bool fallback = true;
+    for (int i = 3; i < argc; i++) {
+        if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            if (!ikE::parseBlockFormat(argv[++i], format) ||
+                (format != ikE::BlockFormat::RGBA8 && ikE::etc2Counterpart(format) == format)) {
+                std::cerr << "unknown format " << argv[i] << ", expected bc1, bc3, bc5, bc7 or rgba8" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (std::strcmp(argv[i], "--linear") == 0) {
+            srgb = false;
+        }
+        else if (std::strcmp(argv[i], "--no-fallback") == 0) {
+            fallback = false;
+        }
+    }
+    //the two channel formats have no sRGB variant
+    if (ikE::isTwoChannel(format)) {
+        srgb = false;
+    }
+
+    try {
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<ikE::DecodedImage> mips{ ikE::readImage(inputPath) };
+        while (mips.back().width > 1 || mips.back().height > 1) {
+            mips.push_back(downsample(mips.back(), srgb));
+        }
+
+        std::vector<ikE::TextureChain> chains{ encodeChain(format, mips) };
+        if (fallback && ikE::etc2Counterpart(format) != format) {
+            chains.push_back(encodeChain(ikE::etc2Counterpart(format), mips));
+        }
+        ikE::writeTextureContainer(outputPath, mips[0].width, mips[0].height, srgb, chains);
+
+        size_t uncompressedSize = 0;
+        for (const auto& mip : mips) uncompressedSize += mip.rgba.size();
+        std::cout << "baked " << inputPath << " (" << mips[0].width << "x" << mips[0].height << ", " << mips.size()
+            << " mips, " << (srgb ? "sRGB" : "linear") << ") into " << outputPath << " in "
+            << std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() << " ms" << std::endl;
+        for (const auto& chain : chains) {
+            size_t chainSize = 0;
+            for (const auto& mip : chain.mips) chainSize += mip.size();
+            std::cout << "  " << ikE::blockFormatName(chain.format) << ": " << chainSize / 1024 << " KB, "
+                << static_cast<double>(uncompressedSize) / chainSize << "x smaller than RGBA8" << std::endl;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}